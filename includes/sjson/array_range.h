@@ -0,0 +1,281 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+// The MIT License (MIT)
+//
+// Copyright (c) 2018 Nicholas Frechette, Cody Jones, and sjson-cpp contributors
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "sjson/error.h"
+#include "sjson/parser.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+
+namespace sjson
+{
+	namespace impl
+	{
+		// An input iterator over a range, the range holds the current element and advancing it consumes the input
+		template<class RangeType, typename ValueType>
+		class RangeIterator
+		{
+		public:
+			typedef std::input_iterator_tag iterator_category;
+			typedef typename std::remove_reference<ValueType>::type value_type;
+			typedef std::ptrdiff_t difference_type;
+			typedef value_type* pointer;
+			typedef ValueType reference;
+
+			RangeIterator() : m_range(nullptr) {}
+			explicit RangeIterator(RangeType* range) : m_range(range) {}
+
+			ValueType operator*() const { return m_range->get_value(); }
+			pointer operator->() const { return &m_range->get_value(); }
+
+			RangeIterator& operator++()
+			{
+				m_range->advance();
+				return *this;
+			}
+
+			void operator++(int) { m_range->advance(); }
+
+			// All iterators that reached the end of their range are equal
+			bool operator==(const RangeIterator& other) const { return is_end() == other.is_end(); }
+			bool operator!=(const RangeIterator& other) const { return is_end() != other.is_end(); }
+
+		private:
+			bool is_end() const { return m_range == nullptr || m_range->is_done(); }
+
+			RangeType* m_range;
+		};
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+	// Lazily reads the elements of an array one at a time, only the current element is held in memory.
+	// Any type supported by Parser::read(value) can be used as the element type.
+	//
+	// double sum = 0.0;
+	// for (double value : read_array_range<double>(parser, "values"))
+	//     sum += value;
+	//
+	// if (!parser.is_valid()) ...
+	//
+	// Iteration stops at the end of the array or at the first error, check the parser once done.
+	// The range can only be iterated once since iterating it consumes the input.
+	//////////////////////////////////////////////////////////////////////////
+	template<typename ElementType, class DialectType>
+	class BasicArrayRange
+	{
+	public:
+		typedef impl::RangeIterator<BasicArrayRange, const ElementType&> Iterator;
+
+		// Begins reading the array 'key = [ ... ]'
+		BasicArrayRange(BasicParser<DialectType>& parser, const char* key)
+			: m_parser(&parser)
+			, m_value()
+			, m_num_elements(0)
+			, m_has_begun(false)
+			, m_is_done(!parser.array_begins(key))
+		{}
+
+		// Begins reading an array nested within another array or the value of a key already read
+		explicit BasicArrayRange(BasicParser<DialectType>& parser)
+			: m_parser(&parser)
+			, m_value()
+			, m_num_elements(0)
+			, m_has_begun(false)
+			, m_is_done(!parser.array_begins())
+		{}
+
+		Iterator begin()
+		{
+			SJSON_CPP_ASSERT(!m_has_begun, "An array range can only be iterated once");
+			m_has_begun = true;
+			advance();
+			return Iterator(this);
+		}
+
+		Iterator end() { return Iterator(); }
+
+		// Returns how many elements have been read so far
+		uint32_t get_num_elements() const { return m_num_elements; }
+
+	private:
+		friend Iterator;
+
+		const ElementType& get_value() const { return m_value; }
+		bool is_done() const { return m_is_done; }
+
+		void advance()
+		{
+			if (m_is_done)
+				return;
+
+			if (m_parser->try_array_ends() || (m_num_elements != 0 && !m_parser->read_array_separator()) || !m_parser->read(m_value))
+			{
+				m_is_done = true;
+				return;
+			}
+
+			m_num_elements++;
+		}
+
+		BasicParser<DialectType>* m_parser;
+		ElementType m_value;
+		uint32_t m_num_elements;
+		bool m_has_begun;
+		bool m_is_done;
+	};
+
+	//////////////////////////////////////////////////////////////////////////
+	// Lazily visits the objects of an array one at a time. Each iteration yields the parser
+	// positioned within the object, its members are then read as usual.
+	//
+	// for (Parser& entry : read_object_range(parser, "entries"))
+	// {
+	//     entry.try_read("name", name, "");
+	//     entry.try_read("weight", weight, 0.0);
+	// }
+	//
+	// The iterator closes every object, members that were not read are skipped.
+	// Iteration stops at the end of the array or at the first error, check the parser once done.
+	//////////////////////////////////////////////////////////////////////////
+	template<class DialectType>
+	class BasicObjectRange
+	{
+	public:
+		typedef impl::RangeIterator<BasicObjectRange, BasicParser<DialectType>&> Iterator;
+
+		// Begins reading the array 'key = [ { ... }, ... ]'
+		BasicObjectRange(BasicParser<DialectType>& parser, const char* key)
+			: m_parser(&parser)
+			, m_num_objects(0)
+			, m_has_begun(false)
+			, m_is_done(!parser.array_begins(key))
+		{}
+
+		// Begins reading an array nested within another array or the value of a key already read
+		explicit BasicObjectRange(BasicParser<DialectType>& parser)
+			: m_parser(&parser)
+			, m_num_objects(0)
+			, m_has_begun(false)
+			, m_is_done(!parser.array_begins())
+		{}
+
+		Iterator begin()
+		{
+			SJSON_CPP_ASSERT(!m_has_begun, "An object range can only be iterated once");
+			m_has_begun = true;
+			advance();
+			return Iterator(this);
+		}
+
+		Iterator end() { return Iterator(); }
+
+		// Returns how many objects have been visited so far
+		uint32_t get_num_objects() const { return m_num_objects; }
+
+	private:
+		friend Iterator;
+
+		BasicParser<DialectType>& get_value() const { return *m_parser; }
+		bool is_done() const { return m_is_done; }
+
+		void advance()
+		{
+			if (m_is_done)
+				return;
+
+			if (m_num_objects != 0 && !end_object())
+			{
+				m_is_done = true;
+				return;
+			}
+
+			if (m_parser->try_array_ends() || (m_num_objects != 0 && !m_parser->read_array_separator()) || !m_parser->object_begins())
+			{
+				m_is_done = true;
+				return;
+			}
+
+			m_num_objects++;
+		}
+
+		// Skips the members of the current object that were not read along with its closing brace
+		bool end_object()
+		{
+			if (!m_parser->is_valid())
+				return false;
+
+			while (!m_parser->try_object_ends())
+			{
+				StringView key;
+				if (!m_parser->read_next_key(key) || !m_parser->skip_value())
+					return false;
+			}
+
+			return true;
+		}
+
+		BasicParser<DialectType>* m_parser;
+		uint32_t m_num_objects;
+		bool m_has_begun;
+		bool m_is_done;
+	};
+
+	template<typename ElementType>
+	using ArrayRange = BasicArrayRange<ElementType, SJSONDialect>;
+
+	template<typename ElementType>
+	using JSONArrayRange = BasicArrayRange<ElementType, JSONDialect>;
+
+	typedef BasicObjectRange<SJSONDialect> ObjectRange;
+	typedef BasicObjectRange<JSONDialect> JSONObjectRange;
+
+	// Helpers that deduce the dialect from the parser
+	template<typename ElementType, class DialectType>
+	inline BasicArrayRange<ElementType, DialectType> read_array_range(BasicParser<DialectType>& parser, const char* key)
+	{
+		return BasicArrayRange<ElementType, DialectType>(parser, key);
+	}
+
+	template<typename ElementType, class DialectType>
+	inline BasicArrayRange<ElementType, DialectType> read_array_range(BasicParser<DialectType>& parser)
+	{
+		return BasicArrayRange<ElementType, DialectType>(parser);
+	}
+
+	template<class DialectType>
+	inline BasicObjectRange<DialectType> read_object_range(BasicParser<DialectType>& parser, const char* key)
+	{
+		return BasicObjectRange<DialectType>(parser, key);
+	}
+
+	template<class DialectType>
+	inline BasicObjectRange<DialectType> read_object_range(BasicParser<DialectType>& parser)
+	{
+		return BasicObjectRange<DialectType>(parser);
+	}
+}
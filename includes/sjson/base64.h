@@ -0,0 +1,187 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+// The MIT License (MIT)
+//
+// Copyright (c) 2018 Nicholas Frechette, Cody Jones, and sjson-cpp contributors
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <cstdint>
+
+namespace sjson
+{
+	//////////////////////////////////////////////////////////////////////////
+	// Binary values are written as base64 strings (RFC 4648, standard alphabet with padding).
+	// These are the scalar routines, see kernels.h for the vector variants.
+	//////////////////////////////////////////////////////////////////////////
+
+	// Returns the length of the base64 string that holds 'size' bytes
+	constexpr size_t get_base64_encoded_length(size_t size) { return ((size + 2) / 3) * 4; }
+
+	// Returns how many bytes a base64 string of the given length can hold at most, padding included
+	constexpr size_t get_base64_max_decoded_size(size_t length) { return (length / 4) * 3 + ((length % 4) * 3) / 4; }
+
+	namespace impl
+	{
+		constexpr char k_base64_alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+		// Maps every symbol to its 6 bit value, symbols outside of the alphabet have their high bit set
+		inline const uint8_t* get_base64_decoding_table()
+		{
+			static constexpr uint8_t k_decoding_table[256] =
+			{
+				0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+				0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+				0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x3E, 0xFF, 0xFF, 0xFF, 0x3F,
+				0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3A, 0x3B, 0x3C, 0x3D, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+				0xFF, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E,
+				0x0F, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+				0xFF, 0x1A, 0x1B, 0x1C, 0x1D, 0x1E, 0x1F, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28,
+				0x29, 0x2A, 0x2B, 0x2C, 0x2D, 0x2E, 0x2F, 0x30, 0x31, 0x32, 0x33, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+				0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+				0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+				0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+				0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+				0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+				0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+				0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+				0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+			};
+
+			return k_decoding_table;
+		}
+
+		// Encodes 'size' bytes into get_base64_encoded_length(size) symbols and returns how many were written
+		inline size_t encode_base64_scalar(const uint8_t* input, size_t size, char* output)
+		{
+			char* cursor = output;
+			size_t offset = 0;
+
+			// Full groups, every symbol is a lookup of six bits in the alphabet
+			for (; offset + 3 <= size; offset += 3)
+			{
+				const uint32_t group = (uint32_t(input[offset]) << 16) | (uint32_t(input[offset + 1]) << 8) | uint32_t(input[offset + 2]);
+				cursor[0] = k_base64_alphabet[(group >> 18) & 0x3F];
+				cursor[1] = k_base64_alphabet[(group >> 12) & 0x3F];
+				cursor[2] = k_base64_alphabet[(group >> 6) & 0x3F];
+				cursor[3] = k_base64_alphabet[group & 0x3F];
+				cursor += 4;
+			}
+
+			// The last group is padded
+			const size_t num_remaining = size - offset;
+			if (num_remaining != 0)
+			{
+				const uint32_t group = (uint32_t(input[offset]) << 16) | (num_remaining == 2 ? (uint32_t(input[offset + 1]) << 8) : 0);
+				cursor[0] = k_base64_alphabet[(group >> 18) & 0x3F];
+				cursor[1] = k_base64_alphabet[(group >> 12) & 0x3F];
+				cursor[2] = num_remaining == 2 ? k_base64_alphabet[(group >> 6) & 0x3F] : '=';
+				cursor[3] = '=';
+				cursor += 4;
+			}
+
+			return size_t(cursor - output);
+		}
+
+		enum class Base64Result
+		{
+			Success,
+			InvalidSymbol,
+			BufferTooSmall,
+		};
+
+		// Decodes base64 symbols up to the first one that isn't part of the alphabet, padding included.
+		// The number of symbols consumed and bytes written are returned, what follows is left to the caller.
+		inline Base64Result decode_base64_scalar(const char* input, size_t input_length, uint8_t* output, size_t output_size, size_t& out_num_symbols, size_t& out_size)
+		{
+			const uint8_t* decoding_table = get_base64_decoding_table();
+			size_t offset = 0;
+			size_t size = 0;
+
+			out_num_symbols = 0;
+			out_size = 0;
+
+			// Full groups, a single test catches any symbol outside of the alphabet
+			while (offset + 4 <= input_length)
+			{
+				const uint32_t value0 = decoding_table[uint8_t(input[offset])];
+				const uint32_t value1 = decoding_table[uint8_t(input[offset + 1])];
+				const uint32_t value2 = decoding_table[uint8_t(input[offset + 2])];
+				const uint32_t value3 = decoding_table[uint8_t(input[offset + 3])];
+				if (((value0 | value1 | value2 | value3) & 0x80) != 0)
+					break;
+
+				if (size + 3 > output_size)
+					return Base64Result::BufferTooSmall;
+
+				const uint32_t group = (value0 << 18) | (value1 << 12) | (value2 << 6) | value3;
+				output[size] = uint8_t(group >> 16);
+				output[size + 1] = uint8_t(group >> 8);
+				output[size + 2] = uint8_t(group);
+				size += 3;
+				offset += 4;
+			}
+
+			// The last group can be partial and padded
+			uint32_t group = 0;
+			uint32_t num_symbols = 0;
+			for (; num_symbols < 4 && offset + num_symbols < input_length; ++num_symbols)
+			{
+				const uint32_t value = decoding_table[uint8_t(input[offset + num_symbols])];
+				if ((value & 0x80) != 0)
+					break;
+
+				group |= value << (18 - (num_symbols * 6));
+			}
+
+			if (num_symbols == 1)
+				return Base64Result::InvalidSymbol;
+
+			if (num_symbols != 0)
+			{
+				offset += num_symbols;
+
+				// Padding is optional but it must complete the group when present
+				if (offset < input_length && input[offset] == '=')
+				{
+					for (uint32_t padding_index = num_symbols; padding_index < 4; ++padding_index, ++offset)
+					{
+						if (offset >= input_length || input[offset] != '=')
+							return Base64Result::InvalidSymbol;
+					}
+				}
+
+				const size_t num_bytes = num_symbols - 1;
+				if (size + num_bytes > output_size)
+					return Base64Result::BufferTooSmall;
+
+				output[size++] = uint8_t(group >> 16);
+				if (num_bytes == 2)
+					output[size++] = uint8_t(group >> 8);
+			}
+
+			out_num_symbols = offset;
+			out_size = size;
+			return Base64Result::Success;
+		}
+	}
+}
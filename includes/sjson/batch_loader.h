@@ -0,0 +1,107 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+// The MIT License (MIT)
+//
+// Copyright (c) 2018 Nicholas Frechette, Cody Jones, and sjson-cpp contributors
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "sjson/error.h"
+#include "sjson/file_reader.h"
+#include "sjson/parallel.h"
+#include "sjson/parser.h"
+#include "sjson/parser_dialect.h"
+#include "sjson/parser_error.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+namespace sjson
+{
+	//////////////////////////////////////////////////////////////////////////
+	// Loads many files on up to 'num_threads' threads, the calling thread included, and calls
+	// 'function(file_index, parser)' for each of them with a parser over its content.
+	// Threads pick the next file as soon as they are done with the previous one, which balances
+	// uneven file sizes, and reading a file on one thread overlaps with parsing on the others.
+	// Every thread reuses the same buffer for all of its files and with a padded dialect,
+	// the padding is provided for free.
+	//
+	// std::vector<ParserError> errors(num_files);
+	// const uint32_t num_failed = load_files_parallel(paths, num_files, 8, [&](uint32_t file_index, Parser& parser)
+	//     {
+	//         parser.read("name", assets[file_index].name);
+	//     }, errors.data());
+	//
+	// The error held by the parser once the function returns is written to 'out_errors[file_index]',
+	// files that cannot be read fail with FileCouldNotBeRead. Returns how many files failed.
+	// The function is called concurrently and the parser is only valid during the call.
+	// If the function throws, the other threads load the remaining files and the first exception
+	// is rethrown once they are done.
+	//////////////////////////////////////////////////////////////////////////
+	template<class DialectType = SJSONDialect, typename FunctionType>
+	inline uint32_t load_files_parallel(const char* const* paths, uint32_t num_files, uint32_t num_threads, FunctionType function, ParserError* out_errors)
+	{
+		SJSON_CPP_ASSERT(num_threads != 0, "Invalid number of threads: %u", num_threads);
+
+		const size_t padding = DialectType::k_input_is_padded ? k_input_padding : 0;
+		std::atomic<uint32_t> next_file_index(0);
+		std::atomic<uint32_t> num_failed(0);
+
+		auto worker = [&]()
+		{
+			std::vector<char> buffer;
+
+			while (true)
+			{
+				const uint32_t file_index = next_file_index.fetch_add(1, std::memory_order_relaxed);
+				if (file_index >= num_files)
+					break;
+
+				ParserError& error = out_errors[file_index];
+				error = ParserError();
+
+				size_t file_size = 0;
+				if (!impl::read_file_into(paths[file_index], buffer, padding, file_size))
+				{
+					error.error = ParserError::FileCouldNotBeRead;
+					num_failed.fetch_add(1, std::memory_order_relaxed);
+					continue;
+				}
+
+				BasicParser<DialectType> parser(buffer.data(), file_size);
+				function(file_index, parser);
+
+				error = parser.get_error();
+				if (error.error != ParserError::None)
+					num_failed.fetch_add(1, std::memory_order_relaxed);
+			}
+		};
+
+		// Spawning threads isn't worth it when each of them would not have a file to load
+		const uint32_t num_workers = std::min(num_threads, num_files);
+
+		impl::run_workers(num_workers, worker);
+
+		return num_failed.load(std::memory_order_relaxed);
+	}
+}
@@ -0,0 +1,766 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+// The MIT License (MIT)
+//
+// Copyright (c) 2018 Nicholas Frechette, Cody Jones, and sjson-cpp contributors
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "sjson/parser_error.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+//////////////////////////////////////////////////////////////////////////
+// Constant expressions with loops require C++14, the constexpr parser is only available from then on
+//////////////////////////////////////////////////////////////////////////
+#if __cplusplus >= 201402L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201402L)
+	#define SJSON_CPP_HAS_CONSTEXPR_PARSER
+#endif
+
+#if defined(SJSON_CPP_HAS_CONSTEXPR_PARSER)
+
+namespace sjson
+{
+	// A literal equivalent of ParserError, the error codes are the same
+	struct ConstexprParserError
+	{
+		constexpr ConstexprParserError()
+			: error(ParserError::None)
+			, line(0)
+			, column(0)
+		{}
+
+		uint32_t error;
+		uint32_t line;
+		uint32_t column;
+	};
+
+	// A literal equivalent of StringView, strings are returned raw like the runtime parser does
+	struct ConstexprStringView
+	{
+		constexpr ConstexprStringView()
+			: c_str("")
+			, size(0)
+		{}
+
+		constexpr ConstexprStringView(const char* c_str_, size_t size_)
+			: c_str(c_str_)
+			, size(size_)
+		{}
+
+		constexpr bool operator==(const char* other) const
+		{
+			size_t offset = 0;
+			for (; offset < size; ++offset)
+			{
+				if (other[offset] != c_str[offset])
+					return false;
+			}
+
+			return other[offset] == '\0';
+		}
+
+		constexpr bool operator!=(const char* other) const { return !(*this == other); }
+
+		const char* c_str;
+		size_t size;
+	};
+
+	namespace impl
+	{
+		// These functions are purposely not constexpr: calling one of them during constant evaluation
+		// is a compile error and the compiler reports its name, which is the name of the parser error.
+		inline void constexpr_parser_error_InputTruncated() {}
+		inline void constexpr_parser_error_OpeningBraceExpected() {}
+		inline void constexpr_parser_error_ClosingBraceExpected() {}
+		inline void constexpr_parser_error_EqualSignExpected() {}
+		inline void constexpr_parser_error_OpeningBracketExpected() {}
+		inline void constexpr_parser_error_ClosingBracketExpected() {}
+		inline void constexpr_parser_error_CommaExpected() {}
+		inline void constexpr_parser_error_CommentBeginsIncorrectly() {}
+		inline void constexpr_parser_error_CannotUseQuotationMarkInUnquotedString() {}
+		inline void constexpr_parser_error_KeyExpected() {}
+		inline void constexpr_parser_error_IncorrectKey() {}
+		inline void constexpr_parser_error_TrueOrFalseExpected() {}
+		inline void constexpr_parser_error_QuotationMarkExpected() {}
+		inline void constexpr_parser_error_NumberExpected() {}
+		inline void constexpr_parser_error_NumberIsTooLong() {}
+		inline void constexpr_parser_error_InvalidNumber() {}
+		inline void constexpr_parser_error_NumberCouldNotBeConverted() {}
+		inline void constexpr_parser_error_UnexpectedContentAtEnd() {}
+		inline void constexpr_parser_error_Unknown() {}
+
+		constexpr void report_constexpr_parser_error(uint32_t error)
+		{
+			switch (error)
+			{
+			case ParserError::None:
+				break;
+			case ParserError::InputTruncated:
+				constexpr_parser_error_InputTruncated();
+				break;
+			case ParserError::OpeningBraceExpected:
+				constexpr_parser_error_OpeningBraceExpected();
+				break;
+			case ParserError::ClosingBraceExpected:
+				constexpr_parser_error_ClosingBraceExpected();
+				break;
+			case ParserError::EqualSignExpected:
+				constexpr_parser_error_EqualSignExpected();
+				break;
+			case ParserError::OpeningBracketExpected:
+				constexpr_parser_error_OpeningBracketExpected();
+				break;
+			case ParserError::ClosingBracketExpected:
+				constexpr_parser_error_ClosingBracketExpected();
+				break;
+			case ParserError::CommaExpected:
+				constexpr_parser_error_CommaExpected();
+				break;
+			case ParserError::CommentBeginsIncorrectly:
+				constexpr_parser_error_CommentBeginsIncorrectly();
+				break;
+			case ParserError::CannotUseQuotationMarkInUnquotedString:
+				constexpr_parser_error_CannotUseQuotationMarkInUnquotedString();
+				break;
+			case ParserError::KeyExpected:
+				constexpr_parser_error_KeyExpected();
+				break;
+			case ParserError::IncorrectKey:
+				constexpr_parser_error_IncorrectKey();
+				break;
+			case ParserError::TrueOrFalseExpected:
+				constexpr_parser_error_TrueOrFalseExpected();
+				break;
+			case ParserError::QuotationMarkExpected:
+				constexpr_parser_error_QuotationMarkExpected();
+				break;
+			case ParserError::NumberExpected:
+				constexpr_parser_error_NumberExpected();
+				break;
+			case ParserError::NumberIsTooLong:
+				constexpr_parser_error_NumberIsTooLong();
+				break;
+			case ParserError::InvalidNumber:
+				constexpr_parser_error_InvalidNumber();
+				break;
+			case ParserError::NumberCouldNotBeConverted:
+				constexpr_parser_error_NumberCouldNotBeConverted();
+				break;
+			case ParserError::UnexpectedContentAtEnd:
+				constexpr_parser_error_UnexpectedContentAtEnd();
+				break;
+			default:
+				constexpr_parser_error_Unknown();
+				break;
+			}
+		}
+
+		constexpr bool is_digit(char symbol) { return symbol >= '0' && symbol <= '9'; }
+
+		// Returns the value of a digit in base 8, 10, or 16, or 16 when the symbol isn't one
+		constexpr uint32_t get_digit_value(char symbol)
+		{
+			if (symbol >= '0' && symbol <= '9')
+				return uint32_t(symbol - '0');
+			if (symbol >= 'a' && symbol <= 'f')
+				return uint32_t(symbol - 'a' + 10);
+			if (symbol >= 'A' && symbol <= 'F')
+				return uint32_t(symbol - 'A' + 10);
+			return 16;
+		}
+		constexpr bool is_space(char symbol) { return symbol == ' ' || symbol == '\t' || symbol == '\n' || symbol == '\r' || symbol == '\v' || symbol == '\f'; }
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+	// A parser usable in constant expressions. It embeds built-in configurations into
+	// typed constants at compile time, with no parsing left to do when the program starts.
+	//
+	// struct RenderDefaults { int32_t width; double gamma; bool vsync; };
+	//
+	// constexpr RenderDefaults make_render_defaults()
+	// {
+	//     ConstexprParser parser("width = 1920 gamma = 2.2 vsync = true");
+	//     RenderDefaults defaults = {};
+	//     parser.read("width", defaults.width);
+	//     parser.read("gamma", defaults.gamma);
+	//     parser.read("vsync", defaults.vsync);
+	//     parser.check();	// Any error is a compile error that names the ParserError code
+	//     return defaults;
+	// }
+	//
+	// constexpr RenderDefaults k_render_defaults = make_render_defaults();
+	//
+	// The same code also runs at runtime where check() does nothing: use is_valid() and get_error() instead.
+	//
+	// It supports a subset of SJSON with the same semantics and error codes as the runtime parser:
+	// comments, quoted and unquoted keys, nested objects, strings, booleans, decimal integers, decimal
+	// numbers, and arrays of numbers. Numbers are converted exactly when they have at most 15 significant
+	// digits and a power of ten of at most 22 in magnitude, other numbers can differ from strtod by an ulp.
+	// Like strtod, numbers too large for their type become infinite and numbers too small become zero.
+	//////////////////////////////////////////////////////////////////////////
+	class ConstexprParser
+	{
+	public:
+		constexpr ConstexprParser(const char* input, size_t input_length)
+			: m_input(input)
+			, m_input_length(input_length)
+			, m_offset(0)
+			, m_line(1)
+			, m_column(1)
+			, m_error()
+		{}
+
+		// Parses a string literal, the NUL terminator is not part of the input
+		template<size_t Size>
+		constexpr ConstexprParser(const char (&input)[Size])
+			: ConstexprParser(input, Size - 1)
+		{}
+
+		constexpr bool object_begins(const char* having_name) { return read_key(having_name) && read_equal_sign() && read_symbol('{', ParserError::OpeningBraceExpected); }
+		constexpr bool object_ends() { return read_symbol('}', ParserError::ClosingBraceExpected); }
+
+		constexpr bool read(const char* key, ConstexprStringView& value) { return read_key(key) && read_equal_sign() && read_string(value); }
+		constexpr bool read(const char* key, bool& value) { return read_key(key) && read_equal_sign() && read_bool(value); }
+		constexpr bool read(const char* key, double& value) { return read_key(key) && read_equal_sign() && read_number(value); }
+
+		constexpr bool read(const char* key, float& value)
+		{
+			double dbl_value = 0.0;
+			if (!read(key, dbl_value))
+				return false;
+
+			value = to_float(dbl_value);
+			return true;
+		}
+
+		template<typename IntegralType, typename std::enable_if<std::is_integral<IntegralType>::value && !std::is_same<IntegralType, bool>::value, int>::type = 0>
+		constexpr bool read(const char* key, IntegralType& value) { return read_key(key) && read_equal_sign() && read_integer(value); }
+
+		// Reads an array of numbers, commas are required between the elements like the runtime parser
+		template<typename NumberType, size_t NumElements>
+		constexpr bool read(const char* key, NumberType (&values)[NumElements])
+		{
+			if (!read_key(key) || !read_equal_sign() || !read_symbol('[', ParserError::OpeningBracketExpected))
+				return false;
+
+			for (size_t element_index = 0; element_index < NumElements; ++element_index)
+			{
+				double value = 0.0;
+				if (!read_number(value))
+					return false;
+
+				values[element_index] = to_number<NumberType>(value);
+
+				if (element_index + 1 < NumElements && !read_symbol(',', ParserError::CommaExpected))
+					return false;
+			}
+
+			return read_symbol(']', ParserError::ClosingBracketExpected);
+		}
+
+		constexpr bool remainder_is_comments_and_whitespace()
+		{
+			if (!skip_comments_and_whitespace())
+				return false;
+
+			if (!eof())
+				return set_error(ParserError::UnexpectedContentAtEnd);
+
+			return true;
+		}
+
+		constexpr bool eof() const { return m_offset >= m_input_length; }
+
+		constexpr ConstexprParserError get_error() const { return m_error; }
+		constexpr bool is_valid() const { return m_error.error == ParserError::None; }
+
+		// During constant evaluation, fails to compile if an error was found
+		constexpr void check() const { impl::report_constexpr_parser_error(m_error.error); }
+
+	private:
+		static constexpr size_t k_max_number_length = 64;
+
+		// Converting a double outside of the range of a float isn't a constant expression, it becomes infinite like with strtof
+		static constexpr float to_float(double value)
+		{
+			return value > double(std::numeric_limits<float>::max()) ? std::numeric_limits<float>::infinity()
+				: value < -double(std::numeric_limits<float>::max()) ? -std::numeric_limits<float>::infinity()
+				: float(value);
+		}
+
+		template<typename NumberType, typename std::enable_if<std::is_same<NumberType, float>::value, int>::type = 0>
+		static constexpr NumberType to_number(double value) { return to_float(value); }
+
+		template<typename NumberType, typename std::enable_if<!std::is_same<NumberType, float>::value, int>::type = 0>
+		static constexpr NumberType to_number(double value) { return NumberType(value); }
+
+		constexpr char get_symbol() const { return m_offset < m_input_length ? m_input[m_offset] : '\0'; }
+
+		constexpr bool advance()
+		{
+			if (eof())
+				return false;
+
+			m_offset++;
+
+			if (get_symbol() == '\n')
+			{
+				++m_line;
+				m_column = 1;
+			}
+			else if (!eof())
+			{
+				m_column++;
+			}
+
+			return true;
+		}
+
+		constexpr bool set_error(uint32_t error)
+		{
+			// Only the first error is retained, like the runtime parser whose reads stop at the first error
+			if (m_error.error == ParserError::None)
+			{
+				m_error.error = error;
+				m_error.line = m_line;
+				m_error.column = m_column;
+			}
+
+			return false;
+		}
+
+		constexpr bool skip_comments_and_whitespace()
+		{
+			if (!is_valid())
+				return false;
+
+			while (!eof())
+			{
+				const char symbol = get_symbol();
+				if (impl::is_space(symbol))
+				{
+					advance();
+					continue;
+				}
+
+				if (symbol != '/')
+					break;
+
+				advance();
+
+				if (get_symbol() == '/')
+				{
+					while (!eof() && get_symbol() != '\n')
+						advance();
+				}
+				else if (get_symbol() == '*')
+				{
+					advance();
+
+					bool was_asterisk = false;
+					while (true)
+					{
+						if (eof())
+							return set_error(ParserError::InputTruncated);
+
+						const char comment_symbol = get_symbol();
+						advance();
+
+						if (was_asterisk && comment_symbol == '/')
+							break;
+
+						was_asterisk = comment_symbol == '*';
+					}
+				}
+				else if (eof())
+					return set_error(ParserError::InputTruncated);
+				else
+					return set_error(ParserError::CommentBeginsIncorrectly);
+			}
+
+			return true;
+		}
+
+		constexpr bool skip_comments_and_whitespace_fail_if_eof()
+		{
+			if (!skip_comments_and_whitespace())
+				return false;
+
+			if (eof())
+				return set_error(ParserError::InputTruncated);
+
+			return true;
+		}
+
+		constexpr bool read_symbol(char expected, uint32_t reason_if_other_found)
+		{
+			if (!skip_comments_and_whitespace_fail_if_eof())
+				return false;
+
+			if (get_symbol() != expected)
+				return set_error(reason_if_other_found);
+
+			advance();
+			return true;
+		}
+
+		constexpr bool read_equal_sign() { return read_symbol('=', ParserError::EqualSignExpected); }
+
+		constexpr bool read_key(const char* having_name)
+		{
+			if (!skip_comments_and_whitespace_fail_if_eof())
+				return false;
+
+			const size_t start_offset = m_offset;
+			const uint32_t start_line = m_line;
+			const uint32_t start_column = m_column;
+
+			ConstexprStringView actual;
+			if (get_symbol() == '"')
+			{
+				if (!read_string(actual))
+					return false;
+			}
+			else
+			{
+				while (true)
+				{
+					if (eof())
+						return set_error(ParserError::InputTruncated);
+
+					const char symbol = get_symbol();
+					if (symbol == '"')
+						return set_error(ParserError::CannotUseQuotationMarkInUnquotedString);
+
+					if (symbol == '=' || impl::is_space(symbol))
+						break;
+
+					advance();
+				}
+
+				if (m_offset == start_offset)
+					return set_error(ParserError::KeyExpected);
+
+				actual = ConstexprStringView(m_input + start_offset, m_offset - start_offset);
+			}
+
+			if (actual != having_name)
+			{
+				// Like the runtime parser, the error points at the start of the key
+				m_offset = start_offset;
+				m_line = start_line;
+				m_column = start_column;
+				return set_error(ParserError::IncorrectKey);
+			}
+
+			return true;
+		}
+
+		constexpr bool read_string(ConstexprStringView& value)
+		{
+			if (!skip_comments_and_whitespace_fail_if_eof())
+				return false;
+
+			if (get_symbol() != '"')
+				return set_error(ParserError::QuotationMarkExpected);
+
+			advance();
+
+			const size_t start_offset = m_offset;
+			while (true)
+			{
+				if (eof())
+					return set_error(ParserError::InputTruncated);
+
+				const char symbol = get_symbol();
+				if (symbol == '"')
+					break;
+
+				advance();
+
+				if (symbol == '\\')
+				{
+					// Escape sequences are returned raw, escaped unicode characters have 4 more bytes
+					const uint32_t num_escaped = get_symbol() == 'u' ? 5 : 1;
+					for (uint32_t escaped_index = 0; escaped_index < num_escaped; ++escaped_index)
+						advance();
+				}
+			}
+
+			value = ConstexprStringView(m_input + start_offset, m_offset - start_offset);
+			advance();
+			return true;
+		}
+
+		constexpr bool read_bool(bool& value)
+		{
+			if (!skip_comments_and_whitespace_fail_if_eof())
+				return false;
+
+			const char* literal = get_symbol() == 't' ? "true" : "false";
+			size_t literal_length = get_symbol() == 't' ? 4 : 5;
+
+			if (m_input_length - m_offset < literal_length)
+				return set_error(ParserError::TrueOrFalseExpected);
+
+			for (size_t offset = 0; offset < literal_length; ++offset)
+			{
+				if (m_input[m_offset + offset] != literal[offset])
+					return set_error(ParserError::TrueOrFalseExpected);
+			}
+
+			for (; literal_length != 0; --literal_length)
+				advance();
+
+			value = literal[0] == 't';
+			return true;
+		}
+
+		// Accumulates up to 19 significant digits, leading zeros are not significant and the digits that
+		// do not fit are dropped while the power of ten keeps track of their position
+		static constexpr void add_digit(char digit, bool is_fraction, uint32_t& num_digits, uint64_t& mantissa, int32_t& exponent)
+		{
+			if (num_digits == 0 && digit == '0')
+			{
+				if (is_fraction)
+					exponent--;
+			}
+			else if (num_digits < 19)
+			{
+				mantissa = (mantissa * 10) + uint64_t(digit - '0');
+				num_digits++;
+
+				if (is_fraction)
+					exponent--;
+			}
+			else if (!is_fraction)
+				exponent++;
+		}
+
+		// Scans a decimal number and returns its significant digits as an integer along with its power of ten
+		constexpr bool scan_number(bool& out_is_negative, uint64_t& out_mantissa, int32_t& out_exponent)
+		{
+			if (!skip_comments_and_whitespace_fail_if_eof())
+				return false;
+
+			const size_t start_offset = m_offset;
+			out_is_negative = get_symbol() == '-';
+			out_mantissa = 0;
+			out_exponent = 0;
+
+			if (out_is_negative)
+				advance();
+
+			if (!impl::is_digit(get_symbol()))
+				return set_error(ParserError::NumberExpected);
+
+			uint32_t num_digits = 0;
+
+			if (get_symbol() == '0')
+				advance();
+			else
+			{
+				while (impl::is_digit(get_symbol()))
+				{
+					add_digit(get_symbol(), false, num_digits, out_mantissa, out_exponent);
+					advance();
+				}
+			}
+
+			if (get_symbol() == '.')
+			{
+				advance();
+
+				while (impl::is_digit(get_symbol()))
+				{
+					add_digit(get_symbol(), true, num_digits, out_mantissa, out_exponent);
+					advance();
+				}
+			}
+
+			if (get_symbol() == 'e' || get_symbol() == 'E')
+			{
+				advance();
+
+				bool is_exponent_negative = false;
+				if (get_symbol() == '+' || get_symbol() == '-')
+				{
+					is_exponent_negative = get_symbol() == '-';
+					advance();
+				}
+				else if (!impl::is_digit(get_symbol()))
+					return set_error(ParserError::InvalidNumber);
+
+				// A sign without digits is scanned but cannot be converted, like with strtod
+				if (!impl::is_digit(get_symbol()))
+					return set_error(ParserError::NumberCouldNotBeConverted);
+
+				int32_t exponent = 0;
+				while (impl::is_digit(get_symbol()))
+				{
+					if (exponent < 100000)
+						exponent = (exponent * 10) + (get_symbol() - '0');
+					advance();
+				}
+
+				out_exponent += is_exponent_negative ? -exponent : exponent;
+			}
+
+			if (m_offset - start_offset >= k_max_number_length)
+				return set_error(ParserError::NumberIsTooLong);
+
+			return true;
+		}
+
+		constexpr bool read_number(double& value)
+		{
+			bool is_negative = false;
+			uint64_t mantissa = 0;
+			int32_t exponent = 0;
+			if (!scan_number(is_negative, mantissa, exponent))
+				return false;
+
+			// Powers of ten up to 1e22 are exact in a double
+			constexpr double k_powers_of_ten[] =
+			{
+				1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+				1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+			};
+
+			// An infinity cannot be produced by arithmetic in a constant expression, overflows are detected
+			// before they happen and the result becomes infinite like it does with strtod
+			constexpr double k_max_value = std::numeric_limits<double>::max();
+			double result = double(mantissa);
+			bool is_infinite = false;
+			int32_t remaining_exponent = exponent;
+			while (remaining_exponent > 22 && !is_infinite)
+			{
+				is_infinite = result > k_max_value / 1e22;
+				if (!is_infinite)
+				{
+					result *= 1e22;
+					remaining_exponent -= 22;
+				}
+			}
+
+			while (remaining_exponent < -22)
+			{
+				result /= 1e22;
+				remaining_exponent += 22;
+			}
+
+			if (is_infinite || (remaining_exponent >= 0 && result > k_max_value / k_powers_of_ten[remaining_exponent]))
+				result = std::numeric_limits<double>::infinity();
+			else if (remaining_exponent >= 0)
+				result *= k_powers_of_ten[remaining_exponent];
+			else
+				result /= k_powers_of_ten[-remaining_exponent];
+
+			value = is_negative ? -result : result;
+			return true;
+		}
+
+		template<typename IntegralType>
+		constexpr bool read_integer(IntegralType& value)
+		{
+			if (!skip_comments_and_whitespace_fail_if_eof())
+				return false;
+
+			const bool is_negative = get_symbol() == '-';
+			if (is_negative)
+				advance();
+
+			if (!impl::is_digit(get_symbol()))
+				return set_error(ParserError::NumberExpected);
+
+			// Like the runtime parser, a leading zero makes an octal integer and '0x' a hexadecimal one
+			uint32_t base = 10;
+			uint32_t num_symbols = 0;
+			if (get_symbol() == '0')
+			{
+				advance();
+				num_symbols++;
+
+				if (get_symbol() == 'x' || get_symbol() == 'X')
+				{
+					advance();
+					num_symbols++;
+					base = 16;
+
+					if (impl::get_digit_value(get_symbol()) >= 16)
+						return set_error(ParserError::NumberCouldNotBeConverted);
+				}
+				else
+					base = 8;
+			}
+
+			uint64_t magnitude = 0;
+			bool is_overflow = false;
+			while (base == 16 ? (impl::get_digit_value(get_symbol()) < 16) : impl::is_digit(get_symbol()))
+			{
+				const uint64_t digit = impl::get_digit_value(get_symbol());
+				if (digit >= base)
+					return set_error(ParserError::NumberCouldNotBeConverted);
+
+				if (magnitude > (std::numeric_limits<uint64_t>::max() - digit) / base)
+					is_overflow = true;
+
+				magnitude = (magnitude * base) + digit;
+				num_symbols++;
+				advance();
+			}
+
+			// Hexadecimal floats have a binary exponent
+			if (get_symbol() == '.' || (base == 16 && (get_symbol() == 'p' || get_symbol() == 'P')))
+				return set_error(ParserError::NumberExpected);
+
+			if (num_symbols >= k_max_number_length)
+				return set_error(ParserError::NumberIsTooLong);
+
+			uint64_t max_magnitude = uint64_t(std::numeric_limits<IntegralType>::max());
+			if (is_negative)
+				max_magnitude = std::is_signed<IntegralType>::value ? (max_magnitude + 1) : 0;
+
+			if (is_overflow || magnitude > max_magnitude)
+				return set_error(ParserError::NumberCouldNotBeConverted);
+
+			// The most negative value cannot be negated, it is built from the one before it
+			if (is_negative && magnitude != 0)
+				value = IntegralType(-int64_t(magnitude - 1) - 1);
+			else
+				value = IntegralType(magnitude);
+			return true;
+		}
+
+		const char* m_input;
+		size_t m_input_length;
+		size_t m_offset;
+		uint32_t m_line;
+		uint32_t m_column;
+		ConstexprParserError m_error;
+	};
+}
+
+#endif
@@ -0,0 +1,495 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+// The MIT License (MIT)
+//
+// Copyright (c) 2018 Nicholas Frechette, Cody Jones, and sjson-cpp contributors
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "sjson/error.h"
+#include "sjson/parser.h"
+#include "sjson/parser_state.h"
+#include "sjson/string_view.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace sjson
+{
+	enum class DiffType
+	{
+		Added,
+		Removed,
+		Changed,
+	};
+
+	struct DiffEntry
+	{
+		DiffType type;
+
+		// The path of the value with the same syntax as PathQuery, it is only valid during the callback
+		StringView path;
+
+		// Raw views of the values in their inputs, empty when the value was added or removed
+		StringView old_value;
+		StringView new_value;
+
+		// Where the values begin in their inputs, zero when the value was added or removed
+		uint32_t old_line;
+		uint32_t old_column;
+		uint32_t new_line;
+		uint32_t new_column;
+	};
+
+	//////////////////////////////////////////////////////////////////////////
+	// Compares two inputs and reports the paths of the values that differ.
+	//
+	// Both inputs are walked in lockstep. Every value is first skipped in bulk on both sides and
+	// when the raw views are identical the whole subtree is considered unchanged. Only objects and
+	// arrays that differ are walked into, this keeps the cost close to a single scan of each input
+	// when few values changed. Whitespace, comments, and separators do not produce differences but
+	// scalars are compared by their raw text: 1.0 and 1 differ.
+	//
+	// Object members are matched by key, reordered members are not a difference. Members in the same
+	// order are matched as they are read. Once an object's keys were reordered, added, or removed,
+	// the members of both sides are indexed by key and looked up with a binary search instead.
+	// Array elements are matched by index.
+	//
+	// DocumentDiff diff;
+	// diff.evaluate(old_parser, new_parser, [](const DiffEntry& entry) { ... });
+	//
+	// Keys are not unescaped in paths. Unlike the parser, the current path and the member indices
+	// are held in containers which allocate memory when they grow.
+	//////////////////////////////////////////////////////////////////////////
+	class DocumentDiff
+	{
+	public:
+		DocumentDiff()
+			: m_path()
+			, m_members()
+			, m_num_differences(0)
+		{}
+
+		// Compares both inputs from the current parser positions which must be within an object (e.g. the root).
+		// The callback is called for every difference with a DiffEntry. When either input is invalid,
+		// it fails and the error is held by its parser.
+		template<class OldDialectType, class NewDialectType, typename DiffFunction>
+		inline bool evaluate(BasicParser<OldDialectType>& old_parser, BasicParser<NewDialectType>& new_parser, DiffFunction on_difference);
+
+		// Returns how many differences were reported by the last evaluation
+		uint32_t get_num_differences() const { return m_num_differences; }
+
+	private:
+		DocumentDiff(const DocumentDiff&) = delete;
+		DocumentDiff& operator=(const DocumentDiff&) = delete;
+
+		struct MemberPosition
+		{
+			StringView key;
+			ParserState start_of_value;
+		};
+
+		template<class OldDialectType, class NewDialectType, typename DiffFunction>
+		inline bool diff_value(BasicParser<OldDialectType>& old_parser, BasicParser<NewDialectType>& new_parser, DiffFunction& on_difference);
+
+		template<class OldDialectType, class NewDialectType, typename DiffFunction>
+		inline bool diff_members(BasicParser<OldDialectType>& old_parser, BasicParser<NewDialectType>& new_parser, bool is_root, DiffFunction& on_difference);
+
+		template<class OldDialectType, class NewDialectType, typename DiffFunction>
+		inline bool diff_elements(BasicParser<OldDialectType>& old_parser, BasicParser<NewDialectType>& new_parser, DiffFunction& on_difference);
+
+		template<class DialectType>
+		static inline bool read_end_of_members(BasicParser<DialectType>& parser, bool is_root, bool& out_is_end);
+
+		// Appends the members of the object that begins at 'start_of_members' to m_members, sorted by key.
+		// The parser is left at the end of the object.
+		template<class DialectType>
+		inline bool index_members(BasicParser<DialectType>& parser, bool is_root, const ParserState& start_of_members, size_t& out_index_start);
+
+		// Returns the first member with the given key within [index_start, index_end) of m_members or nullptr
+		inline const MemberPosition* find_member(size_t index_start, size_t index_end, const StringView& key) const;
+
+		static inline bool is_key_less(const StringView& lhs, const StringView& rhs);
+
+		template<class DialectType>
+		static inline bool read_value(BasicParser<DialectType>& parser, StringView& out_value, ParserState& out_start_of_value);
+
+		template<typename DiffFunction>
+		inline void report(DiffFunction& on_difference, DiffType type, const StringView& old_value, const ParserState* old_start, const StringView& new_value, const ParserState* new_start);
+
+		inline size_t push_key(const StringView& key);
+		inline size_t push_index(uint32_t index);
+
+		std::string m_path;
+
+		// The indexed members of every object being compared that is out of lockstep, innermost last
+		std::vector<MemberPosition> m_members;
+
+		uint32_t m_num_differences;
+	};
+
+	//////////////////////////////////////////////////////////////////////////
+
+	template<class OldDialectType, class NewDialectType, typename DiffFunction>
+	inline bool DocumentDiff::evaluate(BasicParser<OldDialectType>& old_parser, BasicParser<NewDialectType>& new_parser, DiffFunction on_difference)
+	{
+		m_path.clear();
+		m_members.clear();
+		m_num_differences = 0;
+
+		return diff_members(old_parser, new_parser, true, on_difference);
+	}
+
+	template<class OldDialectType, class NewDialectType, typename DiffFunction>
+	inline bool DocumentDiff::diff_value(BasicParser<OldDialectType>& old_parser, BasicParser<NewDialectType>& new_parser, DiffFunction& on_difference)
+	{
+		const ValueType old_type = old_parser.peek_value_type();
+		const ValueType new_type = new_parser.peek_value_type();
+		const ParserState old_start = old_parser.save_state();
+		const ParserState new_start = new_parser.save_state();
+
+		StringView old_value;
+		StringView new_value;
+		if (!old_parser.read_raw_value(old_value) || !new_parser.read_raw_value(new_value))
+			return false;
+
+		if (old_value == new_value)
+			return true;
+
+		if (old_type != new_type || (old_type != ValueType::Object && old_type != ValueType::Array))
+		{
+			report(on_difference, DiffType::Changed, old_value, &old_start, new_value, &new_start);
+			return true;
+		}
+
+		// Walk into both containers and resume after them once done
+		const ParserState old_end = old_parser.save_state();
+		const ParserState new_end = new_parser.save_state();
+		old_parser.restore_state(old_start);
+		new_parser.restore_state(new_start);
+
+		if (old_type == ValueType::Object)
+		{
+			if (!old_parser.object_begins() || !new_parser.object_begins() || !diff_members(old_parser, new_parser, false, on_difference))
+				return false;
+		}
+		else
+		{
+			if (!old_parser.array_begins() || !new_parser.array_begins() || !diff_elements(old_parser, new_parser, on_difference))
+				return false;
+		}
+
+		old_parser.restore_state(old_end);
+		new_parser.restore_state(new_end);
+		return true;
+	}
+
+	template<class OldDialectType, class NewDialectType, typename DiffFunction>
+	inline bool DocumentDiff::diff_members(BasicParser<OldDialectType>& old_parser, BasicParser<NewDialectType>& new_parser, bool is_root, DiffFunction& on_difference)
+	{
+		const ParserState old_members = old_parser.save_state();
+		const ParserState new_members = new_parser.save_state();
+		ParserState new_cursor = new_members;
+		bool is_in_lockstep = true;
+
+		// Nested objects index their members after ours and remove them once done
+		const size_t members_base = m_members.size();
+		size_t new_index_start = members_base;
+		size_t new_index_end = members_base;
+
+		StringView old_key;
+		StringView new_key;
+		StringView value;
+		ParserState start_of_value = old_members;
+
+		while (true)
+		{
+			bool is_end;
+			if (!read_end_of_members(old_parser, is_root, is_end))
+				return false;
+
+			if (is_end)
+				break;
+
+			if (!old_parser.read_next_key(old_key))
+				return false;
+
+			const size_t parent_path_length = push_key(old_key);
+
+			// Members in the same order are matched as they are read
+			bool is_found = false;
+			new_parser.restore_state(new_cursor);
+
+			bool is_new_end;
+			if (!read_end_of_members(new_parser, is_root, is_new_end))
+				return false;
+
+			if (!is_new_end)
+			{
+				if (!new_parser.read_next_key(new_key))
+					return false;
+
+				is_found = new_key == old_key;
+			}
+
+			if (!is_found)
+			{
+				if (is_in_lockstep)
+				{
+					is_in_lockstep = false;
+					if (!index_members(new_parser, is_root, new_members, new_index_start))
+						return false;
+
+					new_index_end = m_members.size();
+				}
+
+				const MemberPosition* member = find_member(new_index_start, new_index_end, old_key);
+				if (member != nullptr)
+				{
+					new_parser.restore_state(member->start_of_value);
+					is_found = true;
+				}
+			}
+
+			if (is_found)
+			{
+				if (!diff_value(old_parser, new_parser, on_difference))
+					return false;
+
+				new_cursor = new_parser.save_state();
+			}
+			else
+			{
+				if (!read_value(old_parser, value, start_of_value))
+					return false;
+
+				report(on_difference, DiffType::Removed, value, &start_of_value, StringView(), nullptr);
+			}
+
+			m_path.resize(parent_path_length);
+		}
+
+		// When every member matched in order, only the trailing ones can be new.
+		// Otherwise, every new member is searched for in the old object.
+		size_t old_index_start = m_members.size();
+		size_t old_index_end = old_index_start;
+		if (!is_in_lockstep)
+		{
+			const ParserState old_end = old_parser.save_state();
+			if (!index_members(old_parser, is_root, old_members, old_index_start))
+				return false;
+
+			old_index_end = m_members.size();
+			old_parser.restore_state(old_end);
+		}
+
+		new_parser.restore_state(is_in_lockstep ? new_cursor : new_members);
+
+		while (true)
+		{
+			bool is_end;
+			if (!read_end_of_members(new_parser, is_root, is_end))
+				return false;
+
+			if (is_end)
+				break;
+
+			if (!new_parser.read_next_key(new_key) || !read_value(new_parser, value, start_of_value))
+				return false;
+
+			if (find_member(old_index_start, old_index_end, new_key) == nullptr)
+			{
+				const size_t parent_path_length = push_key(new_key);
+				report(on_difference, DiffType::Added, StringView(), nullptr, value, &start_of_value);
+				m_path.resize(parent_path_length);
+			}
+		}
+
+		m_members.erase(m_members.begin() + members_base, m_members.end());
+		return true;
+	}
+
+	template<class OldDialectType, class NewDialectType, typename DiffFunction>
+	inline bool DocumentDiff::diff_elements(BasicParser<OldDialectType>& old_parser, BasicParser<NewDialectType>& new_parser, DiffFunction& on_difference)
+	{
+		StringView value;
+		ParserState start_of_value = old_parser.save_state();
+		bool is_old_end = false;
+		bool is_new_end = false;
+
+		for (uint32_t element_index = 0; true; ++element_index)
+		{
+			is_old_end = is_old_end || old_parser.try_array_ends();
+			is_new_end = is_new_end || new_parser.try_array_ends();
+
+			if (is_old_end && is_new_end)
+				return true;
+
+			if (element_index != 0)
+			{
+				if ((!is_old_end && !old_parser.read_array_separator()) || (!is_new_end && !new_parser.read_array_separator()))
+					return false;
+			}
+
+			const size_t parent_path_length = push_index(element_index);
+
+			if (!is_old_end && !is_new_end)
+			{
+				if (!diff_value(old_parser, new_parser, on_difference))
+					return false;
+			}
+			else if (!is_old_end)
+			{
+				if (!read_value(old_parser, value, start_of_value))
+					return false;
+
+				report(on_difference, DiffType::Removed, value, &start_of_value, StringView(), nullptr);
+			}
+			else
+			{
+				if (!read_value(new_parser, value, start_of_value))
+					return false;
+
+				report(on_difference, DiffType::Added, StringView(), nullptr, value, &start_of_value);
+			}
+
+			m_path.resize(parent_path_length);
+		}
+	}
+
+	template<class DialectType>
+	inline bool DocumentDiff::read_end_of_members(BasicParser<DialectType>& parser, bool is_root, bool& out_is_end)
+	{
+		out_is_end = true;
+
+		if (is_root)
+		{
+			if (!parser.skip_comments_and_whitespace())
+				return false;
+
+			if (parser.is_root_object_end())
+				return true;
+		}
+		else if (parser.try_object_ends())
+			return true;
+
+		out_is_end = false;
+		return true;
+	}
+
+	template<class DialectType>
+	inline bool DocumentDiff::index_members(BasicParser<DialectType>& parser, bool is_root, const ParserState& start_of_members, size_t& out_index_start)
+	{
+		out_index_start = m_members.size();
+		parser.restore_state(start_of_members);
+
+		MemberPosition member = { StringView(), start_of_members };
+		while (true)
+		{
+			bool is_end;
+			if (!read_end_of_members(parser, is_root, is_end))
+				return false;
+
+			if (is_end)
+				break;
+
+			if (!parser.read_next_key(member.key))
+				return false;
+
+			member.start_of_value = parser.save_state();
+			m_members.push_back(member);
+
+			if (!parser.skip_value())
+				return false;
+		}
+
+		// A stable sort keeps the first of duplicate keys first, like a scan in input order would
+		std::stable_sort(m_members.begin() + out_index_start, m_members.end(), [](const MemberPosition& lhs, const MemberPosition& rhs) { return is_key_less(lhs.key, rhs.key); });
+		return true;
+	}
+
+	inline const DocumentDiff::MemberPosition* DocumentDiff::find_member(size_t index_start, size_t index_end, const StringView& key) const
+	{
+		const MemberPosition* members_end = m_members.data() + index_end;
+		const MemberPosition* member = std::lower_bound(m_members.data() + index_start, members_end, key, [](const MemberPosition& position, const StringView& value) { return is_key_less(position.key, value); });
+		return member != members_end && member->key == key ? member : nullptr;
+	}
+
+	inline bool DocumentDiff::is_key_less(const StringView& lhs, const StringView& rhs)
+	{
+		const size_t min_size = lhs.size() < rhs.size() ? lhs.size() : rhs.size();
+		const int result = std::memcmp(lhs.c_str(), rhs.c_str(), min_size);
+		return result < 0 || (result == 0 && lhs.size() < rhs.size());
+	}
+
+	template<class DialectType>
+	inline bool DocumentDiff::read_value(BasicParser<DialectType>& parser, StringView& out_value, ParserState& out_start_of_value)
+	{
+		if (!parser.skip_comments_and_whitespace())
+			return false;
+
+		out_start_of_value = parser.save_state();
+		return parser.read_raw_value(out_value);
+	}
+
+	template<typename DiffFunction>
+	inline void DocumentDiff::report(DiffFunction& on_difference, DiffType type, const StringView& old_value, const ParserState* old_start, const StringView& new_value, const ParserState* new_start)
+	{
+		DiffEntry entry;
+		entry.type = type;
+		entry.path = StringView(m_path.c_str(), m_path.size());
+		entry.old_value = old_value;
+		entry.new_value = new_value;
+		entry.old_line = old_start != nullptr ? old_start->line : 0;
+		entry.old_column = old_start != nullptr ? old_start->column : 0;
+		entry.new_line = new_start != nullptr ? new_start->line : 0;
+		entry.new_column = new_start != nullptr ? new_start->column : 0;
+
+		m_num_differences++;
+		on_difference(entry);
+	}
+
+	inline size_t DocumentDiff::push_key(const StringView& key)
+	{
+		const size_t parent_path_length = m_path.size();
+		if (parent_path_length != 0)
+			m_path.push_back('.');
+
+		m_path.append(key.c_str(), key.size());
+		return parent_path_length;
+	}
+
+	inline size_t DocumentDiff::push_index(uint32_t index)
+	{
+		const size_t parent_path_length = m_path.size();
+		if (parent_path_length != 0)
+			m_path.push_back('.');
+
+		char buffer[16];
+		const int length = snprintf(buffer, sizeof(buffer), "%u", index);
+		m_path.append(buffer, size_t(length));
+		return parent_path_length;
+	}
+}
@@ -0,0 +1,602 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+// The MIT License (MIT)
+//
+// Copyright (c) 2018 Nicholas Frechette, Cody Jones, and sjson-cpp contributors
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "sjson/parser.h"
+#include "sjson/parser_dialect.h"
+#include "sjson/parser_error.h"
+#include "sjson/parser_state.h"
+#include "sjson/string_view.h"
+
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <vector>
+
+namespace sjson
+{
+	class Document;
+
+	namespace impl
+	{
+		// Parses an array index from a path segment, returns false if it isn't a valid one
+		inline bool parse_path_index(const char* segment, const char* segment_end, uint32_t& out_index)
+		{
+			uint32_t index = 0;
+			const char* digit = segment;
+			for (; digit != segment_end && std::isdigit(*digit); ++digit)
+				index = (index * 10) + uint32_t(*digit - '0');
+
+			if (digit == segment || digit != segment_end || segment_end - segment >= 10)
+				return false;
+
+			out_index = index;
+			return true;
+		}
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+	// A lightweight handle to a value within a document. It is only valid for
+	// as long as the document it came from is alive.
+	// Numbers are converted once when the document is built, reading them does not parse anything.
+	//////////////////////////////////////////////////////////////////////////
+	class DocumentValue
+	{
+	public:
+		DocumentValue()
+			: m_document(nullptr)
+			, m_node_index(0)
+		{}
+
+		// Returns false when the value was not found
+		bool is_valid() const { return m_document != nullptr; }
+
+		inline ValueType get_type() const;
+
+		// The key of the value when it is an object member, empty otherwise
+		inline StringView get_key() const;
+
+		// A raw view of the value in the document, strings retain their quotation marks
+		inline StringView get_raw_value() const;
+
+		// The index of the value in its document, see Document::get_value(..)
+		uint32_t get_index() const { return m_node_index; }
+
+		// Where the value begins in the input
+		inline uint32_t get_line() const;
+		inline uint32_t get_column() const;
+
+		// The number of members of an object or elements of an array
+		inline uint32_t get_num_children() const;
+		inline DocumentValue get_child(uint32_t child_index) const;
+
+		// Finds a value relative to this one, see Document::find(..)
+		inline DocumentValue find(const char* path) const;
+
+		// Finds the member of an object with the given key, the key is not a path
+		inline DocumentValue find_member(const StringView& key) const;
+
+		inline bool get(StringView& value) const;
+		inline bool get(bool& value) const;
+		inline bool get(double& value) const;
+		inline bool get(float& value) const;
+		bool get(int8_t& value) const { return get_integer(value); }
+		bool get(uint8_t& value) const { return get_integer(value); }
+		bool get(int16_t& value) const { return get_integer(value); }
+		bool get(uint16_t& value) const { return get_integer(value); }
+		bool get(int32_t& value) const { return get_integer(value); }
+		bool get(uint32_t& value) const { return get_integer(value); }
+		bool get(int64_t& value) const { return get_integer(value); }
+		bool get(uint64_t& value) const { return get_integer(value); }
+
+	private:
+		DocumentValue(const Document* document, uint32_t node_index)
+			: m_document(document)
+			, m_node_index(node_index)
+		{}
+
+		template<typename IntegralType>
+		inline bool get_integer(IntegralType& value) const;
+
+		const Document* m_document;
+		uint32_t m_node_index;
+
+		friend class Document;
+	};
+
+	//////////////////////////////////////////////////////////////////////////
+	// An immutable document built from an input in a single pass.
+	//
+	// The document owns a copy of the input along with a flat index of every value in it.
+	// Once built, it is never modified: any number of threads can query a shared document
+	// concurrently without locks and without parsing anything.
+	//
+	// std::shared_ptr<const Document> document = Document::parse(buffer, buffer_size);
+	// uint32_t width;
+	// if (document && document->find("render.width").get(width)) ...
+	//
+	// Values are located with 32 bit offsets, inputs larger than 4 GB are refused with InputTooLarge.
+	// Unlike the parser, building a document allocates memory.
+	//////////////////////////////////////////////////////////////////////////
+	class Document
+	{
+	public:
+		// Returns null if the input is invalid, the reason is written to 'out_error' when provided
+		template<class DialectType = SJSONDialect>
+		static inline std::shared_ptr<const Document> parse(const char* input, size_t input_length, ParserError* out_error = nullptr);
+
+		DocumentValue get_root() const { return DocumentValue(this, 0); }
+
+		// Finds a value from the root with the same path syntax as PathQuery:
+		// keys and array indices separated by '.' or a JSON Pointer when the path starts with '/'
+		DocumentValue find(const char* path) const { return get_root().find(path); }
+
+		StringView get_input() const { return StringView(m_input.get(), m_input_length); }
+		uint32_t get_num_values() const { return uint32_t(m_nodes.size()); }
+
+		// Values are stored depth-first in the order they appear in the input, the root is value 0
+		DocumentValue get_value(uint32_t value_index) const { return value_index < m_nodes.size() ? DocumentValue(this, value_index) : DocumentValue(); }
+
+	private:
+		struct Node
+		{
+			uint32_t key_offset;
+			uint32_t key_length;
+			uint32_t value_offset;
+			uint32_t value_length;
+
+			// One past the index of the last node of the subtree, the next sibling starts there
+			uint32_t end_index;
+			uint32_t num_children;
+
+			uint32_t line;
+			uint32_t column;
+
+			ValueType type;
+			bool bool_value;
+			bool is_integer;
+
+			// Integers above INT64_MAX are stored as a uint64_t in 'integer_value'
+			bool is_large_unsigned;
+
+			double number_value;
+			int64_t integer_value;
+		};
+
+		Document() : m_input(), m_input_length(0), m_nodes() {}
+
+		Document(const Document&) = delete;
+		Document& operator=(const Document&) = delete;
+
+		inline uint32_t add_node(const StringView& key, const ParserState& start_of_value);
+
+		template<class DialectType>
+		inline bool build_members(BasicParser<DialectType>& parser, uint32_t node_index, bool is_root);
+
+		template<class DialectType>
+		inline bool build_elements(BasicParser<DialectType>& parser, uint32_t node_index);
+
+		template<class DialectType>
+		inline bool build_value(BasicParser<DialectType>& parser, const StringView& key);
+
+		std::unique_ptr<char[]> m_input;
+		size_t m_input_length;
+		std::vector<Node> m_nodes;
+
+		friend class DocumentValue;
+	};
+
+	//////////////////////////////////////////////////////////////////////////
+
+	template<class DialectType>
+	inline std::shared_ptr<const Document> Document::parse(const char* input, size_t input_length, ParserError* out_error)
+	{
+		if (input_length > std::numeric_limits<uint32_t>::max())
+		{
+			if (out_error != nullptr)
+			{
+				*out_error = ParserError();
+				out_error->error = ParserError::InputTooLarge;
+			}
+
+			return nullptr;
+		}
+
+		std::shared_ptr<Document> document(new Document());
+		document->m_input.reset(new char[input_length + 1]);
+		document->m_input_length = input_length;
+		std::memcpy(document->m_input.get(), input, input_length);
+		document->m_input[input_length] = '\0';
+
+		BasicParser<DialectType> parser(document->m_input.get(), input_length);
+
+		const uint32_t root_index = document->add_node(StringView(), parser.save_state());
+		document->m_nodes[root_index].type = ValueType::Object;
+		document->m_nodes[root_index].value_offset = 0;
+
+		const bool is_valid = document->build_members(parser, root_index, true) && parser.remainder_is_comments_and_whitespace();
+		if (out_error != nullptr)
+			*out_error = parser.get_error();
+
+		if (!is_valid)
+			return nullptr;
+
+		Node& root = document->m_nodes[root_index];
+		root.value_length = uint32_t(input_length);
+		root.end_index = uint32_t(document->m_nodes.size());
+		return document;
+	}
+
+	inline uint32_t Document::add_node(const StringView& key, const ParserState& start_of_value)
+	{
+		Node node;
+		node.key_offset = key.empty() ? 0 : uint32_t(key.c_str() - m_input.get());
+		node.key_length = uint32_t(key.size());
+		node.value_offset = uint32_t(start_of_value.offset);
+		node.value_length = 0;
+		node.end_index = 0;
+		node.num_children = 0;
+		node.line = start_of_value.line;
+		node.column = start_of_value.column;
+		node.type = ValueType::Unknown;
+		node.bool_value = false;
+		node.is_integer = false;
+		node.is_large_unsigned = false;
+		node.number_value = 0.0;
+		node.integer_value = 0;
+
+		m_nodes.push_back(node);
+		return uint32_t(m_nodes.size() - 1);
+	}
+
+	template<class DialectType>
+	inline bool Document::build_members(BasicParser<DialectType>& parser, uint32_t node_index, bool is_root)
+	{
+		StringView key;
+		uint32_t num_members = 0;
+
+		while (true)
+		{
+			if (is_root)
+			{
+				if (!parser.skip_comments_and_whitespace())
+					return false;
+
+				if (parser.is_root_object_end())
+					break;
+			}
+			else if (parser.try_object_ends())
+				break;
+
+			if (!parser.read_next_key(key) || !build_value(parser, key))
+				return false;
+
+			num_members++;
+		}
+
+		m_nodes[node_index].num_children = num_members;
+		return true;
+	}
+
+	template<class DialectType>
+	inline bool Document::build_elements(BasicParser<DialectType>& parser, uint32_t node_index)
+	{
+		uint32_t num_elements = 0;
+
+		while (!parser.try_array_ends())
+		{
+			if (num_elements != 0 && !parser.read_array_separator())
+				return false;
+
+			if (!build_value(parser, StringView()))
+				return false;
+
+			num_elements++;
+		}
+
+		m_nodes[node_index].num_children = num_elements;
+		return true;
+	}
+
+	template<class DialectType>
+	inline bool Document::build_value(BasicParser<DialectType>& parser, const StringView& key)
+	{
+		// Anything that isn't obviously another type is read as a number which reports invalid values
+		const ValueType peeked_type = parser.peek_value_type();
+		const ValueType type = peeked_type == ValueType::Unknown ? ValueType::Number : peeked_type;
+
+		const ParserState start_of_value = parser.save_state();
+		const uint32_t node_index = add_node(key, start_of_value);
+		m_nodes[node_index].type = type;
+
+		switch (type)
+		{
+		case ValueType::Object:
+			if (!parser.object_begins() || !build_members(parser, node_index, false))
+				return false;
+			break;
+		case ValueType::Array:
+			if (!parser.array_begins() || !build_elements(parser, node_index))
+				return false;
+			break;
+		case ValueType::Bool:
+		{
+			bool value;
+			if (!parser.read(value))
+				return false;
+
+			m_nodes[node_index].bool_value = value;
+			break;
+		}
+		case ValueType::Number:
+		{
+			Node& node = m_nodes[node_index];
+
+			// Integers are read as such to retain their full precision, they are converted only once
+			if (!impl::is_integer_token(parser.get_input(), parser.get_input_length(), start_of_value.offset))
+			{
+				if (!parser.read(node.number_value))
+					return false;
+			}
+			else if (start_of_value.symbol == '-')
+			{
+				if (!parser.read(node.integer_value))
+					return false;
+
+				node.is_integer = true;
+				node.number_value = node.integer_value == 0 ? -0.0 : double(node.integer_value);
+			}
+			else
+			{
+				uint64_t value;
+				if (!parser.read(value))
+					return false;
+
+				node.is_integer = true;
+				node.is_large_unsigned = value > uint64_t(std::numeric_limits<int64_t>::max());
+				node.integer_value = int64_t(value);
+				node.number_value = double(value);
+			}
+			break;
+		}
+		default:
+			if (!parser.skip_value())
+				return false;
+			break;
+		}
+
+		Node& node = m_nodes[node_index];
+		node.value_length = uint32_t(parser.save_state().offset - start_of_value.offset);
+		node.end_index = uint32_t(m_nodes.size());
+		return true;
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+
+	inline ValueType DocumentValue::get_type() const
+	{
+		return is_valid() ? m_document->m_nodes[m_node_index].type : ValueType::Unknown;
+	}
+
+	inline StringView DocumentValue::get_key() const
+	{
+		if (!is_valid())
+			return StringView();
+
+		const Document::Node& node = m_document->m_nodes[m_node_index];
+		return node.key_length == 0 ? StringView() : StringView(m_document->m_input.get() + node.key_offset, node.key_length);
+	}
+
+	inline StringView DocumentValue::get_raw_value() const
+	{
+		if (!is_valid())
+			return StringView();
+
+		const Document::Node& node = m_document->m_nodes[m_node_index];
+		return StringView(m_document->m_input.get() + node.value_offset, node.value_length);
+	}
+
+	inline uint32_t DocumentValue::get_line() const { return is_valid() ? m_document->m_nodes[m_node_index].line : 0; }
+	inline uint32_t DocumentValue::get_column() const { return is_valid() ? m_document->m_nodes[m_node_index].column : 0; }
+
+	inline uint32_t DocumentValue::get_num_children() const
+	{
+		return is_valid() ? m_document->m_nodes[m_node_index].num_children : 0;
+	}
+
+	inline DocumentValue DocumentValue::get_child(uint32_t child_index) const
+	{
+		if (!is_valid())
+			return DocumentValue();
+
+		const std::vector<Document::Node>& nodes = m_document->m_nodes;
+		if (child_index >= nodes[m_node_index].num_children)
+			return DocumentValue();
+
+		uint32_t node_index = m_node_index + 1;
+		for (uint32_t index = 0; index < child_index; ++index)
+			node_index = nodes[node_index].end_index;
+
+		return DocumentValue(m_document, node_index);
+	}
+
+	inline DocumentValue DocumentValue::find(const char* path) const
+	{
+		if (!is_valid())
+			return DocumentValue();
+
+		const std::vector<Document::Node>& nodes = m_document->m_nodes;
+		const char* input = m_document->m_input.get();
+
+		char separator = '.';
+		if (path[0] == '/')
+		{
+			separator = '/';
+			path++;
+		}
+
+		uint32_t node_index = m_node_index;
+		while (true)
+		{
+			const char* segment_end = path;
+			while (*segment_end != '\0' && *segment_end != separator)
+				segment_end++;
+
+			const Document::Node& node = nodes[node_index];
+			const uint32_t num_children = node.num_children;
+			uint32_t child_index = node_index + 1;
+
+			if (node.type == ValueType::Object)
+			{
+				const StringView key(path, segment_end - path);
+				uint32_t member_index = 0;
+				for (; member_index < num_children; ++member_index)
+				{
+					const Document::Node& child = nodes[child_index];
+					if (StringView(input + child.key_offset, child.key_length) == key)
+						break;
+
+					child_index = child.end_index;
+				}
+
+				if (member_index == num_children)
+					return DocumentValue();
+			}
+			else if (node.type == ValueType::Array)
+			{
+				uint32_t element_index = 0;
+				if (!impl::parse_path_index(path, segment_end, element_index) || element_index >= num_children)
+					return DocumentValue();
+
+				for (uint32_t index = 0; index < element_index; ++index)
+					child_index = nodes[child_index].end_index;
+			}
+			else
+				return DocumentValue();
+
+			node_index = child_index;
+
+			if (*segment_end == '\0')
+				return DocumentValue(m_document, node_index);
+
+			path = segment_end + 1;
+		}
+	}
+
+	inline DocumentValue DocumentValue::find_member(const StringView& key) const
+	{
+		if (get_type() != ValueType::Object)
+			return DocumentValue();
+
+		const std::vector<Document::Node>& nodes = m_document->m_nodes;
+		const char* input = m_document->m_input.get();
+		const uint32_t num_children = nodes[m_node_index].num_children;
+
+		uint32_t child_index = m_node_index + 1;
+		for (uint32_t member_index = 0; member_index < num_children; ++member_index)
+		{
+			const Document::Node& child = nodes[child_index];
+			if (StringView(input + child.key_offset, child.key_length) == key)
+				return DocumentValue(m_document, child_index);
+
+			child_index = child.end_index;
+		}
+
+		return DocumentValue();
+	}
+
+	inline bool DocumentValue::get(StringView& value) const
+	{
+		if (get_type() != ValueType::String)
+			return false;
+
+		// Strings are returned raw without their quotation marks, like the parser does
+		const Document::Node& node = m_document->m_nodes[m_node_index];
+		value = node.value_length == 2 ? StringView() : StringView(m_document->m_input.get() + node.value_offset + 1, node.value_length - 2);
+		return true;
+	}
+
+	inline bool DocumentValue::get(bool& value) const
+	{
+		if (get_type() != ValueType::Bool)
+			return false;
+
+		value = m_document->m_nodes[m_node_index].bool_value;
+		return true;
+	}
+
+	inline bool DocumentValue::get(double& value) const
+	{
+		if (get_type() != ValueType::Number)
+			return false;
+
+		value = m_document->m_nodes[m_node_index].number_value;
+		return true;
+	}
+
+	inline bool DocumentValue::get(float& value) const
+	{
+		if (get_type() != ValueType::Number)
+			return false;
+
+		value = float(m_document->m_nodes[m_node_index].number_value);
+		return true;
+	}
+
+	template<typename IntegralType>
+	inline bool DocumentValue::get_integer(IntegralType& value) const
+	{
+		if (get_type() != ValueType::Number)
+			return false;
+
+		const Document::Node& node = m_document->m_nodes[m_node_index];
+		if (!node.is_integer)
+			return false;
+
+		if (node.is_large_unsigned)
+		{
+			const uint64_t unsigned_value = uint64_t(node.integer_value);
+			if (std::numeric_limits<IntegralType>::is_signed || unsigned_value > uint64_t(std::numeric_limits<IntegralType>::max()))
+				return false;
+
+			value = IntegralType(unsigned_value);
+			return true;
+		}
+
+		const int64_t integer_value = node.integer_value;
+		if (std::numeric_limits<IntegralType>::is_signed)
+		{
+			if (integer_value < int64_t(std::numeric_limits<IntegralType>::min()) || integer_value > int64_t(std::numeric_limits<IntegralType>::max()))
+				return false;
+		}
+		else if (integer_value < 0 || uint64_t(integer_value) > uint64_t(std::numeric_limits<IntegralType>::max()))
+			return false;
+
+		value = IntegralType(integer_value);
+		return true;
+	}
+}
@@ -0,0 +1,268 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+// The MIT License (MIT)
+//
+// Copyright (c) 2018 Nicholas Frechette, Cody Jones, and sjson-cpp contributors
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "sjson/document.h"
+#include "sjson/string_view.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace sjson
+{
+	class DocumentOverlay;
+
+	//////////////////////////////////////////////////////////////////////////
+	// A value resolved through the layers of an overlay along with every layer that
+	// contributes to it, from the top-most one down.
+	// Objects merge with the objects found at the same path in lower layers while any other
+	// value replaces whatever lower layers hold, only objects have more than one source.
+	// It must not outlive the overlay it came from. Once a layer is added or removed, the value
+	// is stale: it is no longer valid and has no sources, rather than reading another layer.
+	//////////////////////////////////////////////////////////////////////////
+	class OverlayValue
+	{
+	public:
+		static constexpr uint32_t k_max_num_sources = 16;
+
+		OverlayValue() : OverlayValue(nullptr) {}
+
+		// Returns false when the value was not found in any layer or when it is stale
+		inline bool is_valid() const;
+
+		ValueType get_type() const { return get_value().get_type(); }
+
+		// The value from the top-most layer that holds it, for its raw value and location
+		DocumentValue get_value() const { return get_source(0); }
+
+		// The layers that contribute to this value, source 0 is the top-most one
+		uint32_t get_num_sources() const { return is_valid() ? m_num_sources : 0; }
+		inline DocumentValue get_source(uint32_t source_index) const;
+		uint32_t get_source_layer(uint32_t source_index) const { return source_index < get_num_sources() ? m_source_layers[source_index] : 0; }
+
+		// Finds a value relative to this one, see DocumentOverlay::find(..)
+		inline OverlayValue find(const char* path) const;
+
+		template<typename DataType>
+		bool get(DataType& value) const { return get_value().get(value); }
+
+	private:
+		inline explicit OverlayValue(const DocumentOverlay* overlay);
+
+		// Returns false when every source is already used
+		inline bool add_source(const DocumentValue& value, uint32_t layer_index);
+
+		// Sources are held as the index of their value within their layer, a handle is only built when
+		// a source is accessed. This keeps a value small since lookups copy one per path segment.
+		// Layer indices shift when a layer is removed, the generation of the layers detects it.
+		const DocumentOverlay* m_overlay;
+		uint32_t m_layers_generation;
+		uint32_t m_node_indices[k_max_num_sources];
+		uint8_t m_source_layers[k_max_num_sources];
+		uint32_t m_num_sources;
+
+		friend class DocumentOverlay;
+	};
+
+	//////////////////////////////////////////////////////////////////////////
+	// A read-only view that layers documents on top of each other, such as a base
+	// configuration and the files that override it, without building a merged document.
+	//
+	// Lookups walk the layers top-down one path segment at a time and only visit the members
+	// along the path that is queried. Layers are shared documents: adding or removing one
+	// only updates a small list and never copies or re-parses anything.
+	//
+	// DocumentOverlay overlay;
+	// overlay.add_layer(Document::parse(base, base_size));
+	// overlay.add_layer(Document::parse(user, user_size));
+	// uint32_t width;
+	// if (overlay.find("render.width").get(width)) ...
+	//
+	// Like documents, an overlay can be queried by any number of threads concurrently
+	// as long as its layers are not changed at the same time. Copying an overlay is cheap.
+	//////////////////////////////////////////////////////////////////////////
+	class DocumentOverlay
+	{
+	public:
+		static constexpr uint32_t k_max_num_layers = OverlayValue::k_max_num_sources;
+		static constexpr uint32_t k_invalid_layer_index = 0xFFFFFFFFu;
+
+		DocumentOverlay() : m_layers(), m_layers_generation(0) {}
+
+		// Adds a layer on top of the others and returns its index, layer 0 is the bottom one.
+		// A null layer or one beyond k_max_num_layers is refused with k_invalid_layer_index.
+		inline uint32_t add_layer(std::shared_ptr<const Document> layer);
+
+		// Returns false if the document isn't a layer of this overlay
+		inline bool remove_layer(const Document* layer);
+		void clear() { m_layers.clear(); m_layers_generation++; }
+
+		uint32_t get_num_layers() const { return uint32_t(m_layers.size()); }
+		const std::shared_ptr<const Document>& get_layer(uint32_t layer_index) const { return m_layers[layer_index]; }
+
+		// The merged root object of every layer
+		inline OverlayValue get_root() const;
+
+		// Finds a value from the root with the same path syntax as Document::find(..)
+		OverlayValue find(const char* path) const { return get_root().find(path); }
+
+	private:
+		std::vector<std::shared_ptr<const Document>> m_layers;
+
+		// Incremented whenever the layers change, it invalidates the values found before
+		uint32_t m_layers_generation;
+
+		friend class OverlayValue;
+	};
+
+	//////////////////////////////////////////////////////////////////////////
+
+	inline OverlayValue::OverlayValue(const DocumentOverlay* overlay)
+		: m_overlay(overlay)
+		, m_layers_generation(overlay != nullptr ? overlay->m_layers_generation : 0)
+		, m_node_indices()
+		, m_source_layers()
+		, m_num_sources(0)
+	{}
+
+	inline bool OverlayValue::is_valid() const
+	{
+		return m_num_sources != 0 && m_layers_generation == m_overlay->m_layers_generation;
+	}
+
+	inline DocumentValue OverlayValue::get_source(uint32_t source_index) const
+	{
+		if (source_index >= m_num_sources || m_layers_generation != m_overlay->m_layers_generation)
+			return DocumentValue();
+
+		return m_overlay->get_layer(m_source_layers[source_index])->get_value(m_node_indices[source_index]);
+	}
+
+	inline bool OverlayValue::add_source(const DocumentValue& value, uint32_t layer_index)
+	{
+		if (m_num_sources == k_max_num_sources)
+			return false;
+
+		m_node_indices[m_num_sources] = value.get_index();
+		m_source_layers[m_num_sources] = uint8_t(layer_index);
+		m_num_sources++;
+		return true;
+	}
+
+	inline OverlayValue OverlayValue::find(const char* path) const
+	{
+		if (!is_valid())
+			return OverlayValue();
+
+		char separator = '.';
+		if (path[0] == '/')
+		{
+			separator = '/';
+			path++;
+		}
+
+		OverlayValue value = *this;
+		while (true)
+		{
+			const char* segment_end = path;
+			while (*segment_end != '\0' && *segment_end != separator)
+				segment_end++;
+
+			OverlayValue child(m_overlay);
+
+			if (value.get_type() == ValueType::Object)
+			{
+				// Every source of an object is an object, the first other type found below the
+				// top-most member replaces everything under it and is hidden by the members above
+				const StringView key(path, segment_end - path);
+				for (uint32_t source_index = 0; source_index < value.m_num_sources; ++source_index)
+				{
+					const DocumentValue member = value.get_source(source_index).find_member(key);
+					if (!member.is_valid())
+						continue;
+
+					if (member.get_type() != ValueType::Object)
+					{
+						if (!child.is_valid())
+							child.add_source(member, value.m_source_layers[source_index]);
+						break;
+					}
+
+					child.add_source(member, value.m_source_layers[source_index]);
+				}
+			}
+			else if (value.get_type() == ValueType::Array)
+			{
+				// Arrays are replaced as a whole, they have a single source
+				uint32_t element_index = 0;
+				if (!impl::parse_path_index(path, segment_end, element_index))
+					return OverlayValue();
+
+				const DocumentValue element = value.get_source(0).get_child(element_index);
+				if (element.is_valid())
+					child.add_source(element, value.m_source_layers[0]);
+			}
+
+			if (!child.is_valid() || *segment_end == '\0')
+				return child;
+
+			value = child;
+			path = segment_end + 1;
+		}
+	}
+
+	inline uint32_t DocumentOverlay::add_layer(std::shared_ptr<const Document> layer)
+	{
+		if (layer == nullptr || m_layers.size() >= k_max_num_layers)
+			return k_invalid_layer_index;
+
+		m_layers.push_back(std::move(layer));
+		m_layers_generation++;
+		return uint32_t(m_layers.size() - 1);
+	}
+
+	inline bool DocumentOverlay::remove_layer(const Document* layer)
+	{
+		auto it = std::find_if(m_layers.begin(), m_layers.end(), [layer](const std::shared_ptr<const Document>& entry) { return entry.get() == layer; });
+		if (it == m_layers.end())
+			return false;
+
+		m_layers.erase(it);
+		m_layers_generation++;
+		return true;
+	}
+
+	inline OverlayValue DocumentOverlay::get_root() const
+	{
+		OverlayValue root(this);
+		for (uint32_t layer_index = get_num_layers(); layer_index != 0; --layer_index)
+			root.add_source(m_layers[layer_index - 1]->get_root(), layer_index - 1);
+
+		return root;
+	}
+}
@@ -0,0 +1,190 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+// The MIT License (MIT)
+//
+// Copyright (c) 2018 Nicholas Frechette, Cody Jones, and sjson-cpp contributors
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "sjson/error.h"
+#include "sjson/parallel.h"
+#include "sjson/parser.h"
+#include "sjson/parser_dialect.h"
+#include "sjson/parser_error.h"
+#include "sjson/string_view.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+
+namespace sjson
+{
+	struct StreamDocument
+	{
+		StreamDocument()
+			: content()
+			, index(0)
+			, line(0)
+			, column(0)
+		{}
+
+		// The document as a parser of the stream dialect expects it: without the root
+		// braces for SJSON and with them for dialects that require root braces (e.g. JSON)
+		StringView content;
+
+		// The position of the document in the stream
+		uint32_t index;
+
+		// Where the opening brace of the document is in the input
+		uint32_t line;
+		uint32_t column;
+	};
+
+	//////////////////////////////////////////////////////////////////////////
+	// A document stream iterates over consecutive root objects in a single buffer:
+	//    { type = "load" time = 1.5 }
+	//    { type = "save" time = 2.0 }
+	//
+	// Each document must be enclosed in braces, even in SJSON. Comments and whitespace
+	// are allowed between documents. Document boundaries are found with the same bulk
+	// scan used to skip values: the content of a document is not validated until it is parsed.
+	//
+	// StreamDocument document;
+	// while (stream.read_next(document))
+	// {
+	//     Parser parser(document.content.c_str(), document.content.size());
+	//     ...
+	// }
+	// if (!stream.is_valid()) ...
+	//////////////////////////////////////////////////////////////////////////
+	template<class DialectType>
+	class BasicDocumentStream
+	{
+	public:
+		BasicDocumentStream(const char* input, size_t input_length)
+			: m_parser(input, input_length)
+			, m_num_documents(0)
+		{
+		}
+
+		// Returns false once the end of the input is reached or when an error is found
+		bool read_next(StreamDocument& document)
+		{
+			if (!m_parser.skip_comments_and_whitespace() || m_parser.eof())
+				return false;
+
+			uint32_t line;
+			uint32_t column;
+			m_parser.get_position(line, column);
+
+			StringView raw_document;
+			if (m_parser.peek_value_type() != ValueType::Object)
+			{
+				m_parser.report_error(ParserError::OpeningBraceExpected, line, column);
+				return false;
+			}
+
+			if (!m_parser.read_raw_value(raw_document))
+				return false;
+
+			if (DialectType::k_root_object_has_braces)
+				document.content = raw_document;
+			else
+				document.content = StringView(raw_document.c_str() + 1, raw_document.size() - 2);
+
+			document.index = m_num_documents++;
+			document.line = line;
+			document.column = column;
+			return true;
+		}
+
+		// Reads up to 'max_num_documents' documents and returns how many were read
+		uint32_t read_batch(StreamDocument* documents, uint32_t max_num_documents)
+		{
+			uint32_t num_documents = 0;
+			while (num_documents < max_num_documents && read_next(documents[num_documents]))
+				num_documents++;
+
+			return num_documents;
+		}
+
+		bool eof() { return m_parser.eof(); }
+
+		ParserError get_error() { return m_parser.get_error(); }
+		bool is_valid() const { return m_parser.is_valid(); }
+
+		uint32_t get_num_documents() const { return m_num_documents; }
+
+	private:
+		// Documents carry their own braces, the stream itself never has any
+		struct StreamDialect : DialectType
+		{
+			static constexpr bool k_root_object_has_braces = false;
+		};
+
+		BasicDocumentStream(const BasicDocumentStream&) = delete;
+		BasicDocumentStream& operator=(const BasicDocumentStream&) = delete;
+
+		BasicParser<StreamDialect> m_parser;
+		uint32_t m_num_documents;
+	};
+
+	// A stream of SJSON documents
+	using DocumentStream = BasicDocumentStream<SJSONDialect>;
+
+	// A stream of JSON documents, e.g. newline delimited JSON
+	using JSONDocumentStream = BasicDocumentStream<JSONDialect>;
+
+	//////////////////////////////////////////////////////////////////////////
+	// Calls 'function(document, result)' for every document on up to 'num_threads' threads,
+	// the calling thread included. Results are written in the same order as the documents
+	// regardless of which thread parsed them.
+	//
+	// StreamDocument documents[256];
+	// Event events[256];
+	// uint32_t num_documents;
+	// while ((num_documents = stream.read_batch(documents, 256)) != 0)
+	//     parse_documents_parallel(documents, num_documents, events, 4, parse_event);
+	//////////////////////////////////////////////////////////////////////////
+	template<typename ResultType, typename FunctionType>
+	inline void parse_documents_parallel(const StreamDocument* documents, uint32_t num_documents, ResultType* results, uint32_t num_threads, FunctionType function)
+	{
+		SJSON_CPP_ASSERT(num_threads != 0, "Invalid number of threads: %u", num_threads);
+
+		std::atomic<uint32_t> next_document_index(0);
+		auto worker = [&]()
+		{
+			while (true)
+			{
+				const uint32_t document_index = next_document_index.fetch_add(1, std::memory_order_relaxed);
+				if (document_index >= num_documents)
+					break;
+
+				function(documents[document_index], results[document_index]);
+			}
+		};
+
+		// Spawning threads isn't worth it when each of them would not have a document to parse
+		const uint32_t num_workers = std::min(num_threads, num_documents);
+
+		impl::run_workers(num_workers, worker);
+	}
+}
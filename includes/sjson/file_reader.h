@@ -0,0 +1,61 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+// The MIT License (MIT)
+//
+// Copyright (c) 2018 Nicholas Frechette, Cody Jones, and sjson-cpp contributors
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace sjson
+{
+	namespace impl
+	{
+		// Reads a whole file into a buffer that can be reused from file to file, it only grows.
+		// The content is followed by 'padding' + 1 NUL bytes.
+		inline bool read_file_into(const char* path, std::vector<char>& buffer, size_t padding, size_t& out_file_size)
+		{
+			std::FILE* file = std::fopen(path, "rb");
+			if (file == nullptr)
+				return false;
+
+			bool is_valid = std::fseek(file, 0, SEEK_END) == 0;
+			const long file_size = is_valid ? std::ftell(file) : -1;
+			is_valid = file_size >= 0 && std::fseek(file, 0, SEEK_SET) == 0;
+
+			if (is_valid)
+			{
+				out_file_size = size_t(file_size);
+				if (buffer.size() < out_file_size + padding + 1)
+					buffer.resize(out_file_size + padding + 1);
+
+				is_valid = file_size == 0 || std::fread(buffer.data(), 1, out_file_size, file) == out_file_size;
+				std::memset(buffer.data() + out_file_size, 0, padding + 1);
+			}
+
+			std::fclose(file);
+			return is_valid;
+		}
+	}
+}
@@ -0,0 +1,247 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+// The MIT License (MIT)
+//
+// Copyright (c) 2018 Nicholas Frechette, Cody Jones, and sjson-cpp contributors
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "sjson/error.h"
+#include "sjson/parser.h"
+#include "sjson/parser_state.h"
+#include "sjson/path_query.h"
+#include "sjson/string_view.h"
+
+#include <cstdint>
+
+namespace sjson
+{
+	namespace impl
+	{
+		// 64 bit FNV-1a
+		constexpr uint64_t k_fingerprint_offset_basis = 0xCBF29CE484222325ull;
+		constexpr uint64_t k_fingerprint_prime = 0x00000100000001B3ull;
+
+		inline uint64_t hash_fingerprint_bytes(uint64_t hash, const void* data, size_t size)
+		{
+			const uint8_t* bytes = static_cast<const uint8_t*>(data);
+			for (size_t byte_index = 0; byte_index < size; ++byte_index)
+				hash = (hash ^ bytes[byte_index]) * k_fingerprint_prime;
+
+			return hash;
+		}
+
+		inline uint64_t hash_fingerprint_value(uint64_t hash, uint64_t value)
+		{
+			for (uint32_t byte_index = 0; byte_index < 8; ++byte_index)
+				hash = (hash ^ ((value >> (byte_index * 8)) & 0xFF)) * k_fingerprint_prime;
+
+			return hash;
+		}
+
+		// Sizes are hashed along with the content so that adjacent tokens cannot alias
+		inline uint64_t hash_fingerprint_token(uint64_t hash, const StringView& token)
+		{
+			hash = hash_fingerprint_value(hash, token.size());
+			return hash_fingerprint_bytes(hash, token.c_str(), token.size());
+		}
+
+		template<class DialectType>
+		inline bool read_fingerprint_value(BasicParser<DialectType>& parser, uint64_t& out_fingerprint);
+
+		template<class DialectType>
+		inline bool read_fingerprint_members(BasicParser<DialectType>& parser, bool is_root, uint64_t& out_fingerprint)
+		{
+			uint64_t hash = hash_fingerprint_value(k_fingerprint_offset_basis, uint64_t(ValueType::Object));
+			StringView key;
+
+			while (true)
+			{
+				if (is_root)
+				{
+					if (!parser.skip_comments_and_whitespace())
+						return false;
+
+					if (parser.is_root_object_end())
+						break;
+				}
+				else if (parser.try_object_ends())
+					break;
+
+				uint64_t member_fingerprint;
+				if (!parser.read_next_key(key) || !read_fingerprint_value(parser, member_fingerprint))
+					return false;
+
+				hash = hash_fingerprint_token(hash, key);
+				hash = hash_fingerprint_value(hash, member_fingerprint);
+			}
+
+			out_fingerprint = hash;
+			return true;
+		}
+
+		template<class DialectType>
+		inline bool read_fingerprint_elements(BasicParser<DialectType>& parser, uint64_t& out_fingerprint)
+		{
+			if (!parser.array_begins())
+				return false;
+
+			uint64_t hash = hash_fingerprint_value(k_fingerprint_offset_basis, uint64_t(ValueType::Array));
+			for (uint32_t element_index = 0; !parser.try_array_ends(); ++element_index)
+			{
+				uint64_t element_fingerprint;
+				if ((element_index != 0 && !parser.read_array_separator()) || !read_fingerprint_value(parser, element_fingerprint))
+					return false;
+
+				hash = hash_fingerprint_value(hash, element_fingerprint);
+			}
+
+			out_fingerprint = hash;
+			return true;
+		}
+
+		template<class DialectType>
+		inline bool read_fingerprint_value(BasicParser<DialectType>& parser, uint64_t& out_fingerprint)
+		{
+			const ValueType type = parser.peek_value_type();
+			if (type == ValueType::Object)
+				return parser.object_begins() && read_fingerprint_members(parser, false, out_fingerprint);
+
+			if (type == ValueType::Array)
+				return read_fingerprint_elements(parser, out_fingerprint);
+
+			StringView raw_value;
+			if (!parser.read_raw_value(raw_value))
+				return false;
+
+			out_fingerprint = hash_fingerprint_token(hash_fingerprint_value(k_fingerprint_offset_basis, uint64_t(type)), raw_value);
+			return true;
+		}
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+	// Fingerprints are 64 bit hashes of values used to detect changes without comparing them.
+	// Only tokens are hashed, whitespace, comments, and separators do not change a fingerprint
+	// which is also the same whether the value is written in SJSON or JSON.
+	// Objects and arrays are hashed from the fingerprints of their members (Merkle style),
+	// keys and elements are hashed in order and scalars are hashed by their raw text: 1.0 and 1 differ.
+	//////////////////////////////////////////////////////////////////////////
+
+	// Reads the next value and computes its fingerprint
+	template<class DialectType>
+	inline bool read_fingerprint(BasicParser<DialectType>& parser, uint64_t& out_fingerprint)
+	{
+		return impl::read_fingerprint_value(parser, out_fingerprint);
+	}
+
+	// Reads the whole input from its root and computes its fingerprint
+	template<class DialectType>
+	inline bool read_document_fingerprint(BasicParser<DialectType>& parser, uint64_t& out_fingerprint)
+	{
+		return impl::read_fingerprint_members(parser, true, out_fingerprint) && parser.remainder_is_comments_and_whitespace();
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+	// Computes the fingerprints of the values of one or more paths.
+	// The values are found with a PathQuery, see it for the path syntax, and only their
+	// subtrees are hashed, the rest of the input is skipped in bulk.
+	//
+	// const char* paths[] = { "meshes.hero", "materials" };
+	// SubtreeFingerprints fingerprints(paths, 2);
+	// if (fingerprints.evaluate(parser) && fingerprints.get_fingerprint(0) != cached_fingerprint)
+	//     rebuild_hero_mesh();
+	//
+	// Paths are not copied and must outlive the fingerprints.
+	//////////////////////////////////////////////////////////////////////////
+	class SubtreeFingerprints
+	{
+	public:
+		static constexpr uint32_t k_max_num_paths = PathQuery::k_max_num_paths;
+
+		inline SubtreeFingerprints(const char* const* paths, uint32_t num_paths);
+
+		// Evaluates the paths starting at the current parser position, like PathQuery::evaluate(..)
+		template<class DialectType>
+		inline bool evaluate(BasicParser<DialectType>& parser);
+
+		uint32_t get_num_paths() const { return m_query.get_num_paths(); }
+
+		bool is_found(uint32_t path_index) const { return m_query.get_result(path_index).is_found; }
+		uint64_t get_fingerprint(uint32_t path_index) const { return m_fingerprints[path_index]; }
+
+		// Returns the result of the query which holds the raw value and position of every path
+		const PathQueryResult& get_result(uint32_t path_index) const { return m_query.get_result(path_index); }
+
+	private:
+		SubtreeFingerprints(const SubtreeFingerprints&) = delete;
+		SubtreeFingerprints& operator=(const SubtreeFingerprints&) = delete;
+
+		// A value is read on its own, its braces belong to it and never to a root object.
+		// It is a slice of the input, only the input as a whole is followed by padding.
+		template<class DialectType>
+		struct ValueDialect : DialectType
+		{
+			static constexpr bool k_root_object_has_braces = false;
+			static constexpr bool k_input_is_padded = false;
+		};
+
+		PathQuery m_query;
+		uint64_t m_fingerprints[k_max_num_paths];
+	};
+
+	//////////////////////////////////////////////////////////////////////////
+
+	inline SubtreeFingerprints::SubtreeFingerprints(const char* const* paths, uint32_t num_paths)
+		: m_query(paths, num_paths)
+		, m_fingerprints()
+	{}
+
+	template<class DialectType>
+	inline bool SubtreeFingerprints::evaluate(BasicParser<DialectType>& parser)
+	{
+		if (!m_query.evaluate(parser))
+			return false;
+
+		const uint32_t num_paths = m_query.get_num_paths();
+		for (uint32_t path_index = 0; path_index < num_paths; ++path_index)
+		{
+			m_fingerprints[path_index] = 0;
+
+			const PathQueryResult& result = m_query.get_result(path_index);
+			if (!result.is_found)
+				continue;
+
+			// Objects and arrays are skipped in bulk by the query, their content is validated here
+			// with the dialect of the input, e.g. JSON members use ':' as their separator
+			BasicParser<ValueDialect<DialectType>> value_parser(result.raw_value.c_str(), result.raw_value.size());
+			if (!impl::read_fingerprint_value(value_parser, m_fingerprints[path_index]))
+			{
+				const ParserError value_error = value_parser.get_error();
+				const uint32_t line = result.line + value_error.line - 1;
+				const uint32_t column = value_error.line == 1 ? (result.column + value_error.column - 1) : value_error.column;
+				parser.report_error(value_error.error, line, column);
+				return false;
+			}
+		}
+
+		return true;
+	}
+}
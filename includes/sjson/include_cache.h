@@ -0,0 +1,603 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+// The MIT License (MIT)
+//
+// Copyright (c) 2018 Nicholas Frechette, Cody Jones, and sjson-cpp contributors
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "sjson/document.h"
+#include "sjson/error.h"
+#include "sjson/file_reader.h"
+#include "sjson/parallel.h"
+#include "sjson/parser_dialect.h"
+#include "sjson/parser_error.h"
+#include "sjson/string_view.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace sjson
+{
+	class IncludeCache;
+	class IncludedFile;
+
+	//////////////////////////////////////////////////////////////////////////
+	// Where and why loading a file and its includes failed.
+	// The line and column are relative to the file in 'path'. A file that cannot be read
+	// is reported at the include that references it, unless it is the file being loaded.
+	//////////////////////////////////////////////////////////////////////////
+	struct IncludeError : public ParserError
+	{
+		IncludeError() : ParserError(), path() {}
+
+		std::string path;
+	};
+
+	//////////////////////////////////////////////////////////////////////////
+	// A value within a file loaded by an include cache. Includes are followed transparently:
+	// the value of an include is the root object of the file it names.
+	// It is only valid for as long as the file it came from is alive.
+	//////////////////////////////////////////////////////////////////////////
+	class IncludeValue
+	{
+	public:
+		IncludeValue() : m_file(nullptr), m_value() {}
+
+		// Returns false when the value was not found
+		bool is_valid() const { return m_value.is_valid(); }
+
+		ValueType get_type() const { return m_value.get_type(); }
+
+		// The value in the document of the file that holds it, for its raw value and location
+		DocumentValue get_value() const { return m_value; }
+		const IncludedFile* get_file() const { return m_file; }
+
+		uint32_t get_num_children() const { return m_value.get_num_children(); }
+		inline IncludeValue get_child(uint32_t child_index) const;
+
+		// Finds a value relative to this one with the same path syntax as Document::find(..),
+		// paths can cross into included files
+		inline IncludeValue find(const char* path) const;
+
+		template<typename DataType>
+		bool get(DataType& value) const { return m_value.get(value); }
+
+	private:
+		inline IncludeValue(const IncludedFile* file, const DocumentValue& value);
+
+		const IncludedFile* m_file;
+		DocumentValue m_value;
+
+		friend class IncludedFile;
+	};
+
+	//////////////////////////////////////////////////////////////////////////
+	// A file loaded by an include cache along with the files it includes.
+	// Like documents, files are immutable and can be queried concurrently without locks.
+	//////////////////////////////////////////////////////////////////////////
+	class IncludedFile
+	{
+	public:
+		const std::string& get_path() const { return m_path; }
+		const std::shared_ptr<const Document>& get_document() const { return m_document; }
+
+		IncludeValue get_root() const { return IncludeValue(this, m_document->get_root()); }
+		IncludeValue find(const char* path) const { return get_root().find(path); }
+
+		// The files directly included by this one, in the order they appear
+		uint32_t get_num_includes() const { return uint32_t(m_includes.size()); }
+		const IncludedFile* get_include(uint32_t include_index) const { return m_includes[include_index].file.get(); }
+
+	private:
+		struct Include
+		{
+			uint32_t value_index;
+			std::shared_ptr<const IncludedFile> file;
+		};
+
+		IncludedFile() : m_path(), m_document(), m_includes() {}
+
+		IncludedFile(const IncludedFile&) = delete;
+		IncludedFile& operator=(const IncludedFile&) = delete;
+
+		inline const IncludedFile* find_include(uint32_t value_index) const;
+
+		std::string m_path;
+		std::shared_ptr<const Document> m_document;
+
+		// Sorted by value index
+		std::vector<Include> m_includes;
+
+		friend class IncludeCache;
+		friend class IncludeValue;
+	};
+
+	//////////////////////////////////////////////////////////////////////////
+	// Loads files that include other files and caches every file it loads by path:
+	// a file shared by several others is read and parsed only once per cache.
+	//
+	// An include is an object with a single 'include' member that holds a path, relative
+	// to the including file unless it is absolute:
+	//    render = { include = "render.sjson" }
+	// Paths are normalized: '.' and '..' are collapsed and separators become '/'.
+	//
+	// The files are loaded one level of includes at a time, the files of a level are read
+	// and parsed concurrently on up to 'num_threads' threads, the calling thread included.
+	// Files that include themselves, directly or not, fail with IncludeCycle.
+	//
+	// IncludeCache cache(4);
+	// IncludeError error;
+	// std::shared_ptr<const IncludedFile> config = cache.load("config.sjson", &error);
+	// uint32_t width;
+	// if (config && config->find("render.width").get(width)) ...
+	//
+	// Loads are serialized, the files returned can be queried from any thread.
+	// Like documents, loading files allocates memory.
+	//////////////////////////////////////////////////////////////////////////
+	class IncludeCache
+	{
+	public:
+		explicit IncludeCache(uint32_t num_threads = 1)
+			: m_mutex()
+			, m_files()
+			, m_num_threads(num_threads)
+		{
+			SJSON_CPP_ASSERT(num_threads != 0, "Invalid number of threads: %u", num_threads);
+		}
+
+		// Returns null if the file or one of its includes cannot be loaded, the reason is written to 'out_error' when provided.
+		// Nothing is cached when a load fails.
+		template<class DialectType = SJSONDialect>
+		inline std::shared_ptr<const IncludedFile> load(const char* path, IncludeError* out_error = nullptr);
+
+		inline uint32_t get_num_files() const;
+
+		// Files already returned remain valid
+		inline void clear();
+
+	private:
+		struct PendingInclude
+		{
+			uint32_t value_index;
+			std::string path;
+
+			// Either a file already in the cache or a file loaded along with this one
+			std::shared_ptr<const IncludedFile> cached_file;
+			uint32_t pending_index;
+		};
+
+		struct PendingFile
+		{
+			std::string path;
+			std::shared_ptr<const Document> document;
+			std::vector<PendingInclude> includes;
+			ParserError error;
+
+			// The file that includes this one first, the file being loaded has none
+			uint32_t parent_index;
+			uint32_t parent_value_index;
+		};
+
+		static constexpr uint32_t k_invalid_index = 0xFFFFFFFFU;
+
+		IncludeCache(const IncludeCache&) = delete;
+		IncludeCache& operator=(const IncludeCache&) = delete;
+
+		template<class DialectType>
+		inline void parse_files(std::vector<PendingFile>& files, uint32_t first_file_index, uint32_t num_files) const;
+
+		static inline void find_includes(PendingFile& file);
+		static inline bool find_cycle(std::vector<PendingFile>& files, uint32_t file_index, std::vector<uint8_t>& states, std::vector<uint32_t>& sorted_indices, IncludeError* out_error);
+		static inline void set_error(const PendingFile& file, uint32_t value_index, uint32_t error, IncludeError* out_error);
+
+		mutable std::mutex m_mutex;
+		std::unordered_map<std::string, std::shared_ptr<const IncludedFile>> m_files;
+		uint32_t m_num_threads;
+	};
+
+	//////////////////////////////////////////////////////////////////////////
+
+	namespace impl
+	{
+		constexpr const char* k_include_key = "include";
+
+		// Returns true if the value is an include and writes the path it holds
+		inline bool get_include_path(const DocumentValue& value, StringView& out_path)
+		{
+			if (value.get_type() != ValueType::Object || value.get_num_children() != 1)
+				return false;
+
+			const DocumentValue member = value.get_child(0);
+			return member.get_key() == k_include_key && member.get(out_path);
+		}
+
+		// Collapses '.' and '..' segments along with repeated separators and turns every separator into '/'.
+		// Every file then has a single path, it is cached once and cycles through aliases are found.
+		inline std::string normalize_include_path(const std::string& path)
+		{
+			std::string normalized_path;
+			size_t offset = 0;
+
+			// A drive and a root separator are kept, '..' cannot go above them
+			if (path.size() >= 2 && path[1] == ':')
+			{
+				normalized_path.append(path, 0, 2);
+				offset = 2;
+			}
+
+			const bool is_absolute = offset < path.size() && (path[offset] == '/' || path[offset] == '\\');
+			if (is_absolute)
+				normalized_path.push_back('/');
+
+			const size_t root_length = normalized_path.size();
+
+			while (offset < path.size())
+			{
+				size_t segment_end = path.find_first_of("/\\", offset);
+				if (segment_end == std::string::npos)
+					segment_end = path.size();
+
+				const size_t segment_length = segment_end - offset;
+				const bool is_current = segment_length == 1 && path[offset] == '.';
+				const bool is_parent = segment_length == 2 && path[offset] == '.' && path[offset + 1] == '.';
+
+				// The last segment can only be removed when there is one and it isn't a leading '..' itself
+				size_t last_segment_offset = normalized_path.find_last_of('/');
+				last_segment_offset = last_segment_offset == std::string::npos || last_segment_offset < root_length ? root_length : last_segment_offset + 1;
+				const bool has_last_segment = normalized_path.size() > root_length && normalized_path.compare(last_segment_offset, std::string::npos, "..") != 0;
+
+				if (segment_length == 0 || is_current)
+				{
+					// Repeated separators and '.' do not change the path
+				}
+				else if (is_parent && has_last_segment)
+					normalized_path.resize(last_segment_offset == root_length ? root_length : last_segment_offset - 1);
+				else if (is_parent && is_absolute)
+				{
+					// Nothing is above the root
+				}
+				else
+				{
+					if (normalized_path.size() > root_length)
+						normalized_path.push_back('/');
+
+					normalized_path.append(path, offset, segment_length);
+				}
+
+				offset = segment_end + 1;
+			}
+
+			if (normalized_path.empty())
+				normalized_path.push_back('.');
+
+			return normalized_path;
+		}
+
+		// Resolves an include path relative to the directory of the file that includes it
+		inline std::string resolve_include_path(const std::string& including_path, const StringView& path)
+		{
+			const bool is_absolute = (path.size() >= 1 && (path[0] == '/' || path[0] == '\\')) || (path.size() >= 2 && path[1] == ':');
+			const size_t separator_offset = including_path.find_last_of("/\\");
+			if (is_absolute || separator_offset == std::string::npos)
+				return normalize_include_path(std::string(path.c_str(), path.size()));
+
+			std::string resolved_path(including_path, 0, separator_offset + 1);
+			resolved_path.append(path.c_str(), path.size());
+			return normalize_include_path(resolved_path);
+		}
+	}
+
+	inline IncludeValue::IncludeValue(const IncludedFile* file, const DocumentValue& value)
+		: m_file(file)
+		, m_value(value)
+	{
+		// An included file can itself be made of a single include
+		while (m_value.is_valid())
+		{
+			const IncludedFile* included_file = m_file->find_include(m_value.get_index());
+			if (included_file == nullptr)
+				break;
+
+			m_file = included_file;
+			m_value = included_file->m_document->get_root();
+		}
+	}
+
+	inline IncludeValue IncludeValue::get_child(uint32_t child_index) const
+	{
+		const DocumentValue child = m_value.get_child(child_index);
+		return child.is_valid() ? IncludeValue(m_file, child) : IncludeValue();
+	}
+
+	inline IncludeValue IncludeValue::find(const char* path) const
+	{
+		if (!is_valid())
+			return IncludeValue();
+
+		char separator = '.';
+		if (path[0] == '/')
+		{
+			separator = '/';
+			path++;
+		}
+
+		IncludeValue value = *this;
+		while (true)
+		{
+			const char* segment_end = path;
+			while (*segment_end != '\0' && *segment_end != separator)
+				segment_end++;
+
+			DocumentValue child;
+			if (value.get_type() == ValueType::Object)
+				child = value.m_value.find_member(StringView(path, segment_end - path));
+			else if (value.get_type() == ValueType::Array)
+			{
+				uint32_t element_index = 0;
+				if (impl::parse_path_index(path, segment_end, element_index))
+					child = value.m_value.get_child(element_index);
+			}
+
+			if (!child.is_valid())
+				return IncludeValue();
+
+			value = IncludeValue(value.m_file, child);
+
+			if (*segment_end == '\0')
+				return value;
+
+			path = segment_end + 1;
+		}
+	}
+
+	inline const IncludedFile* IncludedFile::find_include(uint32_t value_index) const
+	{
+		auto it = std::lower_bound(m_includes.begin(), m_includes.end(), value_index, [](const Include& include, uint32_t index) { return include.value_index < index; });
+		return it != m_includes.end() && it->value_index == value_index ? it->file.get() : nullptr;
+	}
+
+	template<class DialectType>
+	inline std::shared_ptr<const IncludedFile> IncludeCache::load(const char* path, IncludeError* out_error)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		if (out_error != nullptr)
+			*out_error = IncludeError();
+
+		// Files are cached by their normalized path, every alias of a file finds it
+		std::string normalized_path = impl::normalize_include_path(path);
+		auto cached_it = m_files.find(normalized_path);
+		if (cached_it != m_files.end())
+			return cached_it->second;
+
+		std::vector<PendingFile> files;
+		std::unordered_map<std::string, uint32_t> file_indices;
+
+		files.push_back(PendingFile());
+		files[0].path = std::move(normalized_path);
+		files[0].parent_index = k_invalid_index;
+		files[0].parent_value_index = 0;
+		file_indices[files[0].path] = 0;
+
+		// Every level of includes is loaded concurrently, new includes make up the next level
+		uint32_t first_file_index = 0;
+		while (first_file_index < files.size())
+		{
+			const uint32_t num_files = uint32_t(files.size()) - first_file_index;
+			parse_files<DialectType>(files, first_file_index, num_files);
+
+			const uint32_t end_file_index = first_file_index + num_files;
+			for (uint32_t file_index = first_file_index; file_index < end_file_index; ++file_index)
+			{
+				if (files[file_index].document)
+					continue;
+
+				const PendingFile& file = files[file_index];
+				if (file.error.error == ParserError::FileCouldNotBeRead && file.parent_index != k_invalid_index)
+					set_error(files[file.parent_index], file.parent_value_index, ParserError::FileCouldNotBeRead, out_error);
+				else if (out_error != nullptr)
+				{
+					static_cast<ParserError&>(*out_error) = file.error;
+					out_error->path = file.path;
+				}
+
+				return nullptr;
+			}
+
+			for (uint32_t file_index = first_file_index; file_index < end_file_index; ++file_index)
+			{
+				// Adding files can move the includes, they are accessed by index
+				const uint32_t num_includes = uint32_t(files[file_index].includes.size());
+				for (uint32_t include_index = 0; include_index < num_includes; ++include_index)
+				{
+					PendingInclude& include = files[file_index].includes[include_index];
+					auto include_cached_it = m_files.find(include.path);
+					if (include_cached_it != m_files.end())
+					{
+						include.cached_file = include_cached_it->second;
+						continue;
+					}
+
+					auto include_index_it = file_indices.find(include.path);
+					if (include_index_it != file_indices.end())
+					{
+						include.pending_index = include_index_it->second;
+						continue;
+					}
+
+					const uint32_t included_file_index = uint32_t(files.size());
+					include.pending_index = included_file_index;
+					file_indices[include.path] = included_file_index;
+
+					PendingFile included_file;
+					included_file.path = include.path;
+					included_file.parent_index = file_index;
+					included_file.parent_value_index = include.value_index;
+					files.push_back(std::move(included_file));
+				}
+			}
+
+			first_file_index = end_file_index;
+		}
+
+		// Cached files never include the new ones, a cycle can only go through new files
+		std::vector<uint8_t> states(files.size(), 0);
+		std::vector<uint32_t> sorted_indices;
+		sorted_indices.reserve(files.size());
+		if (find_cycle(files, 0, states, sorted_indices, out_error))
+			return nullptr;
+
+		// Files are sorted so that the files they include come first
+		std::vector<std::shared_ptr<const IncludedFile>> loaded_files(files.size());
+		for (const uint32_t file_index : sorted_indices)
+		{
+			PendingFile& file = files[file_index];
+
+			std::shared_ptr<IncludedFile> loaded_file(new IncludedFile());
+			loaded_file->m_path = file.path;
+			loaded_file->m_document = std::move(file.document);
+			loaded_file->m_includes.reserve(file.includes.size());
+
+			for (const PendingInclude& include : file.includes)
+			{
+				IncludedFile::Include loaded_include;
+				loaded_include.value_index = include.value_index;
+				loaded_include.file = include.cached_file ? include.cached_file : loaded_files[include.pending_index];
+				loaded_file->m_includes.push_back(std::move(loaded_include));
+			}
+
+			m_files[file.path] = loaded_file;
+			loaded_files[file_index] = std::move(loaded_file);
+		}
+
+		return loaded_files[0];
+	}
+
+	inline uint32_t IncludeCache::get_num_files() const
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		return uint32_t(m_files.size());
+	}
+
+	inline void IncludeCache::clear()
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_files.clear();
+	}
+
+	template<class DialectType>
+	inline void IncludeCache::parse_files(std::vector<PendingFile>& files, uint32_t first_file_index, uint32_t num_files) const
+	{
+		std::atomic<uint32_t> next_file_index(0);
+
+		auto worker = [&]()
+		{
+			std::vector<char> buffer;
+
+			while (true)
+			{
+				const uint32_t file_index = next_file_index.fetch_add(1, std::memory_order_relaxed);
+				if (file_index >= num_files)
+					break;
+
+				PendingFile& file = files[first_file_index + file_index];
+
+				size_t file_size = 0;
+				if (!impl::read_file_into(file.path.c_str(), buffer, 0, file_size))
+				{
+					file.error.error = ParserError::FileCouldNotBeRead;
+					continue;
+				}
+
+				file.document = Document::parse<DialectType>(buffer.data(), file_size, &file.error);
+				if (file.document)
+					find_includes(file);
+			}
+		};
+
+		impl::run_workers(std::min(m_num_threads, num_files), worker);
+	}
+
+	inline void IncludeCache::find_includes(PendingFile& file)
+	{
+		const Document& document = *file.document;
+		const uint32_t num_values = document.get_num_values();
+
+		StringView include_path;
+		for (uint32_t value_index = 0; value_index < num_values; ++value_index)
+		{
+			if (!impl::get_include_path(document.get_value(value_index), include_path))
+				continue;
+
+			PendingInclude include;
+			include.value_index = value_index;
+			include.path = impl::resolve_include_path(file.path, include_path);
+			include.pending_index = k_invalid_index;
+			file.includes.push_back(std::move(include));
+		}
+	}
+
+	inline bool IncludeCache::find_cycle(std::vector<PendingFile>& files, uint32_t file_index, std::vector<uint8_t>& states, std::vector<uint32_t>& sorted_indices, IncludeError* out_error)
+	{
+		enum : uint8_t { k_unvisited, k_visiting, k_visited };
+
+		states[file_index] = k_visiting;
+
+		for (const PendingInclude& include : files[file_index].includes)
+		{
+			if (include.cached_file)
+				continue;
+
+			const uint8_t include_state = states[include.pending_index];
+			if (include_state == k_visiting)
+			{
+				set_error(files[file_index], include.value_index, ParserError::IncludeCycle, out_error);
+				return true;
+			}
+
+			if (include_state == k_unvisited && find_cycle(files, include.pending_index, states, sorted_indices, out_error))
+				return true;
+		}
+
+		states[file_index] = k_visited;
+		sorted_indices.push_back(file_index);
+		return false;
+	}
+
+	inline void IncludeCache::set_error(const PendingFile& file, uint32_t value_index, uint32_t error, IncludeError* out_error)
+	{
+		if (out_error == nullptr)
+			return;
+
+		const DocumentValue value = file.document->get_value(value_index);
+		out_error->error = error;
+		out_error->line = value.get_line();
+		out_error->column = value.get_column();
+		out_error->path = file.path;
+	}
+}
@@ -0,0 +1,598 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+// The MIT License (MIT)
+//
+// Copyright (c) 2018 Nicholas Frechette, Cody Jones, and sjson-cpp contributors
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "sjson/base64.h"
+#include "sjson/error.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+//////////////////////////////////////////////////////////////////////////
+// Scanning kernels with runtime CPU dispatch.
+//
+// The parser spends most of its time looking for the next symbol of interest: the end of
+// a string, or the next brace, bracket, or quotation mark when skipping a container.
+// These scans have a scalar implementation along with SSE4.2, AVX2, and AVX-512 variants.
+// Binary values are encoded and decoded as base64 with the same dispatch, the AVX-512 set
+// uses the AVX2 codec.
+// The best variant supported by the CPU is selected once, the first time a kernel is needed,
+// which allows a single binary to run on every x86 CPU.
+//
+// Vector variants are compiled with function level target attributes and they do not
+// require any compiler flag. Define SJSON_CPP_NO_SIMD_KERNELS to only use the scalar variant.
+//////////////////////////////////////////////////////////////////////////
+
+#if !defined(SJSON_CPP_NO_SIMD_KERNELS) && (defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86))
+	#define SJSON_CPP_X86_KERNELS
+#endif
+
+#if defined(SJSON_CPP_X86_KERNELS)
+	#if defined(_MSC_VER) && !defined(__clang__)
+		#include <intrin.h>
+
+		#define SJSON_CPP_TARGET_SSE42
+		#define SJSON_CPP_TARGET_AVX2
+		#define SJSON_CPP_TARGET_AVX512
+	#else
+		#include <cpuid.h>
+
+		#define SJSON_CPP_TARGET_SSE42 __attribute__((target("sse4.2")))
+		#define SJSON_CPP_TARGET_AVX2 __attribute__((target("avx2")))
+		#define SJSON_CPP_TARGET_AVX512 __attribute__((target("avx512f,avx512bw")))
+	#endif
+
+	#include <immintrin.h>
+#endif
+
+namespace sjson
+{
+	enum class KernelSet : uint32_t
+	{
+		Scalar,
+		SSE42,
+		AVX2,
+		AVX512,
+	};
+
+	inline const char* get_kernel_set_name(KernelSet kernel_set)
+	{
+		switch (kernel_set)
+		{
+		case KernelSet::Scalar:
+			return "Scalar";
+		case KernelSet::SSE42:
+			return "SSE4.2";
+		case KernelSet::AVX2:
+			return "AVX2";
+		case KernelSet::AVX512:
+			return "AVX-512";
+		default:
+			return "Unknown";
+		}
+	}
+
+	namespace impl
+	{
+		//////////////////////////////////////////////////////////////////////////
+		// A small set of symbols to scan for
+		//////////////////////////////////////////////////////////////////////////
+		class SymbolSet
+		{
+		public:
+			static constexpr uint32_t k_max_num_symbols = 16;
+
+			explicit SymbolSet(const char* symbols)
+				: m_num_symbols(uint32_t(std::strlen(symbols)))
+			{
+				SJSON_CPP_ASSERT(m_num_symbols != 0 && m_num_symbols <= k_max_num_symbols, "Invalid number of symbols: %u", m_num_symbols);
+
+				std::memset(m_symbols, 0, sizeof(m_symbols));
+				std::memset(m_is_member, 0, sizeof(m_is_member));
+
+				for (uint32_t symbol_index = 0; symbol_index < m_num_symbols; ++symbol_index)
+				{
+					m_symbols[symbol_index] = symbols[symbol_index];
+					m_is_member[uint8_t(symbols[symbol_index])] = true;
+				}
+			}
+
+			bool contains(char symbol) const { return m_is_member[uint8_t(symbol)]; }
+
+			const char* get_symbols() const { return m_symbols; }
+			uint32_t get_num_symbols() const { return m_num_symbols; }
+
+		private:
+			alignas(16) char m_symbols[k_max_num_symbols];
+			bool m_is_member[256];
+			uint32_t m_num_symbols;
+		};
+
+		// Returns the offset of the first symbol of the set found in [offset, input_length) or input_length if there is none.
+		// Vector variants can read up to 'readable_length' which must be at least 'input_length', the bytes
+		// in between must not contain any symbol of the set (e.g. NUL padding).
+		using FindAnyOfFunction = size_t(*)(const char* input, size_t offset, size_t input_length, size_t readable_length, const SymbolSet& symbols);
+
+		// See encode_base64_scalar(..) and decode_base64_scalar(..)
+		using EncodeBase64Function = size_t(*)(const uint8_t* input, size_t size, char* output);
+		using DecodeBase64Function = Base64Result(*)(const char* input, size_t input_length, uint8_t* output, size_t output_size, size_t& out_num_symbols, size_t& out_size);
+
+		struct Kernels
+		{
+			KernelSet kernel_set;
+			FindAnyOfFunction find_any_of;
+			EncodeBase64Function encode_base64;
+			DecodeBase64Function decode_base64;
+		};
+
+		inline size_t find_any_of_scalar(const char* input, size_t offset, size_t input_length, size_t readable_length, const SymbolSet& symbols)
+		{
+			(void)readable_length;
+
+			while (offset < input_length && !symbols.contains(input[offset]))
+				offset++;
+
+			return offset < input_length ? offset : input_length;
+		}
+
+#if defined(SJSON_CPP_X86_KERNELS)
+		inline uint32_t count_trailing_zeros(uint64_t value)
+		{
+#if defined(_MSC_VER) && !defined(__clang__) && defined(_M_X64)
+			unsigned long index;
+			_BitScanForward64(&index, value);
+			return uint32_t(index);
+#elif defined(_MSC_VER) && !defined(__clang__)
+			unsigned long index;
+			if (_BitScanForward(&index, uint32_t(value)))
+				return uint32_t(index);
+
+			_BitScanForward(&index, uint32_t(value >> 32));
+			return uint32_t(index) + 32;
+#else
+			return uint32_t(__builtin_ctzll(value));
+#endif
+		}
+
+		SJSON_CPP_TARGET_SSE42 inline size_t find_any_of_sse42(const char* input, size_t offset, size_t input_length, size_t readable_length, const SymbolSet& symbols)
+		{
+			const __m128i symbols_v = _mm_load_si128(reinterpret_cast<const __m128i*>(symbols.get_symbols()));
+			const int num_symbols = int(symbols.get_num_symbols());
+
+			for (; offset < input_length && offset + 16 <= readable_length; offset += 16)
+			{
+				const __m128i input_v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + offset));
+				const int index = _mm_cmpestri(symbols_v, num_symbols, input_v, 16, _SIDD_UBYTE_OPS | _SIDD_CMP_EQUAL_ANY | _SIDD_LEAST_SIGNIFICANT);
+				if (index != 16)
+					return offset + index < input_length ? offset + index : input_length;
+			}
+
+			return find_any_of_scalar(input, offset, input_length, readable_length, symbols);
+		}
+
+		SJSON_CPP_TARGET_AVX2 inline size_t find_any_of_avx2(const char* input, size_t offset, size_t input_length, size_t readable_length, const SymbolSet& symbols)
+		{
+			const char* symbol_values = symbols.get_symbols();
+			const uint32_t num_symbols = symbols.get_num_symbols();
+
+			__m256i symbols_v[SymbolSet::k_max_num_symbols];
+			for (uint32_t symbol_index = 0; symbol_index < num_symbols; ++symbol_index)
+				symbols_v[symbol_index] = _mm256_set1_epi8(symbol_values[symbol_index]);
+
+			for (; offset < input_length && offset + 32 <= readable_length; offset += 32)
+			{
+				const __m256i input_v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + offset));
+
+				__m256i matches_v = _mm256_cmpeq_epi8(input_v, symbols_v[0]);
+				for (uint32_t symbol_index = 1; symbol_index < num_symbols; ++symbol_index)
+					matches_v = _mm256_or_si256(matches_v, _mm256_cmpeq_epi8(input_v, symbols_v[symbol_index]));
+
+				const uint32_t matches = uint32_t(_mm256_movemask_epi8(matches_v));
+				if (matches != 0)
+				{
+					const size_t match_offset = offset + count_trailing_zeros(matches);
+					return match_offset < input_length ? match_offset : input_length;
+				}
+			}
+
+			return find_any_of_scalar(input, offset, input_length, readable_length, symbols);
+		}
+
+		SJSON_CPP_TARGET_AVX512 inline size_t find_any_of_avx512(const char* input, size_t offset, size_t input_length, size_t readable_length, const SymbolSet& symbols)
+		{
+			(void)readable_length;
+
+			const char* symbol_values = symbols.get_symbols();
+			const uint32_t num_symbols = symbols.get_num_symbols();
+
+			__m512i symbols_v[SymbolSet::k_max_num_symbols];
+			for (uint32_t symbol_index = 0; symbol_index < num_symbols; ++symbol_index)
+				symbols_v[symbol_index] = _mm512_set1_epi8(symbol_values[symbol_index]);
+
+			// Masked loads never fault on the bytes they skip, the tail doesn't need a scalar loop
+			for (; offset < input_length; offset += 64)
+			{
+				const size_t num_remaining = input_length - offset;
+				const __mmask64 load_mask = num_remaining >= 64 ? ~__mmask64(0) : ((__mmask64(1) << num_remaining) - 1);
+				const __m512i input_v = _mm512_maskz_loadu_epi8(load_mask, input + offset);
+
+				__mmask64 matches = _mm512_cmpeq_epi8_mask(input_v, symbols_v[0]);
+				for (uint32_t symbol_index = 1; symbol_index < num_symbols; ++symbol_index)
+					matches |= _mm512_cmpeq_epi8_mask(input_v, symbols_v[symbol_index]);
+
+				matches &= load_mask;
+				if (matches != 0)
+					return offset + count_trailing_zeros(matches);
+			}
+
+			return input_length;
+		}
+
+		// Splits every group of three bytes into four 6 bit values, one per byte.
+		// Each 32 bit lane holds the bytes [b1, b0, b2, b1] of its group.
+		SJSON_CPP_TARGET_SSE42 inline __m128i unpack_base64_groups_sse42(__m128i input_v)
+		{
+			const __m128i groups_v = _mm_shuffle_epi8(input_v, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+			const __m128i values_ac_v = _mm_mulhi_epu16(_mm_and_si128(groups_v, _mm_set1_epi32(0x0FC0FC00)), _mm_set1_epi32(0x04000040));
+			const __m128i values_bd_v = _mm_mullo_epi16(_mm_and_si128(groups_v, _mm_set1_epi32(0x003F03F0)), _mm_set1_epi32(0x01000010));
+			return _mm_or_si128(values_ac_v, values_bd_v);
+		}
+
+		// Maps 6 bit values to symbols by adding the offset of their range in the alphabet
+		SJSON_CPP_TARGET_SSE42 inline __m128i encode_base64_values_sse42(__m128i values_v)
+		{
+			// 0 for [0, 51] and 1 to 12 for [52, 63], [0, 25] then moves to 13
+			__m128i ranges_v = _mm_subs_epu8(values_v, _mm_set1_epi8(51));
+			ranges_v = _mm_or_si128(ranges_v, _mm_and_si128(_mm_cmpgt_epi8(_mm_set1_epi8(26), values_v), _mm_set1_epi8(13)));
+
+			const __m128i offsets_v = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+			return _mm_add_epi8(values_v, _mm_shuffle_epi8(offsets_v, ranges_v));
+		}
+
+		// Maps symbols to their 6 bit values, returns false if any of them is outside of the alphabet
+		SJSON_CPP_TARGET_SSE42 inline bool decode_base64_symbols_sse42(__m128i symbols_v, __m128i& out_values_v)
+		{
+			const __m128i high_nibbles_v = _mm_and_si128(_mm_srli_epi32(symbols_v, 4), _mm_set1_epi8(0x0F));
+			const __m128i low_nibbles_v = _mm_and_si128(symbols_v, _mm_set1_epi8(0x0F));
+
+			// A symbol is valid when the classes of its two nibbles have no bit in common
+			const __m128i low_classes_v = _mm_shuffle_epi8(_mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A), low_nibbles_v);
+			const __m128i high_classes_v = _mm_shuffle_epi8(_mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10), high_nibbles_v);
+			if (!_mm_testz_si128(low_classes_v, high_classes_v))
+				return false;
+
+			// '/' shares its high nibble with '+' but not its offset
+			const __m128i ranges_v = _mm_add_epi8(_mm_cmpeq_epi8(symbols_v, _mm_set1_epi8('/')), high_nibbles_v);
+			const __m128i offsets_v = _mm_shuffle_epi8(_mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0), ranges_v);
+			out_values_v = _mm_add_epi8(symbols_v, offsets_v);
+			return true;
+		}
+
+		// Packs four 6 bit values per 32 bit lane into three bytes, the 12 bytes are at the start of the register
+		SJSON_CPP_TARGET_SSE42 inline __m128i pack_base64_groups_sse42(__m128i values_v)
+		{
+			const __m128i pairs_v = _mm_maddubs_epi16(values_v, _mm_set1_epi32(0x01400140));
+			const __m128i groups_v = _mm_madd_epi16(pairs_v, _mm_set1_epi32(0x00011000));
+			return _mm_shuffle_epi8(groups_v, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+		}
+
+		SJSON_CPP_TARGET_SSE42 inline size_t encode_base64_sse42(const uint8_t* input, size_t size, char* output)
+		{
+			size_t offset = 0;
+			char* cursor = output;
+
+			// 12 bytes per iteration but the load reads 16
+			for (; offset + 16 <= size; offset += 12, cursor += 16)
+			{
+				const __m128i values_v = unpack_base64_groups_sse42(_mm_loadu_si128(reinterpret_cast<const __m128i*>(input + offset)));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(cursor), encode_base64_values_sse42(values_v));
+			}
+
+			return size_t(cursor - output) + encode_base64_scalar(input + offset, size - offset, cursor);
+		}
+
+		SJSON_CPP_TARGET_SSE42 inline Base64Result decode_base64_sse42(const char* input, size_t input_length, uint8_t* output, size_t output_size, size_t& out_num_symbols, size_t& out_size)
+		{
+			size_t offset = 0;
+			size_t size = 0;
+
+			// 16 symbols per iteration, the store writes 16 bytes. The end of the string, padding,
+			// and invalid symbols are left to the scalar routine.
+			for (; offset + 16 <= input_length && size + 16 <= output_size; offset += 16, size += 12)
+			{
+				__m128i values_v;
+				if (!decode_base64_symbols_sse42(_mm_loadu_si128(reinterpret_cast<const __m128i*>(input + offset)), values_v))
+					break;
+
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(output + size), pack_base64_groups_sse42(values_v));
+			}
+
+			// Errors are reported like the scalar routine does, without any symbol or byte
+			const Base64Result result = decode_base64_scalar(input + offset, input_length - offset, output + size, output_size - size, out_num_symbols, out_size);
+			if (result == Base64Result::Success)
+			{
+				out_num_symbols += offset;
+				out_size += size;
+			}
+
+			return result;
+		}
+
+		SJSON_CPP_TARGET_AVX2 inline size_t encode_base64_avx2(const uint8_t* input, size_t size, char* output)
+		{
+			const __m256i shuffle_v = _mm256_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10, 1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+			const __m256i offsets_v = _mm256_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0,
+				'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+
+			size_t offset = 0;
+			char* cursor = output;
+
+			// 24 bytes per iteration, 12 in each lane, but the second load reads up to byte 28
+			for (; offset + 28 <= size; offset += 24, cursor += 32)
+			{
+				const __m128i low_v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + offset));
+				const __m128i high_v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + offset + 12));
+				const __m256i groups_v = _mm256_shuffle_epi8(_mm256_inserti128_si256(_mm256_castsi128_si256(low_v), high_v, 1), shuffle_v);
+
+				const __m256i values_ac_v = _mm256_mulhi_epu16(_mm256_and_si256(groups_v, _mm256_set1_epi32(0x0FC0FC00)), _mm256_set1_epi32(0x04000040));
+				const __m256i values_bd_v = _mm256_mullo_epi16(_mm256_and_si256(groups_v, _mm256_set1_epi32(0x003F03F0)), _mm256_set1_epi32(0x01000010));
+				const __m256i values_v = _mm256_or_si256(values_ac_v, values_bd_v);
+
+				__m256i ranges_v = _mm256_subs_epu8(values_v, _mm256_set1_epi8(51));
+				ranges_v = _mm256_or_si256(ranges_v, _mm256_and_si256(_mm256_cmpgt_epi8(_mm256_set1_epi8(26), values_v), _mm256_set1_epi8(13)));
+
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(cursor), _mm256_add_epi8(values_v, _mm256_shuffle_epi8(offsets_v, ranges_v)));
+			}
+
+			return size_t(cursor - output) + encode_base64_scalar(input + offset, size - offset, cursor);
+		}
+
+		SJSON_CPP_TARGET_AVX2 inline Base64Result decode_base64_avx2(const char* input, size_t input_length, uint8_t* output, size_t output_size, size_t& out_num_symbols, size_t& out_size)
+		{
+			const __m256i low_classes_lut_v = _mm256_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A,
+				0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+			const __m256i high_classes_lut_v = _mm256_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+				0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+			const __m256i offsets_lut_v = _mm256_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0,
+				0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+			const __m256i pack_shuffle_v = _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+				2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+
+			size_t offset = 0;
+			size_t size = 0;
+
+			// 32 symbols per iteration, the store writes 32 bytes. See decode_base64_sse42(..)
+			for (; offset + 32 <= input_length && size + 32 <= output_size; offset += 32, size += 24)
+			{
+				const __m256i symbols_v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + offset));
+				const __m256i high_nibbles_v = _mm256_and_si256(_mm256_srli_epi32(symbols_v, 4), _mm256_set1_epi8(0x0F));
+				const __m256i low_nibbles_v = _mm256_and_si256(symbols_v, _mm256_set1_epi8(0x0F));
+
+				const __m256i low_classes_v = _mm256_shuffle_epi8(low_classes_lut_v, low_nibbles_v);
+				const __m256i high_classes_v = _mm256_shuffle_epi8(high_classes_lut_v, high_nibbles_v);
+				if (!_mm256_testz_si256(low_classes_v, high_classes_v))
+					break;
+
+				const __m256i ranges_v = _mm256_add_epi8(_mm256_cmpeq_epi8(symbols_v, _mm256_set1_epi8('/')), high_nibbles_v);
+				const __m256i values_v = _mm256_add_epi8(symbols_v, _mm256_shuffle_epi8(offsets_lut_v, ranges_v));
+
+				const __m256i pairs_v = _mm256_maddubs_epi16(values_v, _mm256_set1_epi32(0x01400140));
+				const __m256i groups_v = _mm256_shuffle_epi8(_mm256_madd_epi16(pairs_v, _mm256_set1_epi32(0x00011000)), pack_shuffle_v);
+
+				// Each lane holds 12 bytes, they are moved next to each other
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(output + size), _mm256_permutevar8x32_epi32(groups_v, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 7, 7)));
+			}
+
+			const Base64Result result = decode_base64_scalar(input + offset, input_length - offset, output + size, output_size - size, out_num_symbols, out_size);
+			if (result == Base64Result::Success)
+			{
+				out_num_symbols += offset;
+				out_size += size;
+			}
+
+			return result;
+		}
+
+		inline void cpuid(uint32_t leaf, uint32_t sub_leaf, uint32_t registers[4])
+		{
+#if defined(_MSC_VER) && !defined(__clang__)
+			int values[4];
+			__cpuidex(values, int(leaf), int(sub_leaf));
+			for (int register_index = 0; register_index < 4; ++register_index)
+				registers[register_index] = uint32_t(values[register_index]);
+#else
+			unsigned int eax = 0;
+			unsigned int ebx = 0;
+			unsigned int ecx = 0;
+			unsigned int edx = 0;
+			if (leaf <= __get_cpuid_max(leaf & 0x80000000u, nullptr))
+				__cpuid_count(leaf, sub_leaf, eax, ebx, ecx, edx);
+
+			registers[0] = eax;
+			registers[1] = ebx;
+			registers[2] = ecx;
+			registers[3] = edx;
+#endif
+		}
+
+		// Which register states the OS saves on context switches
+		inline uint64_t get_enabled_register_states()
+		{
+#if defined(_MSC_VER) && !defined(__clang__)
+			return _xgetbv(0);
+#else
+			uint32_t eax;
+			uint32_t edx;
+			__asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+			return (uint64_t(edx) << 32) | eax;
+#endif
+		}
+#endif
+
+		inline Kernels make_kernels(KernelSet kernel_set)
+		{
+			Kernels kernels;
+			kernels.kernel_set = kernel_set;
+
+			switch (kernel_set)
+			{
+#if defined(SJSON_CPP_X86_KERNELS)
+			case KernelSet::SSE42:
+				kernels.find_any_of = find_any_of_sse42;
+				kernels.encode_base64 = encode_base64_sse42;
+				kernels.decode_base64 = decode_base64_sse42;
+				break;
+			case KernelSet::AVX2:
+				kernels.find_any_of = find_any_of_avx2;
+				kernels.encode_base64 = encode_base64_avx2;
+				kernels.decode_base64 = decode_base64_avx2;
+				break;
+			case KernelSet::AVX512:
+				kernels.find_any_of = find_any_of_avx512;
+				kernels.encode_base64 = encode_base64_avx2;
+				kernels.decode_base64 = decode_base64_avx2;
+				break;
+#endif
+			default:
+				kernels.kernel_set = KernelSet::Scalar;
+				kernels.find_any_of = find_any_of_scalar;
+				kernels.encode_base64 = encode_base64_scalar;
+				kernels.decode_base64 = decode_base64_scalar;
+				break;
+			}
+
+			return kernels;
+		}
+
+		inline std::atomic<const Kernels*>& get_selected_kernels()
+		{
+			static std::atomic<const Kernels*> selected_kernels(nullptr);
+			return selected_kernels;
+		}
+
+		inline const Kernels& get_kernel_storage(KernelSet kernel_set)
+		{
+			static const Kernels kernels[] =
+			{
+				make_kernels(KernelSet::Scalar),
+				make_kernels(KernelSet::SSE42),
+				make_kernels(KernelSet::AVX2),
+				make_kernels(KernelSet::AVX512),
+			};
+
+			return kernels[uint32_t(kernel_set)];
+		}
+	}
+
+	// Returns the best kernel set supported by the CPU and the OS
+	inline KernelSet detect_kernel_set()
+	{
+#if defined(SJSON_CPP_X86_KERNELS)
+		uint32_t leaf0[4];
+		impl::cpuid(0, 0, leaf0);
+		const uint32_t max_leaf = leaf0[0];
+
+		uint32_t leaf1[4];
+		impl::cpuid(1, 0, leaf1);
+
+		const bool has_sse42 = (leaf1[2] & (1u << 20)) != 0;
+		if (!has_sse42)
+			return KernelSet::Scalar;
+
+		const bool has_osxsave = (leaf1[2] & (1u << 27)) != 0;
+		const bool has_avx = (leaf1[2] & (1u << 28)) != 0;
+		if (!has_osxsave || !has_avx || max_leaf < 7)
+			return KernelSet::SSE42;
+
+		// XMM and YMM states must be enabled by the OS
+		const uint64_t register_states = impl::get_enabled_register_states();
+		if ((register_states & 0x6) != 0x6)
+			return KernelSet::SSE42;
+
+		uint32_t leaf7[4];
+		impl::cpuid(7, 0, leaf7);
+
+		const bool has_avx2 = (leaf7[1] & (1u << 5)) != 0;
+		if (!has_avx2)
+			return KernelSet::SSE42;
+
+		// Opmask and ZMM states must be enabled by the OS as well
+		const bool has_avx512 = (leaf7[1] & (1u << 16)) != 0 && (leaf7[1] & (1u << 30)) != 0;
+		if (!has_avx512 || (register_states & 0xE6) != 0xE6)
+			return KernelSet::AVX2;
+
+		return KernelSet::AVX512;
+#else
+		return KernelSet::Scalar;
+#endif
+	}
+
+	// Whether or not a kernel set can be used on this CPU
+	inline bool is_kernel_set_supported(KernelSet kernel_set)
+	{
+		return uint32_t(kernel_set) <= uint32_t(detect_kernel_set());
+	}
+
+	// Returns the kernels in use, they are selected the first time this function is called
+	inline const impl::Kernels& get_kernels()
+	{
+		std::atomic<const impl::Kernels*>& selected_kernels = impl::get_selected_kernels();
+
+		const impl::Kernels* kernels = selected_kernels.load(std::memory_order_acquire);
+		if (kernels == nullptr)
+		{
+			kernels = &impl::get_kernel_storage(detect_kernel_set());
+			selected_kernels.store(kernels, std::memory_order_release);
+		}
+
+		return *kernels;
+	}
+
+	inline KernelSet get_kernel_set() { return get_kernels().kernel_set; }
+
+	// Forces a kernel set, mainly for testing and benchmarking. It must be supported by the CPU.
+	inline void override_kernel_set(KernelSet kernel_set)
+	{
+		SJSON_CPP_ASSERT(is_kernel_set_supported(kernel_set), "Kernel set %s is not supported by this CPU", get_kernel_set_name(kernel_set));
+		impl::get_selected_kernels().store(&impl::get_kernel_storage(kernel_set), std::memory_order_release);
+	}
+
+	// Restores the kernel set detected for this CPU
+	inline void reset_kernel_set() { override_kernel_set(detect_kernel_set()); }
+
+	namespace impl
+	{
+		// Encodes 'size' bytes into get_base64_encoded_length(size) symbols and returns how many were written
+		inline size_t encode_base64(const uint8_t* input, size_t size, char* output) { return get_kernels().encode_base64(input, size, output); }
+
+		// See decode_base64_scalar(..)
+		inline Base64Result decode_base64(const char* input, size_t input_length, uint8_t* output, size_t output_size, size_t& out_num_symbols, size_t& out_size)
+		{
+			return get_kernels().decode_base64(input, input_length, output, output_size, out_num_symbols, out_size);
+		}
+	}
+}
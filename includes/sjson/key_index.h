@@ -0,0 +1,492 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+// The MIT License (MIT)
+//
+// Copyright (c) 2018 Nicholas Frechette, Cody Jones, and sjson-cpp contributors
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "sjson/error.h"
+#include "sjson/fingerprint.h"
+#include "sjson/parser.h"
+#include "sjson/parser_state.h"
+#include "sjson/path_query.h"
+#include "sjson/string_view.h"
+#include "sjson/writer.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace sjson
+{
+	// Identifies the input an index was built from, an index is only valid for an identical source.
+	// Fields that are not tracked can be left at zero, e.g. the content hash is costly to compute at runtime.
+	struct KeyIndexSource
+	{
+		KeyIndexSource()
+			: size(0)
+			, modification_time(0)
+			, content_hash(0)
+		{}
+
+		uint64_t size;
+		uint64_t modification_time;
+		uint64_t content_hash;
+
+		bool operator==(const KeyIndexSource& other) const { return size == other.size && modification_time == other.modification_time && content_hash == other.content_hash; }
+		bool operator!=(const KeyIndexSource& other) const { return !(*this == other); }
+	};
+
+	// A 64 bit FNV-1a hash of the whole input which can be used as the content hash of a source
+	inline uint64_t compute_key_index_content_hash(const char* input, size_t input_length)
+	{
+		return impl::hash_fingerprint_bytes(impl::k_fingerprint_offset_basis, input, input_length);
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+	// A key index maps the path of every value in an input to where it lives in it.
+	// It is built once, saved next to the input, and loaded later to find values without
+	// scanning the content that precedes them. With a memory mapped input, a lookup only
+	// touches the pages that hold the value.
+	//
+	// Building the index:
+	//    KeyIndex index;
+	//    index.build(parser, source);
+	//    index.write(file_stream_writer);
+	//
+	// Using the index:
+	//    KeyIndex index;
+	//    if (index.load(index_data, index_size) && index.is_valid_for(source) && index.seek(parser, "render.width"))
+	//        parser.read(width);
+	//
+	// Paths use the PathQuery syntax with '.' separators. Object members are indexed but array elements are not,
+	// which keeps the index small for array heavy inputs: a path within an array is found by seeking to the
+	// array and stepping through its elements.
+	// Paths are identified by a 64 bit hash and the index is searched with a binary search. The path
+	// text is stored as well and compared on a hash hit, paths whose hashes collide are still told apart.
+	// When a key appears more than once in an object, its first value is found.
+	// Offsets are stored with 32 bits, inputs larger than 4 GB cannot be indexed.
+	// The index file is written in the native byte order. Unlike the parser, an index allocates memory.
+	//////////////////////////////////////////////////////////////////////////
+	class KeyIndex
+	{
+	public:
+		struct Entry
+		{
+			uint64_t path_hash;
+
+			// Where the path text lives in the path data of the index
+			uint32_t path_offset;
+			uint32_t path_length;
+
+			// The raw value in the input, strings retain their quotation marks
+			uint32_t offset;
+			uint32_t length;
+
+			// Where the value begins in the input
+			uint32_t line;
+			uint32_t column;
+		};
+
+		KeyIndex()
+			: m_source()
+			, m_entries()
+			, m_paths()
+		{}
+
+		// Builds the index of an input from the start of the parser, it must be at the root
+		template<class DialectType>
+		inline bool build(BasicParser<DialectType>& parser, const KeyIndexSource& source);
+
+		// Writes the index in its binary form
+		inline void write(StreamWriter& stream_writer) const;
+
+		// Loads an index written with write(..), returns false when the data isn't a valid index
+		inline bool load(const void* data, size_t size);
+
+		// Whether or not the index was built from this source
+		bool is_valid_for(const KeyIndexSource& source) const { return m_source == source; }
+
+		const KeyIndexSource& get_source() const { return m_source; }
+		uint32_t get_num_entries() const { return uint32_t(m_entries.size()); }
+
+		// Returns the raw value, position, and type of a path, the input is read with the dialect the index was built with
+		template<class DialectType = SJSONDialect>
+		inline bool find(const char* path, const char* input, size_t input_length, PathQueryResult& out_result) const;
+
+		// Moves the parser onto the value of a path, it can then be read without a key: parser.read(value)
+		template<class DialectType>
+		inline bool seek(BasicParser<DialectType>& parser, const char* path) const;
+
+		static inline uint64_t hash_path(const char* path, size_t path_length);
+
+	private:
+		static constexpr uint32_t k_magic = 0x58494A53;	// 'SJIX'
+		static constexpr uint32_t k_version = 3;
+
+		// The header is followed by the entries and then by the path data
+		struct Header
+		{
+			uint32_t magic;
+			uint32_t version;
+			KeyIndexSource source;
+			uint64_t num_entries;
+			uint64_t paths_size;
+		};
+
+		inline const Entry* find_entry(const char* path, size_t path_length) const;
+
+		template<class DialectType>
+		inline bool seek_segments(BasicParser<DialectType>& parser, const char* segments) const;
+
+		template<class DialectType>
+		inline bool build_members(BasicParser<DialectType>& parser, std::string& path, bool is_root);
+
+		template<class DialectType>
+		inline bool build_value(BasicParser<DialectType>& parser, std::string& path);
+
+		KeyIndexSource m_source;
+		std::vector<Entry> m_entries;
+
+		// The text of every path, back to back
+		std::string m_paths;
+	};
+
+	//////////////////////////////////////////////////////////////////////////
+
+	template<class DialectType>
+	inline bool KeyIndex::build(BasicParser<DialectType>& parser, const KeyIndexSource& source)
+	{
+		m_source = source;
+		m_entries.clear();
+		m_paths.clear();
+
+		std::string path;
+		if (parser.get_input_length() > UINT32_MAX || !build_members(parser, path, true) || !parser.remainder_is_comments_and_whitespace())
+		{
+			m_entries.clear();
+			m_paths.clear();
+			return false;
+		}
+
+		// Entries with equal hashes remain in input order, the first of duplicate paths is found first
+		std::stable_sort(m_entries.begin(), m_entries.end(), [](const Entry& lhs, const Entry& rhs) { return lhs.path_hash < rhs.path_hash; });
+		return true;
+	}
+
+	inline void KeyIndex::write(StreamWriter& stream_writer) const
+	{
+		Header header;
+		header.magic = k_magic;
+		header.version = k_version;
+		header.source = m_source;
+		header.num_entries = m_entries.size();
+		header.paths_size = m_paths.size();
+
+		stream_writer.write(&header, sizeof(header));
+		if (!m_entries.empty())
+			stream_writer.write(m_entries.data(), m_entries.size() * sizeof(Entry));
+
+		if (!m_paths.empty())
+			stream_writer.write(m_paths.data(), m_paths.size());
+	}
+
+	inline bool KeyIndex::load(const void* data, size_t size)
+	{
+		m_source = KeyIndexSource();
+		m_entries.clear();
+		m_paths.clear();
+
+		Header header;
+		if (size < sizeof(header))
+			return false;
+
+		std::memcpy(&header, data, sizeof(header));
+		if (header.magic != k_magic || header.version != k_version)
+			return false;
+
+		const size_t content_size = size - sizeof(header);
+		if (header.paths_size > content_size || header.num_entries != (content_size - header.paths_size) / sizeof(Entry) || (content_size - header.paths_size) % sizeof(Entry) != 0)
+			return false;
+
+		const uint8_t* entries_data = static_cast<const uint8_t*>(data) + sizeof(header);
+		const size_t entries_size = size_t(header.num_entries) * sizeof(Entry);
+
+		std::vector<Entry> entries(size_t(header.num_entries));
+		if (!entries.empty())
+			std::memcpy(entries.data(), entries_data, entries_size);
+
+		for (const Entry& entry : entries)
+		{
+			if (entry.path_offset > header.paths_size || entry.path_length > header.paths_size - entry.path_offset)
+				return false;
+		}
+
+		m_source = header.source;
+		m_entries.swap(entries);
+		m_paths.assign(reinterpret_cast<const char*>(entries_data + entries_size), size_t(header.paths_size));
+		return true;
+	}
+
+	template<class DialectType>
+	inline bool KeyIndex::find(const char* path, const char* input, size_t input_length, PathQueryResult& out_result) const
+	{
+		out_result = PathQueryResult();
+
+		const Entry* entry = find_entry(path, std::strlen(path));
+		if (entry != nullptr)
+		{
+			if (size_t(entry->offset) + entry->length > input_length)
+				return false;
+
+			out_result.raw_value = StringView(input + entry->offset, size_t(entry->length));
+			out_result.line = entry->line;
+			out_result.column = entry->column;
+		}
+		else
+		{
+			// Within an array, the value is read from the input
+			BasicParser<DialectType> input_parser(input, input_length);
+			if (!seek(input_parser, path))
+				return false;
+
+			const ParserState start_of_value = input_parser.save_state();
+			if (!input_parser.skip_value())
+				return false;
+
+			out_result.raw_value = StringView(input + start_of_value.offset, input_parser.save_state().offset - start_of_value.offset);
+			out_result.line = start_of_value.line;
+			out_result.column = start_of_value.column;
+		}
+
+		out_result.is_found = true;
+
+		Parser parser(out_result.raw_value.c_str(), out_result.raw_value.size());
+		out_result.type = parser.peek_value_type();
+		return true;
+	}
+
+	template<class DialectType>
+	inline bool KeyIndex::seek(BasicParser<DialectType>& parser, const char* path) const
+	{
+		// Array elements aren't indexed, the longest indexed path is found and the rest of the path is walked from it
+		size_t path_length = std::strlen(path);
+		const Entry* entry = find_entry(path, path_length);
+		while (entry == nullptr)
+		{
+			while (path_length != 0 && path[path_length - 1] != '.')
+				path_length--;
+
+			if (path_length <= 1)
+				return false;
+
+			path_length--;
+			entry = find_entry(path, path_length);
+		}
+
+		if (entry->offset >= parser.get_input_length())
+			return false;
+
+		ParserState state = parser.save_state();
+		state.offset = size_t(entry->offset);
+		state.line = entry->line;
+		state.column = entry->column;
+		state.symbol = parser.get_input()[state.offset];
+		state.has_previous_entry = false;
+		parser.restore_state(state);
+
+		if (path[path_length] == '\0')
+			return true;
+
+		if (!seek_segments(parser, path + path_length + 1))
+			return false;
+
+		// The value can be read without a key like when it is found in the index
+		if (parser.peek_value_type() == ValueType::Unknown)
+			return false;
+
+		state = parser.save_state();
+		state.has_previous_entry = false;
+		parser.restore_state(state);
+		return true;
+	}
+
+	template<class DialectType>
+	inline bool KeyIndex::seek_segments(BasicParser<DialectType>& parser, const char* segments) const
+	{
+		StringView key;
+
+		while (true)
+		{
+			const char* separator = std::strchr(segments, '.');
+			const size_t segment_length = separator != nullptr ? size_t(separator - segments) : std::strlen(segments);
+			const StringView segment(segments, segment_length);
+
+			const ValueType type = parser.peek_value_type();
+			if (type == ValueType::Array)
+			{
+				if (segment_length == 0 || segment_length > 9)
+					return false;
+
+				uint32_t target_index = 0;
+				for (size_t symbol_index = 0; symbol_index < segment_length; ++symbol_index)
+				{
+					if (!std::isdigit(segments[symbol_index]))
+						return false;
+
+					target_index = (target_index * 10) + uint32_t(segments[symbol_index] - '0');
+				}
+
+				if (!parser.array_begins())
+					return false;
+
+				for (uint32_t element_index = 0; ; ++element_index)
+				{
+					if (parser.try_array_ends())
+						return false;
+
+					if (element_index != 0 && !parser.read_array_separator())
+						return false;
+
+					if (element_index == target_index)
+						break;
+
+					if (!parser.skip_value())
+						return false;
+				}
+			}
+			else if (type == ValueType::Object)
+			{
+				if (!parser.object_begins())
+					return false;
+
+				while (true)
+				{
+					if (parser.try_object_ends() || !parser.read_next_key(key))
+						return false;
+
+					if (key == segment)
+						break;
+
+					if (!parser.skip_value())
+						return false;
+				}
+			}
+			else
+				return false;
+
+			if (separator == nullptr)
+				return true;
+
+			segments = separator + 1;
+		}
+	}
+
+	inline uint64_t KeyIndex::hash_path(const char* path, size_t path_length)
+	{
+		return impl::hash_fingerprint_bytes(impl::k_fingerprint_offset_basis, path, path_length);
+	}
+
+	inline const KeyIndex::Entry* KeyIndex::find_entry(const char* path, size_t path_length) const
+	{
+		const uint64_t path_hash = hash_path(path, path_length);
+		auto it = std::lower_bound(m_entries.begin(), m_entries.end(), path_hash, [](const Entry& entry, uint64_t hash) { return entry.path_hash < hash; });
+
+		// A hash hit is only a match when the path text is identical
+		for (; it != m_entries.end() && it->path_hash == path_hash; ++it)
+		{
+			if (it->path_length == path_length && std::memcmp(m_paths.data() + size_t(it->path_offset), path, path_length) == 0)
+				return &*it;
+		}
+
+		return nullptr;
+	}
+
+	template<class DialectType>
+	inline bool KeyIndex::build_members(BasicParser<DialectType>& parser, std::string& path, bool is_root)
+	{
+		StringView key;
+
+		while (true)
+		{
+			if (is_root)
+			{
+				if (!parser.skip_comments_and_whitespace())
+					return false;
+
+				if (parser.is_root_object_end())
+					return true;
+			}
+			else if (parser.try_object_ends())
+				return true;
+
+			if (!parser.read_next_key(key))
+				return false;
+
+			const size_t parent_path_length = path.size();
+			if (parent_path_length != 0)
+				path.push_back('.');
+
+			path.append(key.c_str(), key.size());
+
+			if (!build_value(parser, path))
+				return false;
+
+			path.resize(parent_path_length);
+		}
+	}
+
+	template<class DialectType>
+	inline bool KeyIndex::build_value(BasicParser<DialectType>& parser, std::string& path)
+	{
+		const ValueType type = parser.peek_value_type();
+		const ParserState start_of_value = parser.save_state();
+
+		// Only objects are walked into, arrays are skipped whole and their elements are not indexed
+		if (type == ValueType::Object)
+		{
+			if (!parser.object_begins() || !build_members(parser, path, false))
+				return false;
+		}
+		else if (!parser.skip_value())
+			return false;
+
+		if (m_paths.size() + path.size() > UINT32_MAX)
+			return false;
+
+		Entry entry;
+		entry.path_hash = hash_path(path.c_str(), path.size());
+		entry.path_offset = uint32_t(m_paths.size());
+		entry.path_length = uint32_t(path.size());
+		entry.offset = uint32_t(start_of_value.offset);
+		entry.length = uint32_t(parser.save_state().offset - start_of_value.offset);
+		entry.line = start_of_value.line;
+		entry.column = start_of_value.column;
+		m_entries.push_back(entry);
+		m_paths.append(path);
+		return true;
+	}
+}
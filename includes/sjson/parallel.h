@@ -0,0 +1,93 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+// The MIT License (MIT)
+//
+// Copyright (c) 2018 Nicholas Frechette, Cody Jones, and sjson-cpp contributors
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace sjson
+{
+	namespace impl
+	{
+		//////////////////////////////////////////////////////////////////////////
+		// Runs 'worker()' on 'num_threads' threads, the calling thread included, and waits for all of them.
+		// Workers are expected to pull their work from a shared atomic counter until none is left.
+		// If a worker throws, the other threads are still joined and the first exception is rethrown
+		// on the calling thread once they are done.
+		// If a thread cannot be created, the work is shared by the threads that could be.
+		//////////////////////////////////////////////////////////////////////////
+		template<typename WorkerType>
+		inline void run_workers(uint32_t num_threads, WorkerType& worker)
+		{
+			std::exception_ptr first_exception;
+			std::mutex exception_mutex;
+
+			auto guarded_worker = [&]()
+			{
+				try
+				{
+					worker();
+				}
+				catch (...)
+				{
+					std::lock_guard<std::mutex> lock(exception_mutex);
+					if (!first_exception)
+						first_exception = std::current_exception();
+				}
+			};
+
+			std::vector<std::thread> threads;
+			if (num_threads > 1)
+			{
+				threads.reserve(num_threads - 1);
+				for (uint32_t thread_index = 1; thread_index < num_threads; ++thread_index)
+				{
+					try
+					{
+						threads.emplace_back(std::ref(guarded_worker));
+					}
+					catch (const std::system_error&)
+					{
+						// The threads already running must be joined, the calling thread always works as well
+						break;
+					}
+				}
+			}
+
+			guarded_worker();
+
+			for (std::thread& thread : threads)
+				thread.join();
+
+			if (first_exception)
+				std::rethrow_exception(first_exception);
+		}
+	}
+}
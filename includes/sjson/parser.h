@@ -29,6 +29,9 @@
 	#define SJSON_CPP_PARSER
 #endif
 
+#include "sjson/base64.h"
+#include "sjson/kernels.h"
+#include "sjson/parser_dialect.h"
 #include "sjson/parser_error.h"
 #include "sjson/parser_state.h"
 #include "sjson/platform.h"
@@ -39,31 +42,126 @@
 #include <cstring>
 #include <cstdint>
 #include <algorithm>
+#include <type_traits>
 
 namespace sjson
 {
-	class Parser
+	// The type of a value as seen by the parser, see BasicParser::peek_value_type()
+	enum class ValueType
 	{
+		Unknown,
+		Null,
+		Bool,
+		Number,
+		String,
+		Object,
+		Array,
+	};
+
+	// The extent of every dimension of a nested array, e.g. [ [ 1, 2, 3 ], [ 4, 5, 6 ] ] has a shape of 2x3
+	struct ArrayShape
+	{
+		static constexpr uint32_t k_max_num_dimensions = 8;
+
+		ArrayShape()
+			: num_dimensions(0)
+			, extents()
+		{}
+
+		ArrayShape(uint32_t num_rows, uint32_t num_columns)
+			: num_dimensions(2)
+			, extents()
+		{
+			extents[0] = num_rows;
+			extents[1] = num_columns;
+		}
+
+		uint64_t get_num_elements() const
+		{
+			uint64_t num_elements = num_dimensions == 0 ? 0 : 1;
+			for (uint32_t dimension_index = 0; dimension_index < num_dimensions; ++dimension_index)
+				num_elements *= extents[dimension_index];
+
+			return num_elements;
+		}
+
+		uint32_t num_dimensions;
+		uint32_t extents[k_max_num_dimensions];
+	};
+
+	namespace impl
+	{
+		// The symbols that end a string or begin an escape sequence within it
+		inline const SymbolSet& get_string_symbols()
+		{
+			static const SymbolSet symbols("\"\\");
+			return symbols;
+		}
+
+		// The symbols that matter when skipping over a container in bulk
+		inline const SymbolSet& get_container_symbols(bool allow_comments)
+		{
+			static const SymbolSet symbols("\"{}[]");
+			static const SymbolSet symbols_with_comments("\"{}[]/");
+			return allow_comments ? symbols_with_comments : symbols;
+		}
+
+		// Returns true if the number that starts at the offset is an integer, decimal, hexadecimal or octal
+		inline bool is_integer_token(const char* input, size_t input_length, size_t offset)
+		{
+			if (offset < input_length && input[offset] == '-')
+				offset++;
+
+			const size_t start_offset = offset;
+			if (offset + 1 < input_length && input[offset] == '0' && (input[offset + 1] == 'x' || input[offset + 1] == 'X'))
+			{
+				offset += 2;
+				while (offset < input_length && std::isxdigit(input[offset]))
+					offset++;
+
+				return offset < input_length ? (input[offset] != '.' && input[offset] != 'p' && input[offset] != 'P') : true;
+			}
+
+			while (offset < input_length && std::isdigit(input[offset]))
+				offset++;
+
+			if (offset == start_offset)
+				return false;
+
+			return offset < input_length ? (input[offset] != '.' && input[offset] != 'e' && input[offset] != 'E') : true;
+		}
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+	// The parser is templated on a dialect that controls which syntax features are supported.
+	// See parser_dialect.h for details. Most code should use the 'Parser' alias below.
+	//////////////////////////////////////////////////////////////////////////
+	template<class DialectType>
+	class BasicParser
+	{
+		static_assert(DialectType::k_allow_quoted_keys || DialectType::k_allow_unquoted_keys, "The dialect must allow quoted keys, unquoted keys, or both");
+
 	public:
-		Parser(const char* input, size_t input_length)
+		BasicParser(const char* input, size_t input_length)
 			: m_input(input)
 			, m_input_length(input_length)
 			, m_state(input, input_length)
 		{
-			skip_bom();
+			SJSON_CPP_ASSERT(!DialectType::k_input_is_padded || input[input_length] == '\0', "Padded input must be followed by NUL bytes");
+			begin_input();
 		}
 
 		// Prevent copying to reduce to avoid potential mistakes
-		Parser(const Parser& other) = delete;
-		Parser& operator=(const Parser& other) = delete;
+		BasicParser(const BasicParser& other) = delete;
+		BasicParser& operator=(const BasicParser& other) = delete;
 
-		Parser(Parser&& other)
+		BasicParser(BasicParser&& other)
 			: m_input(other.m_input)
 			, m_input_length(other.m_input_length)
 			, m_state(other.m_state)
 		{}
 
-		Parser& operator=(Parser&& other)
+		BasicParser& operator=(BasicParser&& other)
 		{
 			m_input = other.m_input;
 			m_input_length = other.m_input_length;
@@ -72,8 +170,8 @@ namespace sjson
 			return *this;
 		}
 
-		bool object_begins() { return read_opening_brace(); }
-		bool object_begins(const char* having_name) { return read_key(having_name) && read_equal_sign() && object_begins(); }
+		bool object_begins() { return read_element_separator() && read_opening_brace(); }
+		bool object_begins(const char* having_name) { return read_key(having_name) && read_equal_sign() && read_opening_brace(); }
 		bool object_ends() { return read_closing_brace(); }
 
 		bool try_object_begins(const char* having_name)
@@ -102,7 +200,7 @@ namespace sjson
 			return true;
 		}
 
-		bool array_begins() { return read_opening_bracket(); }
+		bool array_begins() { return read_element_separator() && read_opening_bracket(); }
 		bool array_begins(const char* having_name) { return read_key(having_name) && read_equal_sign() && read_opening_bracket(); }
 		bool array_ends() { return read_closing_bracket(); }
 
@@ -163,11 +261,112 @@ namespace sjson
 			return read_key(key) && read_equal_sign() && read_opening_bracket() && read(values, num_elements) && read_closing_bracket();
 		}
 
+		bool read(const char* key, float* values, uint32_t num_elements)
+		{
+			return read_key(key) && read_equal_sign() && read_opening_bracket() && read(values, num_elements) && read_closing_bracket();
+		}
+
 		bool read(const char* key, StringView* values, uint32_t num_elements)
 		{
 			return read_key(key) && read_equal_sign() && read_opening_bracket() && read(values, num_elements) && read_closing_bracket();
 		}
 
+		// Reads a fixed size array such as a vector or a quaternion: key = [ x, y, z ]
+		// The number of elements is known at compile time and the element reads are unrolled.
+		template<typename ElementType, size_t NumElements>
+		bool read(const char* key, ElementType (&values)[NumElements])
+		{
+			return read_key(key) && read_equal_sign() && read_opening_bracket() && read_fixed_elements(values, std::integral_constant<size_t, NumElements>()) && read_closing_bracket();
+		}
+
+		// Reads a fixed size array of rows such as a matrix: key = [ [ x, y ], [ z, w ] ]
+		template<typename ElementType, size_t NumRows, size_t NumColumns>
+		bool read(const char* key, ElementType (&values)[NumRows][NumColumns])
+		{
+			return read_tuples<NumColumns>(key, &values[0][0], NumRows);
+		}
+
+		// Reads an array of tuples of a fixed size into contiguous storage: key = [ [ x, y, z ], [ x, y, z ] ]
+		// Tuples are written 'TupleStride' elements apart which allows tuples to be padded for aligned vector loads,
+		// e.g. 3D positions into float4 slots with read_tuples<3, 4>(..). Padding elements are left untouched.
+		// Tuples are separated by optional commas in SJSON, like when iterating over arrays generically.
+		template<size_t TupleSize, size_t TupleStride = TupleSize, typename ElementType>
+		bool read_tuples(const char* key, ElementType* values, uint32_t num_tuples)
+		{
+			static_assert(TupleSize != 0, "Tuples must have at least one element");
+			static_assert(TupleStride >= TupleSize, "The tuple stride must be large enough to hold a tuple");
+
+			if (!read_key(key) || !read_equal_sign() || !read_opening_bracket())
+				return false;
+
+			for (uint32_t tuple_index = 0; tuple_index < num_tuples; ++tuple_index)
+			{
+				if (tuple_index != 0 && !read_array_separator())
+					return false;
+
+				if (!array_begins() || !read_fixed_elements(values + (tuple_index * TupleStride), std::integral_constant<size_t, TupleSize>()) || !array_ends())
+					return false;
+			}
+
+			return read_closing_bracket();
+		}
+
+		// Reads a nested numeric array of a known shape into contiguous row-major storage in a single pass:
+		//    key = [ [ 1.0, 2.0, 3.0 ], [ 4.0, 5.0, 6.0 ] ]
+		// Every row must have the width of the shape, a row that differs fails with CommaExpected
+		// or ClosingBracketExpected where it deviates. Rows are separated by optional commas in SJSON.
+		bool read(const char* key, double* values, const ArrayShape& shape) { return read_array(key, values, shape); }
+		bool read(const char* key, float* values, const ArrayShape& shape) { return read_array(key, values, shape); }
+
+		// Infers the shape of a nested array and reads it, the destination must be able to hold 'max_num_elements'
+		bool read(const char* key, double* values, uint64_t max_num_elements, ArrayShape& out_shape) { return read_array(key, values, max_num_elements, out_shape); }
+		bool read(const char* key, float* values, uint64_t max_num_elements, ArrayShape& out_shape) { return read_array(key, values, max_num_elements, out_shape); }
+
+		// Infers the shape of a nested array from its first element at every depth without consuming it.
+		// This is a quick structural scan, the content is validated once the array is read.
+		// The parser does not move on failure either, only the error is kept.
+		bool read_array_shape(const char* key, ArrayShape& out_shape)
+		{
+			const ParserState start_of_key = save_state();
+			bool is_valid = read_key(key) && read_equal_sign() && skip_comments_and_whitespace_fail_if_eof();
+
+			if (is_valid && m_state.symbol != '[')
+			{
+				set_error(ParserError::OpeningBracketExpected);
+				is_valid = false;
+			}
+
+			is_valid = is_valid && scan_array_shape(out_shape);
+
+			const ParserError error = m_state.error;
+			restore_state(start_of_key);
+
+			if (!is_valid)
+				report_error(error.error, error.line, error.column);
+
+			return is_valid;
+		}
+
+		// Reads a binary value written as a base64 string with ObjectWriter::insert_binary(..), it is decoded
+		// straight into the buffer as the string is scanned. Fails with LengthOutOfRange when the buffer is
+		// too small, get_base64_max_decoded_size(..) of the raw string length is always large enough.
+		bool read_binary(const char* key, void* buffer, size_t buffer_size, size_t& out_size)
+		{
+			return read_key(key) && read_equal_sign() && read_binary(buffer, buffer_size, out_size);
+		}
+
+		// Reads a batch of records written in a columnar layout with ObjectWriter::insert_columns(..)
+		// Every column is read directly in its own buffer which must be able to hold 'num_rows' values.
+		bool read_columns(const char* key, const char* const* column_names, double* const* columns, uint32_t num_columns, uint32_t num_rows)
+		{
+			return read_number_columns(key, column_names, columns, num_columns, num_rows);
+		}
+
+		bool read_columns(const char* key, const char* const* column_names, float* const* columns, uint32_t num_columns, uint32_t num_rows)
+		{
+			return read_number_columns(key, column_names, columns, num_columns, num_rows);
+		}
+
 		bool try_read(const char* key, StringView& value, const char* default_value)
 		{
 			ParserState s = save_state();
@@ -311,6 +510,23 @@ namespace sjson
 			return true;
 		}
 
+		bool read(float* values, uint32_t num_elements)
+		{
+			if (num_elements == 0)
+				return true;
+
+			for (uint32_t i = 0; i < num_elements; ++i)
+			{
+				if (!read_double(nullptr, &values[i]))
+					return false;
+
+				if (i < (num_elements - 1) && !read_comma())
+					return false;
+			}
+
+			return true;
+		}
+
 		bool read(StringView* values, uint32_t num_elements)
 		{
 			if (num_elements == 0)
@@ -328,8 +544,146 @@ namespace sjson
 			return true;
 		}
 
+		// Key-less reads, useful when iterating over arrays or once a key has been read with read_next_key(..)
+		bool read(StringView& value) { return read_string(value); }
+		bool read_binary(void* buffer, size_t buffer_size, size_t& out_size) { return read_base64(static_cast<uint8_t*>(buffer), buffer_size, out_size); }
+		bool read(bool& value) { return read_bool(value); }
+		bool read(double& value) { return read_double(&value, nullptr); }
+		bool read(float& value) { return read_double(nullptr, &value); }
+		bool read(int8_t& value) { return read_integer(value); }
+		bool read(uint8_t& value) { return read_integer(value); }
+		bool read(int16_t& value) { return read_integer(value); }
+		bool read(uint16_t& value) { return read_integer(value); }
+		bool read(int32_t& value) { return read_integer(value); }
+		bool read(uint32_t& value) { return read_integer(value); }
+		bool read(int64_t& value) { return read_integer(value); }
+		bool read(uint64_t& value) { return read_integer(value); }
+
+		//////////////////////////////////////////////////////////////////////////
+		// Generic traversal
+		// The functions below allow walking an input whose layout isn't known ahead of time.
+		// e.g. to visit every member of an object:
+		//    parser.object_begins();
+		//    while (!parser.try_object_ends())
+		//    {
+		//        parser.read_next_key(key);
+		//        if (parser.peek_value_type() == ValueType::Number) ... else parser.skip_value();
+		//    }
+		//////////////////////////////////////////////////////////////////////////
+
+		// Returns the type of the next value without consuming it, only whitespace and comments are skipped
+		ValueType peek_value_type()
+		{
+			if (!skip_comments_and_whitespace_fail_if_eof())
+				return ValueType::Unknown;
+
+			switch (m_state.symbol)
+			{
+			case '{':
+				return ValueType::Object;
+			case '[':
+				return ValueType::Array;
+			case '"':
+				return ValueType::String;
+			case 't':
+			case 'f':
+				return ValueType::Bool;
+			case 'n':
+				return ValueType::Null;
+			case '-':
+				return ValueType::Number;
+			default:
+				return std::isdigit(m_state.symbol) ? ValueType::Number : ValueType::Unknown;
+			}
+		}
+
+		// Reads the next key of the current object along with the separator that follows it
+		bool read_next_key(StringView& key) { return read_key_name(key) && read_equal_sign(); }
+
+		// Reads the separator between two array elements when iterating over an array generically.
+		// Array elements are separated by commas, it is optional in SJSON but required in JSON.
+		bool read_array_separator()
+		{
+			if (!skip_comments_and_whitespace_fail_if_eof())
+				return false;
+
+			if (m_state.symbol == ',')
+			{
+				advance();
+				begin_container_entry();
+				return true;
+			}
+
+			if (DialectType::k_require_member_commas)
+			{
+				set_error(ParserError::CommaExpected);
+				return false;
+			}
+
+			return true;
+		}
+
+		// Skips over the next value whatever its type.
+		// Objects and arrays are skipped in bulk: within them, only strings, comments, and
+		// the nesting depth are tracked. Their content isn't otherwise validated.
+		bool skip_value()
+		{
+			StringView value;
+			return read_raw_value(value);
+		}
+
+		// Skips over the next value like skip_value() and returns a raw view of it in the input
+		bool read_raw_value(StringView& value)
+		{
+			if (!skip_comments_and_whitespace_fail_if_eof())
+				return false;
+
+			const size_t start_offset = m_state.offset;
+
+			switch (m_state.symbol)
+			{
+			case '{':
+			case '[':
+				if (!skip_container())
+					return false;
+				break;
+			case '"':
+				if (!read_string(value))
+					return false;
+				break;
+			case 't':
+			case 'f':
+			{
+				bool dummy;
+				if (!read_bool(dummy))
+					return false;
+				break;
+			}
+			case 'n':
+				if (!try_read_null())
+				{
+					set_error(ParserError::ValueExpected);
+					return false;
+				}
+				break;
+			default:
+				if (!skip_number())
+					return false;
+				break;
+			}
+
+			value = StringView(m_input + start_offset, m_state.offset - start_offset);
+			return true;
+		}
+
+		const char* get_input() const { return m_input; }
+		size_t get_input_length() const { return m_input_length; }
+
 		bool remainder_is_comments_and_whitespace()
 		{
+			if (DialectType::k_root_object_has_braces && !read_closing_brace())
+				return false;
+
 			if (!skip_comments_and_whitespace())
 				return false;
 
@@ -342,11 +696,26 @@ namespace sjson
 			return true;
 		}
 
+		// Returns true when every member of the root object has been read, once comments and whitespace are skipped:
+		// at the end of the input or at the closing brace of a JSON root object which is left for remainder_is_comments_and_whitespace()
+		bool is_root_object_end()
+		{
+			if (eof())
+				return true;
+
+			const ParserState before_end = save_state();
+			if (!try_object_ends())
+				return false;
+
+			restore_state(before_end);
+			return true;
+		}
+
 		bool skip_comments_and_whitespace()
 		{
 			while (true)
 			{
-				if (eof())
+				if (is_end_of_input())
 					return true;
 
 				if (std::isspace(m_state.symbol))
@@ -355,7 +724,7 @@ namespace sjson
 					continue;
 				}
 
-				if (m_state.symbol == '/')
+				if (DialectType::k_allow_comments && m_state.symbol == '/')
 				{
 					advance();
 
@@ -380,9 +749,22 @@ namespace sjson
 		ParserError get_error() { return m_state.error; }
 		bool is_valid() const { return m_state.error.error == ParserError::None; }
 
+		// Reports an error found by code built on top of the parser, e.g. a validator, at a position in the input.
+		// The parser does not move, it is simply no longer valid.
+		void report_error(uint32_t error, uint32_t line, uint32_t column)
+		{
+			m_state.error.error = error;
+			m_state.error.line = line;
+			m_state.error.column = column;
+		}
+
 		ParserState save_state() const { return m_state; }
 		void restore_state(const ParserState& s) { m_state = s; }
-		void reset_state() { m_state = ParserState(m_input, m_input_length); }
+		void reset_state()
+		{
+			m_state = ParserState(m_input, m_input_length);
+			begin_input();
+		}
 
 	private:
 		static constexpr size_t k_max_number_length = 64;
@@ -391,13 +773,205 @@ namespace sjson
 		size_t m_input_length;
 		ParserState m_state;
 
-		bool read_equal_sign()		{ return read_symbol('=', ParserError::EqualSignExpected); }
-		bool read_opening_brace()	{ return read_symbol('{', ParserError::OpeningBraceExpected); }
-		bool read_closing_brace()	{ return read_symbol('}', ParserError::ClosingBraceExpected); }
-		bool read_opening_bracket()	{ return read_symbol('[', ParserError::OpeningBracketExpected); }
-		bool read_closing_bracket()	{ return read_symbol(']', ParserError::ClosingBracketExpected); }
+		bool read_equal_sign()		{ return read_symbol(DialectType::k_key_value_separator, DialectType::k_key_value_separator == '=' ? ParserError::EqualSignExpected : ParserError::KeyValueSeparatorExpected); }
+		bool read_opening_brace()	{ return read_symbol('{', ParserError::OpeningBraceExpected) && begin_container(); }
+		bool read_closing_brace()	{ return read_symbol('}', ParserError::ClosingBraceExpected) && end_container(); }
+		bool read_opening_bracket()	{ return read_symbol('[', ParserError::OpeningBracketExpected) && begin_container(); }
+		bool read_closing_bracket()	{ return read_symbol(']', ParserError::ClosingBracketExpected) && end_container(); }
 		bool read_comma()			{ return read_symbol(',', ParserError::CommaExpected); }
 
+		// When the dialect requires commas between object members and array elements, we track
+		// whether or not the current container already holds an entry. The next entry must then
+		// be preceded by a comma. The flag is cleared when a container begins and once a key or a separator
+		// has been read. It is set once a value ends, be it a scalar or a nested container.
+		bool begin_container()
+		{
+			begin_container_entry();
+			return true;
+		}
+
+		bool end_container()
+		{
+			end_value();
+			return true;
+		}
+
+		void begin_container_entry()
+		{
+			if (DialectType::k_require_member_commas)
+				m_state.has_previous_entry = false;
+		}
+
+		void end_value()
+		{
+			if (DialectType::k_require_member_commas)
+				m_state.has_previous_entry = true;
+		}
+
+		bool read_element_separator()
+		{
+			if (DialectType::k_require_member_commas && m_state.has_previous_entry)
+				return read_comma();
+
+			return true;
+		}
+
+		template<typename NumberType>
+		bool read_array(const char* key, NumberType* values, const ArrayShape& shape)
+		{
+			SJSON_CPP_ASSERT(shape.num_dimensions != 0 && shape.num_dimensions <= ArrayShape::k_max_num_dimensions, "Invalid number of dimensions: %u", shape.num_dimensions);
+			return read_key(key) && read_equal_sign() && read_opening_bracket() && read_array_dimension(values, shape, 0) && read_closing_bracket();
+		}
+
+		template<typename NumberType>
+		bool read_array(const char* key, NumberType* values, uint64_t max_num_elements, ArrayShape& out_shape)
+		{
+			if (!read_array_shape(key, out_shape))
+				return false;
+
+			if (out_shape.get_num_elements() > max_num_elements)
+			{
+				set_error(ParserError::LengthOutOfRange);
+				return false;
+			}
+
+			return read_array(key, values, out_shape);
+		}
+
+		// Reads the content of one dimension, the enclosing brackets are handled by the caller
+		template<typename NumberType>
+		bool read_array_dimension(NumberType* values, const ArrayShape& shape, uint32_t dimension_index)
+		{
+			const uint32_t extent = shape.extents[dimension_index];
+			if (dimension_index + 1 == shape.num_dimensions)
+				return read(values, extent);
+
+			uint64_t stride = 1;
+			for (uint32_t inner_dimension_index = dimension_index + 1; inner_dimension_index < shape.num_dimensions; ++inner_dimension_index)
+				stride *= shape.extents[inner_dimension_index];
+
+			for (uint32_t element_index = 0; element_index < extent; ++element_index)
+			{
+				if (element_index != 0 && !read_array_separator())
+					return false;
+
+				if (!array_begins() || !read_array_dimension(values + (element_index * stride), shape, dimension_index + 1) || !array_ends())
+					return false;
+			}
+
+			return true;
+		}
+
+		// Scans the array that begins at the current symbol, the parser state is only modified when an error is found
+		bool scan_array_shape(ArrayShape& out_shape)
+		{
+			bool is_first_at_depth[ArrayShape::k_max_num_dimensions] = {};
+			const char* input = m_input;
+			size_t offset = m_state.offset;
+			uint32_t depth = 0;
+			bool is_in_element = false;
+
+			out_shape = ArrayShape();
+
+			for (; offset < m_input_length; ++offset)
+			{
+				const char symbol = input[offset];
+
+				if (symbol == '[')
+				{
+					if (depth == ArrayShape::k_max_num_dimensions)
+					{
+						advance_to(offset);
+						set_error(ParserError::TooManyDimensions);
+						return false;
+					}
+
+					// Only the first array at every depth is counted
+					if (depth != 0 && is_first_at_depth[depth - 1])
+						out_shape.extents[depth - 1]++;
+
+					if (depth == out_shape.num_dimensions)
+					{
+						out_shape.num_dimensions++;
+						is_first_at_depth[depth] = true;
+					}
+
+					depth++;
+					is_in_element = false;
+				}
+				else if (symbol == ']')
+				{
+					is_first_at_depth[depth - 1] = false;
+					is_in_element = false;
+
+					if (--depth == 0)
+						return true;
+				}
+				else if (symbol == ',' || std::isspace(symbol))
+				{
+					is_in_element = false;
+				}
+				else if (DialectType::k_allow_comments && symbol == '/' && offset + 1 < m_input_length && (input[offset + 1] == '/' || input[offset + 1] == '*'))
+				{
+					// A block comment only ends on a '*/' that follows its opening '/*', '/*/' is still open
+					const bool is_line_comment = input[offset + 1] == '/';
+					const size_t comment_start = offset;
+					for (offset += 2; offset < m_input_length; ++offset)
+					{
+						if (is_line_comment ? input[offset] == '\n' : (input[offset] == '/' && offset >= comment_start + 3 && input[offset - 1] == '*'))
+							break;
+					}
+
+					is_in_element = false;
+				}
+				else if (symbol == '"' || symbol == '{')
+				{
+					advance_to(offset);
+					set_error(ParserError::NumberExpected);
+					return false;
+				}
+				else if (!is_in_element)
+				{
+					if (is_first_at_depth[depth - 1])
+						out_shape.extents[depth - 1]++;
+
+					is_in_element = true;
+				}
+			}
+
+			advance_to(m_input_length);
+			set_error(ParserError::InputTruncated);
+			return false;
+		}
+
+		// Reads comma separated elements, the recursion is resolved at compile time which unrolls the reads
+		template<typename ElementType, size_t NumElements>
+		bool read_fixed_elements(ElementType* values, std::integral_constant<size_t, NumElements>)
+		{
+			return read_fixed_elements(values, std::integral_constant<size_t, NumElements - 1>()) && read_comma() && read(values[NumElements - 1]);
+		}
+
+		template<typename ElementType>
+		bool read_fixed_elements(ElementType* values, std::integral_constant<size_t, 1>)
+		{
+			return read(values[0]);
+		}
+
+		template<typename NumberType>
+		bool read_number_columns(const char* key, const char* const* column_names, NumberType* const* columns, uint32_t num_columns, uint32_t num_rows)
+		{
+			if (!object_begins(key))
+				return false;
+
+			for (uint32_t column_index = 0; column_index < num_columns; ++column_index)
+			{
+				if (!read(column_names[column_index], columns[column_index], num_rows))
+					return false;
+			}
+
+			return object_ends();
+		}
+
 		bool read_symbol(char expected, int32_t reason_if_other_found)
 		{
 			if (!skip_comments_and_whitespace_fail_if_eof())
@@ -427,7 +1001,7 @@ namespace sjson
 
 			if (m_state.symbol == '/')
 			{
-				while (!eof() && m_state.symbol != '\n')
+				while (m_state.symbol != '\n' && !is_end_of_input())
 					advance();
 
 				return true;
@@ -440,7 +1014,7 @@ namespace sjson
 
 				while (true)
 				{
-					if (eof())
+					if (is_end_of_input())
 					{
 						set_error(ParserError::InputTruncated);
 						return false;
@@ -477,24 +1051,43 @@ namespace sjson
 			ParserState start_of_key = save_state();
 			StringView actual;
 
-			if (m_state.symbol == '"')
+			if (!read_key_name(actual))
+				return false;
+
+			if (actual != having_name)
 			{
-				if (!read_string(actual))
-					return false;
+				restore_state(start_of_key);
+				set_error(ParserError::IncorrectKey);
+				return false;
 			}
-			else
+
+			return true;
+		}
+
+		bool read_key_name(StringView& key)
+		{
+			if (!skip_comments_and_whitespace_fail_if_eof())
+				return false;
+
+			if (DialectType::k_require_member_commas)
 			{
-				if (!read_unquoted_key(actual))
+				if (!read_element_separator() || !skip_comments_and_whitespace_fail_if_eof())
 					return false;
 			}
 
-			if (actual != having_name)
+			if (DialectType::k_allow_quoted_keys && (!DialectType::k_allow_unquoted_keys || m_state.symbol == '"'))
 			{
-				restore_state(start_of_key);
-				set_error(ParserError::IncorrectKey);
-				return false;
+				if (!read_string(key))
+					return false;
+			}
+			else
+			{
+				if (!read_unquoted_key(key))
+					return false;
 			}
 
+			// What follows is the value of our new entry
+			begin_container_entry();
 			return true;
 		}
 
@@ -514,52 +1107,77 @@ namespace sjson
 
 			advance();
 
-			size_t start_offset = m_state.offset;
-			size_t end_offset;
+			const size_t start_offset = m_state.offset;
+			const impl::SymbolSet& string_symbols = impl::get_string_symbols();
+			size_t end_offset = start_offset;
 
 			while (true)
 			{
-				if (eof())
+				end_offset = find_any_of(end_offset, string_symbols);
+				if (end_offset >= m_input_length)
 				{
+					advance_to(m_input_length);
 					set_error(ParserError::InputTruncated);
 					return false;
 				}
 
-				if (m_state.symbol == '"')
-				{
-					end_offset = m_state.offset - 1;
-					advance();
+				if (m_input[end_offset] == '"')
 					break;
-				}
 
-				if (m_state.symbol == '\\')
-				{
-					// Strings are returned as slices of the input, so escape sequences cannot be un-escaped.
-					// Assume the escape sequence is valid and skip over it.
-					advance();
+				// Strings are returned as slices of the input, so escape sequences cannot be un-escaped.
+				// Assume the escape sequence is valid and skip over it, escaped unicode characters have 4 more bytes.
+				const bool is_unicode = end_offset + 1 < m_input_length && m_input[end_offset + 1] == 'u';
+				end_offset += is_unicode ? 6 : 2;
+			}
 
-					if (m_state.symbol == 'u')
-					{
-						advance();
+			advance_to(end_offset);
+			advance();
 
-						// This is an escaped unicode character, skip the 4 bytes that follow
-						advance();
-						advance();
-						advance();
-						advance();
-					}
-					else
-					{
-						advance();
-					}
-				}
-				else
-				{
-					advance();
-				}
+			value = StringView(m_input + start_offset, end_offset - start_offset);
+			end_value();
+			return true;
+		}
+
+		bool read_base64(uint8_t* buffer, size_t buffer_size, size_t& out_size)
+		{
+			if (!skip_comments_and_whitespace_fail_if_eof())
+				return false;
+
+			if (m_state.symbol != '"')
+			{
+				set_error(ParserError::QuotationMarkExpected);
+				return false;
 			}
 
-			value = StringView(m_input + start_offset, end_offset - start_offset + 1);
+			// The base64 alphabet contains neither quotation marks nor escape sequences,
+			// the string ends where the decoding stops
+			const size_t start_offset = m_state.offset + 1;
+			size_t num_symbols;
+			const impl::Base64Result result = impl::decode_base64(m_input + start_offset, m_input_length - start_offset, buffer, buffer_size, num_symbols, out_size);
+			if (result == impl::Base64Result::BufferTooSmall)
+			{
+				set_error(ParserError::LengthOutOfRange);
+				return false;
+			}
+
+			const size_t end_offset = start_offset + num_symbols;
+			if (result == impl::Base64Result::Success && end_offset >= m_input_length)
+			{
+				advance_to(m_input_length);
+				set_error(ParserError::InputTruncated);
+				return false;
+			}
+
+			if (result == impl::Base64Result::InvalidSymbol || m_input[end_offset] != '"')
+			{
+				advance_to(end_offset);
+				set_error(ParserError::InvalidBase64);
+				return false;
+			}
+
+			advance_to(end_offset);
+			advance();
+			end_value();
 			return true;
 		}
 
@@ -578,7 +1196,7 @@ namespace sjson
 
 			while (true)
 			{
-				if (eof())
+				if (is_end_of_input())
 				{
 					set_error(ParserError::InputTruncated);
 					return false;
@@ -590,7 +1208,7 @@ namespace sjson
 					return false;
 				}
 
-				if (m_state.symbol == '=')
+				if (m_state.symbol == DialectType::k_key_value_separator)
 				{
 					if (m_state.offset == start_offset)
 					{
@@ -632,6 +1250,7 @@ namespace sjson
 					m_state.symbol == 'e' && advance())
 				{
 					value = true;
+					end_value();
 					return true;
 				}
 			}
@@ -645,6 +1264,7 @@ namespace sjson
 					m_state.symbol == 'e' && advance())
 				{
 					value = false;
+					end_value();
 					return true;
 				}
 			}
@@ -662,11 +1282,15 @@ namespace sjson
 			size_t start_offset = m_state.offset;
 			size_t end_offset;
 
-			if (m_state.symbol == '-')
+			const bool is_negative = m_state.symbol == '-';
+			if (is_negative)
 				advance();
 
 			if (m_state.symbol == '0')
 			{
+				if (DialectType::k_allow_hex_floats && m_state.offset + 1 < m_input_length && (m_input[m_state.offset + 1] == 'x' || m_input[m_state.offset + 1] == 'X'))
+					return read_hex_double(is_negative, dbl_value, flt_value);
+
 				advance();
 			}
 			else if (std::isdigit(m_state.symbol))
@@ -731,6 +1355,127 @@ namespace sjson
 				return false;
 			}
 
+			end_value();
+			return true;
+		}
+
+		// Reads a C99 hexadecimal float such as 0x1.8p+1, the current symbol is the leading zero.
+		// Hexadecimal integers such as 0x10 are read as well.
+		// Its digits are the bits of the mantissa and its exponent is binary: the value is
+		// assembled exactly with a scale by a power of two, no decimal conversion is involved.
+		bool read_hex_double(bool is_negative, double* dbl_value, float* flt_value)
+		{
+			// Skip the '0x' prefix
+			advance();
+			advance();
+
+			uint64_t mantissa = 0;
+			int32_t exponent = 0;
+			bool has_digits = false;
+			bool is_fraction = false;
+			bool has_dropped_bits = false;
+
+			while (true)
+			{
+				if (m_state.symbol == '.' && !is_fraction)
+				{
+					is_fraction = true;
+					advance();
+					continue;
+				}
+
+				if (!is_hex_digit(m_state.symbol))
+					break;
+
+				// Digits past the 64 bits of the mantissa only matter for rounding, a double has 53.
+				// They are dropped while keeping track of their position and whether any of them is set.
+				const uint64_t digit_value = get_hex_digit_value(m_state.symbol);
+				if ((mantissa >> 60) != 0)
+				{
+					has_dropped_bits |= digit_value != 0;
+					exponent += is_fraction ? 0 : 4;
+				}
+				else
+				{
+					mantissa = (mantissa << 4) | digit_value;
+					exponent -= is_fraction ? 4 : 0;
+				}
+
+				has_digits = true;
+				advance();
+			}
+
+			if (!has_digits)
+			{
+				set_error(ParserError::InvalidNumber);
+				return false;
+			}
+
+			// The exponent is optional like with strtod(..), e.g. 0x10
+			if (m_state.symbol == 'p' || m_state.symbol == 'P')
+			{
+				advance();
+
+				const bool is_exponent_negative = m_state.symbol == '-';
+				if (m_state.symbol == '+' || m_state.symbol == '-')
+					advance();
+
+				if (!std::isdigit(m_state.symbol))
+				{
+					set_error(ParserError::InvalidNumber);
+					return false;
+				}
+
+				// Large exponents saturate to zero or infinity
+				int32_t binary_exponent = 0;
+				while (std::isdigit(m_state.symbol))
+				{
+					binary_exponent = std::min<int32_t>((binary_exponent * 10) + (m_state.symbol - '0'), 100000);
+					advance();
+				}
+
+				exponent += is_exponent_negative ? -binary_exponent : binary_exponent;
+			}
+
+			// The mantissa is rounded once to the precision of the target type, subnormals included,
+			// the scaling and conversions that follow are then exact
+			if (mantissa != 0)
+			{
+				const int32_t precision = dbl_value != nullptr ? 53 : 24;
+				const int32_t min_lsb_exponent = dbl_value != nullptr ? -1074 : -149;
+
+				int32_t msb_index = 63;
+				while ((mantissa >> msb_index) == 0)
+					msb_index--;
+
+				const int32_t lsb_exponent = std::max<int32_t>(exponent + msb_index - (precision - 1), min_lsb_exponent);
+				const int32_t shift = lsb_exponent - exponent;
+				if (shift > 64)
+				{
+					// Below half of the smallest subnormal
+					mantissa = 0;
+				}
+				else if (shift > 0)
+				{
+					const uint64_t half = uint64_t(1) << (shift - 1);
+					const uint64_t remainder = shift == 64 ? mantissa : (mantissa & ((half << 1) - 1));
+					const uint64_t truncated = shift == 64 ? 0 : (mantissa >> shift);
+
+					// The dropped digits act as a sticky bit below the remainder, ties round to even
+					const bool round_up = remainder > half || (remainder == half && (has_dropped_bits || (truncated & 1) != 0));
+					mantissa = truncated + (round_up ? 1 : 0);
+				}
+
+				exponent += std::max<int32_t>(shift, 0);
+			}
+
+			const double value = std::ldexp(double(mantissa), exponent);
+			if (dbl_value != nullptr)
+				*dbl_value = is_negative ? -value : value;
+			else
+				*flt_value = float(is_negative ? -value : value);
+
+			end_value();
 			return true;
 		}
 
@@ -751,7 +1496,7 @@ namespace sjson
 			{
 				advance();
 
-				if (m_state.symbol == 'x' || m_state.symbol == 'X')
+				if (DialectType::k_allow_hex_and_octal_integers && (m_state.symbol == 'x' || m_state.symbol == 'X'))
 				{
 					advance();
 					base = 16;
@@ -759,13 +1504,19 @@ namespace sjson
 					while (is_hex_digit(m_state.symbol))
 						advance();
 				}
-				else
+				else if (DialectType::k_allow_hex_and_octal_integers)
 				{
 					base = 8;
 
 					while (std::isdigit(m_state.symbol))
 						advance();
 				}
+				else if (std::isdigit(m_state.symbol) || m_state.symbol == 'x' || m_state.symbol == 'X')
+				{
+					// Leading zeros and hexadecimal prefixes are not part of this dialect
+					set_error(ParserError::InvalidNumber);
+					return false;
+				}
 			}
 			else if (std::isdigit(m_state.symbol))
 			{
@@ -778,7 +1529,8 @@ namespace sjson
 				return false;
 			}
 
-			if (m_state.symbol == '.')
+			// Hexadecimal floats have a binary exponent
+			if (m_state.symbol == '.' || (base == 16 && (m_state.symbol == 'p' || m_state.symbol == 'P')))
 			{
 				set_error(ParserError::NumberExpected);
 				return false;
@@ -827,9 +1579,107 @@ namespace sjson
 				return false;
 			}
 
+			end_value();
+			return true;
+		}
+
+		// Skips over a number without converting it, only the symbols it can contain are checked
+		bool skip_number()
+		{
+			if (m_state.symbol != '-' && !std::isdigit(m_state.symbol))
+			{
+				set_error(ParserError::ValueExpected);
+				return false;
+			}
+
+			advance();
+
+			while (std::isalnum(m_state.symbol) || m_state.symbol == '.' || m_state.symbol == '+' || m_state.symbol == '-')
+				advance();
+
+			end_value();
 			return true;
 		}
 
+		// Skips over an object or an array in bulk, see skip_value()
+		// This function assumes that the current symbol is the opening brace or bracket.
+		bool skip_container()
+		{
+			const impl::SymbolSet& container_symbols = impl::get_container_symbols(DialectType::k_allow_comments);
+			const impl::SymbolSet& string_symbols = impl::get_string_symbols();
+			const char* input = m_input;
+			const size_t input_length = m_input_length;
+			size_t offset = m_state.offset + 1;
+			uint32_t depth = 1;
+
+			while (true)
+			{
+				offset = find_any_of(offset, container_symbols);
+				if (offset >= input_length)
+					break;
+
+				const char symbol = input[offset];
+
+				if (symbol == '"')
+				{
+					for (offset = find_any_of(offset + 1, string_symbols); offset < input_length && input[offset] != '"'; offset = find_any_of(offset + 2, string_symbols))
+						;	// Skip escape sequences
+
+					if (offset >= input_length)
+						break;
+				}
+				else if (symbol == '{' || symbol == '[')
+				{
+					++depth;
+				}
+				else if (symbol == '}' || symbol == ']')
+				{
+					if (--depth == 0)
+					{
+						advance_to(offset + 1);
+						end_value();
+						return true;
+					}
+				}
+				else if (offset + 1 < input_length)
+				{
+					// Only comments remain
+					if (input[offset + 1] == '/')
+					{
+						const void* end_of_line = std::memchr(input + offset, '\n', input_length - offset);
+						if (end_of_line == nullptr)
+							break;
+
+						offset = size_t(static_cast<const char*>(end_of_line) - input);
+					}
+					else if (input[offset + 1] == '*')
+					{
+						for (offset += 2; offset + 1 < input_length; ++offset)
+						{
+							if (input[offset] == '*' && input[offset + 1] == '/')
+								break;
+						}
+
+						++offset;
+					}
+				}
+
+				++offset;
+			}
+
+			advance_to(input_length);
+			set_error(ParserError::InputTruncated);
+			return false;
+		}
+
+		static uint64_t get_hex_digit_value(char value)
+		{
+			if (std::isdigit(value))
+				return uint64_t(value - '0');
+
+			return uint64_t((value | 0x20) - 'a' + 10);
+		}
+
 		static bool is_hex_digit(char value)
 		{
 			return std::isdigit(value)
@@ -858,6 +1708,7 @@ namespace sjson
 					m_state.symbol == 'l' && advance() &&
 					m_state.symbol == 'l' && advance())
 				{
+					end_value();
 					return true;
 				}
 			}
@@ -880,6 +1731,15 @@ namespace sjson
 			return true;
 		}
 
+		void begin_input()
+		{
+			if (DialectType::k_skip_bom)
+				skip_bom();
+
+			if (DialectType::k_root_object_has_braces)
+				read_opening_brace();
+		}
+
 		void skip_bom()
 		{
 			ParserState initial_state = save_state();
@@ -903,8 +1763,61 @@ namespace sjson
 				restore_state(initial_state);
 		}
 
+		// Moves forward up to the provided offset while keeping track of lines and columns like advance() does
+		void advance_to(size_t offset)
+		{
+			const size_t end_offset = std::min(offset, m_input_length);
+
+			// Every symbol we move onto is accounted for, up to the last symbol of the input
+			const size_t last_offset = std::min(end_offset, m_input_length == 0 ? 0 : m_input_length - 1);
+			if (last_offset > m_state.offset)
+			{
+				const char* cursor = m_input + m_state.offset + 1;
+				const char* end = m_input + last_offset + 1;
+				const char* last_newline = nullptr;
+
+				while (const void* newline = std::memchr(cursor, '\n', size_t(end - cursor)))
+				{
+					++m_state.line;
+					last_newline = static_cast<const char*>(newline);
+					cursor = last_newline + 1;
+				}
+
+				if (last_newline != nullptr)
+					m_state.column = 1 + uint32_t(end - 1 - last_newline);
+				else
+					m_state.column += uint32_t(last_offset - m_state.offset);
+			}
+
+			m_state.offset = end_offset;
+			m_state.symbol = end_offset < m_input_length ? m_input[end_offset] : '\0';
+		}
+
 		bool advance()
 		{
+			if (DialectType::k_input_is_padded)
+			{
+				// The padding guarantees that the symbol past the end is NUL, we only need to make sure we never move beyond it
+				if (m_state.symbol == '\0' && eof())
+					return false;
+
+				m_state.offset++;
+				m_state.symbol = m_input[m_state.offset];
+
+				// Like the checked path, the end of the input has the position of the last symbol
+				if (m_state.symbol == '\n')
+				{
+					++m_state.line;
+					m_state.column = 1;
+				}
+				else if (m_state.symbol != '\0' || m_state.offset < m_input_length)
+				{
+					m_state.column++;
+				}
+
+				return true;
+			}
+
 			if (eof())
 				return false;
 
@@ -932,6 +1845,18 @@ namespace sjson
 			return true;
 		}
 
+		// The current symbol is always NUL at the end of the input, checking it first
+		// avoids the bounds check for every other symbol
+		bool is_end_of_input() const { return m_state.symbol == '\0' && m_state.offset >= m_input_length; }
+
+		// Returns the offset of the next symbol of the set or the input length if there is none, see kernels.h
+		// Padded input allows vector kernels to read past the end without handling the tail separately.
+		size_t find_any_of(size_t offset, const impl::SymbolSet& symbols) const
+		{
+			const size_t readable_length = DialectType::k_input_is_padded ? (m_input_length + k_input_padding) : m_input_length;
+			return get_kernels().find_any_of(m_input, offset, m_input_length, readable_length, symbols);
+		}
+
 		void set_error(int32_t error)
 		{
 			m_state.error.error = error;
@@ -939,4 +1864,10 @@ namespace sjson
 			m_state.error.column = m_state.column;
 		}
 	};
+
+	// The default parser supports the full SJSON syntax
+	using Parser = BasicParser<SJSONDialect>;
+
+	// A parser that reads standard JSON using the same code paths
+	using JSONParser = BasicParser<JSONDialect>;
 }
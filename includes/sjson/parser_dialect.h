@@ -0,0 +1,145 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+// The MIT License (MIT)
+//
+// Copyright (c) 2018 Nicholas Frechette, Cody Jones, and sjson-cpp contributors
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <cstring>
+
+namespace sjson
+{
+	//////////////////////////////////////////////////////////////////////////
+	// A dialect controls which syntax features the parser accepts.
+	// Every feature is a compile time constant: when a feature is disabled, the code
+	// that handles it is stripped from the parser entirely.
+	//
+	// To create a custom dialect, derive from an existing one and override what you need:
+	// struct MyDialect : public SJSONDialect
+	// {
+	//     static constexpr bool k_allow_comments = false;
+	// };
+	//////////////////////////////////////////////////////////////////////////
+
+	// The default dialect, everything supported by SJSON is enabled
+	struct SJSONDialect
+	{
+		// Whether or not C and C++ style comments are allowed
+		// e.g. // this is a comment
+		//      /* this is also a comment */
+		static constexpr bool k_allow_comments = true;
+
+		// Whether or not keys can be quoted
+		// e.g. "key" = true
+		static constexpr bool k_allow_quoted_keys = true;
+
+		// Whether or not keys can be unquoted
+		// e.g. key = true
+		static constexpr bool k_allow_unquoted_keys = true;
+
+		// Whether or not integers can be written in hexadecimal or octal
+		// e.g. key = 0x1F
+		//      key = 017
+		static constexpr bool k_allow_hex_and_octal_integers = true;
+
+		// Whether or not floating point numbers can be written in the exact C99 hexadecimal form,
+		// as output by the writer with WriterSettings::use_hex_floats
+		// e.g. key = 0x1.8p+1
+		static constexpr bool k_allow_hex_floats = true;
+
+		// Whether or not the UTF-8 BOM is skipped if present
+		static constexpr bool k_skip_bom = true;
+
+		// The symbol that separates a key from its value
+		static constexpr char k_key_value_separator = '=';
+
+		// Whether or not object members must be separated by commas
+		// e.g. "key0": true, "key1": false
+		// Array elements are always separated by commas regardless.
+		static constexpr bool k_require_member_commas = false;
+
+		// Whether or not the root object is enclosed in braces
+		// When enabled, the braces are consumed transparently when the parser is created
+		// and by remainder_is_comments_and_whitespace().
+		static constexpr bool k_root_object_has_braces = false;
+
+		// Whether or not the input is followed by k_input_padding NUL bytes, see PaddedInputDialect
+		static constexpr bool k_input_is_padded = false;
+	};
+
+	// A dialect suitable for machine generated SJSON such as the one output by our writer:
+	// no comments, unquoted keys only, and decimal numbers only.
+	struct MinimalSJSONDialect : public SJSONDialect
+	{
+		static constexpr bool k_allow_comments = false;
+		static constexpr bool k_allow_quoted_keys = false;
+		static constexpr bool k_allow_hex_and_octal_integers = false;
+		static constexpr bool k_allow_hex_floats = false;
+		static constexpr bool k_skip_bom = false;
+	};
+
+	// Standard JSON: quoted keys, ':' separators, commas between members, and a root object
+	// enclosed in braces. Reading code written for SJSON can read the equivalent JSON unchanged.
+	struct JSONDialect : public SJSONDialect
+	{
+		static constexpr bool k_allow_comments = false;
+		static constexpr bool k_allow_unquoted_keys = false;
+		static constexpr bool k_allow_hex_and_octal_integers = false;
+		static constexpr bool k_allow_hex_floats = false;
+		static constexpr char k_key_value_separator = ':';
+		static constexpr bool k_require_member_commas = true;
+		static constexpr bool k_root_object_has_braces = true;
+	};
+
+	// The number of NUL bytes that must follow the input of a padded dialect.
+	// It is large enough for any kernel to read a full vector past the last symbol.
+	constexpr size_t k_input_padding = 64;
+
+	// Enables padded input on top of any dialect. The caller guarantees that the input is followed
+	// by k_input_padding NUL bytes which allows the parser to drop the bounds checks of its inner loops:
+	// the end of the input is only checked for when a NUL symbol is found.
+	// The input length provided to the parser excludes the padding.
+	//
+	// char buffer[...];
+	// make_padded_input(input, input_length, buffer, get_padded_input_size(input_length));
+	// BasicParser<PaddedInputDialect<SJSONDialect>> parser(buffer, input_length);
+	template<class DialectType>
+	struct PaddedInputDialect : public DialectType
+	{
+		static constexpr bool k_input_is_padded = true;
+	};
+
+	// Returns the size of the buffer required to hold a padded copy of an input
+	inline size_t get_padded_input_size(size_t input_length) { return input_length + k_input_padding; }
+
+	// Copies an input into a buffer and pads it, returns false if the buffer is too small
+	inline bool make_padded_input(const char* input, size_t input_length, char* out_buffer, size_t buffer_size)
+	{
+		if (buffer_size < get_padded_input_size(input_length))
+			return false;
+
+		std::memcpy(out_buffer, input, input_length);
+		std::memset(out_buffer + input_length, 0, k_input_padding);
+		return true;
+	}
+}
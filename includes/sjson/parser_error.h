@@ -58,6 +58,21 @@ namespace sjson
 			InvalidNumber,
 			NumberCouldNotBeConverted,
 			UnexpectedContentAtEnd,
+			KeyValueSeparatorExpected,
+			ValueExpected,
+			TypeMismatch,
+			RequiredKeyMissing,
+			ValueOutOfRange,
+			LengthOutOfRange,
+			UnexpectedKey,
+			FileCouldNotBeRead,
+			TooManyDimensions,
+			InvalidBase64,
+			IncludeCycle,
+			OverlappingPaths,
+			InvalidSchema,
+			TooManyPaths,
+			InputTooLarge,
 
 			Last
 		};
@@ -108,6 +123,36 @@ namespace sjson
 				return "This number could not be converted";
 			case UnexpectedContentAtEnd:
 				return "There should not be any more content in this file";
+			case KeyValueSeparatorExpected:
+				return "A key/value separator is expected here";
+			case ValueExpected:
+				return "A value is expected here";
+			case TypeMismatch:
+				return "This value does not have the type required by the schema";
+			case RequiredKeyMissing:
+				return "A key required by the schema is missing from this object";
+			case ValueOutOfRange:
+				return "This value is outside the range allowed by the schema";
+			case LengthOutOfRange:
+				return "The length of this value is outside the allowed range";
+			case UnexpectedKey:
+				return "This key is not part of the schema";
+			case FileCouldNotBeRead:
+				return "The file could not be opened or read";
+			case TooManyDimensions:
+				return "This array has too many dimensions; increase ArrayShape::k_max_num_dimensions";
+			case InvalidBase64:
+				return "This string is not valid base64";
+			case IncludeCycle:
+				return "This file is included by one of the files it includes";
+			case OverlappingPaths:
+				return "Two paths refer to the same value or one contains the other";
+			case InvalidSchema:
+				return "The schema has too many fields or a field whose parent is not described before it";
+			case TooManyPaths:
+				return "Too many paths or path segments are looked up at once; see PathQuery::k_max_num_paths and k_max_num_segments";
+			case InputTooLarge:
+				return "The input is larger than the 4 GB that 32 bit offsets can address";
 			default:
 				return "Unknown error";
 			}
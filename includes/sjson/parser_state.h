@@ -38,6 +38,7 @@ namespace sjson
 			, line(1)
 			, column(1)
 			, symbol(input_length > 0 ? input[0] : '\0')
+			, has_previous_entry(false)
 			, error()
 		{
 		}
@@ -47,6 +48,9 @@ namespace sjson
 		uint32_t column;
 		char symbol;
 
+		// Only used by dialects that require commas between object members
+		bool has_previous_entry;
+
 		ParserError error;
 	};
 }
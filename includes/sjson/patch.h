@@ -0,0 +1,260 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+// The MIT License (MIT)
+//
+// Copyright (c) 2018 Nicholas Frechette, Cody Jones, and sjson-cpp contributors
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "sjson/error.h"
+#include "sjson/parser.h"
+#include "sjson/parser_error.h"
+#include "sjson/path_query.h"
+#include "sjson/string_view.h"
+#include "sjson/writer.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+namespace sjson
+{
+	//////////////////////////////////////////////////////////////////////////
+	// The new value of a patched path, numbers are written like the Writer does.
+	// Strings and raw values are not copied and must outlive the patch.
+	// Quotation marks and backslashes in strings are escaped, raw values are written as is.
+	//////////////////////////////////////////////////////////////////////////
+	class PatchValue
+	{
+	public:
+		PatchValue(bool value) : PatchValue(value ? "true" : "false", false) {}
+		PatchValue(double value) : PatchValue("%.17g", value) {}
+		PatchValue(float value) : PatchValue("%.17g", double(value)) {}
+		PatchValue(int32_t value) : PatchValue("%" PRId64, int64_t(value)) {}
+		PatchValue(uint32_t value) : PatchValue("%" PRIu64, uint64_t(value)) {}
+		PatchValue(int64_t value) : PatchValue("%" PRId64, value) {}
+		PatchValue(uint64_t value) : PatchValue("%" PRIu64, value) {}
+
+		// A string value, it is written between quotation marks
+		PatchValue(const char* value) : PatchValue(value, true) {}
+
+		// A value written as is, e.g. an object or an array: PatchValue::raw("[ 1, 2, 3 ]")
+		static PatchValue raw(const char* value) { return PatchValue(value, false); }
+
+		inline void write(StreamWriter& stream_writer) const;
+
+	private:
+		static constexpr size_t k_max_formatted_length = 32;
+
+		PatchValue(const char* value, bool is_quoted)
+			: m_value(value)
+			, m_length(std::strlen(value))
+			, m_is_quoted(is_quoted)
+			, m_buffer()
+		{}
+
+		template<typename NumberType>
+		PatchValue(const char* format, NumberType value)
+			: m_value(nullptr)
+			, m_length(0)
+			, m_is_quoted(false)
+			, m_buffer()
+		{
+			const int length = snprintf(m_buffer, sizeof(m_buffer), format, value);
+			SJSON_CPP_ASSERT(length > 0 && size_t(length) < sizeof(m_buffer), "Failed to format patch value");
+			m_length = size_t(length);
+		}
+
+		// Formatted numbers live in the buffer, this keeps the value valid when it is copied
+		const char* m_value;
+		size_t m_length;
+		bool m_is_quoted;
+		char m_buffer[k_max_formatted_length];
+	};
+
+	struct PatchEdit
+	{
+		const char* path;
+		PatchValue value;
+	};
+
+	//////////////////////////////////////////////////////////////////////////
+	// A patch replaces the values of one or more paths without re-serializing the document.
+	// The target values are located with a PathQuery and everything in between them is copied
+	// verbatim, comments and formatting included. Paths use the PathQuery syntax.
+	//
+	// PatchEdit edits[] = { { "settings.render.width", 1920 }, { "settings.render.name", "ultra" } };
+	// DocumentPatch patch(edits, 2);
+	// if (!patch.apply(parser, stream_writer))
+	//     parser.get_error() ...
+	//
+	// The input is only parsed until every path has been found, the remainder is copied as is.
+	// Paths must not overlap, e.g. 'a' and 'a.b' or the same path twice cannot be patched together.
+	// Overlapping paths fail with OverlappingPaths before anything is written.
+	// A patch with more than k_max_num_edits edits fails with TooManyPaths.
+	// Nothing is written when a path cannot be found, it fails with RequiredKeyMissing and
+	// get_error_edit_index() returns the edit that caused it.
+	// Edits are not copied and must outlive the patch.
+	//////////////////////////////////////////////////////////////////////////
+	class DocumentPatch
+	{
+	public:
+		static constexpr uint32_t k_max_num_edits = PathQuery::k_max_num_paths;
+		static constexpr uint32_t k_invalid_edit_index = 0xFFFFFFFFu;
+
+		inline DocumentPatch(const PatchEdit* edits, uint32_t num_edits);
+
+		// Applies the edits to the input of the parser which must be at its beginning
+		template<class DialectType>
+		inline bool apply(BasicParser<DialectType>& parser, StreamWriter& output);
+
+		uint32_t get_error_edit_index() const { return m_error_edit_index; }
+
+	private:
+		DocumentPatch(const DocumentPatch&) = delete;
+		DocumentPatch& operator=(const DocumentPatch&) = delete;
+
+		const PatchEdit* m_edits;
+		uint32_t m_num_edits;
+		uint32_t m_error_edit_index;
+	};
+
+	//////////////////////////////////////////////////////////////////////////
+
+	inline void PatchValue::write(StreamWriter& stream_writer) const
+	{
+		if (!m_is_quoted)
+		{
+			stream_writer.write(m_value != nullptr ? m_value : m_buffer, m_length);
+			return;
+		}
+
+		stream_writer.write("\"", 1);
+
+		// Characters are written in runs, only a quotation mark or a backslash breaks one
+		const char* run_start = m_value;
+		const char* value_end = m_value + m_length;
+		for (const char* symbol = m_value; symbol != value_end; ++symbol)
+		{
+			if (*symbol == '"' || *symbol == '\\')
+			{
+				stream_writer.write(run_start, size_t(symbol - run_start));
+				stream_writer.write("\\", 1);
+				run_start = symbol;
+			}
+		}
+
+		stream_writer.write(run_start, size_t(value_end - run_start));
+		stream_writer.write("\"", 1);
+	}
+
+	inline DocumentPatch::DocumentPatch(const PatchEdit* edits, uint32_t num_edits)
+		: m_edits(edits)
+		, m_num_edits(num_edits)
+		, m_error_edit_index(k_invalid_edit_index)
+	{}
+
+	template<class DialectType>
+	inline bool DocumentPatch::apply(BasicParser<DialectType>& parser, StreamWriter& output)
+	{
+		m_error_edit_index = k_invalid_edit_index;
+
+		if (m_num_edits > k_max_num_edits)
+		{
+			uint32_t line;
+			uint32_t column;
+			parser.get_position(line, column);
+			parser.report_error(ParserError::TooManyPaths, line, column);
+			return false;
+		}
+
+		const char* paths[k_max_num_edits];
+		for (uint32_t edit_index = 0; edit_index < m_num_edits; ++edit_index)
+			paths[edit_index] = m_edits[edit_index].path;
+
+		PathQuery query(paths, m_num_edits);
+		if (!query.evaluate(parser))
+			return false;
+
+		for (uint32_t edit_index = 0; edit_index < m_num_edits; ++edit_index)
+		{
+			if (!query.get_result(edit_index).is_found)
+			{
+				uint32_t line;
+				uint32_t column;
+				parser.get_position(line, column);
+				parser.report_error(ParserError::RequiredKeyMissing, line, column);
+
+				m_error_edit_index = edit_index;
+				return false;
+			}
+		}
+
+		// Values are spliced in input order
+		uint32_t edit_order[k_max_num_edits];
+		for (uint32_t edit_index = 0; edit_index < m_num_edits; ++edit_index)
+			edit_order[edit_index] = edit_index;
+
+		// Ties are broken by edit index so that the later of two identical paths is reported
+		std::sort(edit_order, edit_order + m_num_edits, [&query](uint32_t lhs, uint32_t rhs)
+		{
+			const char* lhs_start = query.get_result(lhs).raw_value.c_str();
+			const char* rhs_start = query.get_result(rhs).raw_value.c_str();
+			return lhs_start < rhs_start || (lhs_start == rhs_start && lhs < rhs);
+		});
+
+		// A value that starts before the previous one ends is contained in it
+		for (uint32_t order_index = 1; order_index < m_num_edits; ++order_index)
+		{
+			const StringView& previous = query.get_result(edit_order[order_index - 1]).raw_value;
+			const StringView& target = query.get_result(edit_order[order_index]).raw_value;
+			if (target.c_str() < previous.c_str() + previous.size())
+			{
+				uint32_t line;
+				uint32_t column;
+				parser.get_position(line, column);
+				parser.report_error(ParserError::OverlappingPaths, line, column);
+
+				m_error_edit_index = edit_order[order_index];
+				return false;
+			}
+		}
+
+		const char* input = parser.get_input();
+		const char* input_end = input + parser.get_input_length();
+		const char* copy_start = input;
+
+		for (uint32_t order_index = 0; order_index < m_num_edits; ++order_index)
+		{
+			const uint32_t edit_index = edit_order[order_index];
+			const StringView& target = query.get_result(edit_index).raw_value;
+
+			output.write(copy_start, size_t(target.c_str() - copy_start));
+			m_edits[edit_index].value.write(output);
+			copy_start = target.c_str() + target.size();
+		}
+
+		output.write(copy_start, size_t(input_end - copy_start));
+		return true;
+	}
+}
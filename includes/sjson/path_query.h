@@ -0,0 +1,359 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+// The MIT License (MIT)
+//
+// Copyright (c) 2018 Nicholas Frechette, Cody Jones, and sjson-cpp contributors
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "sjson/parser.h"
+#include "sjson/parser_error.h"
+#include "sjson/parser_state.h"
+#include "sjson/string_view.h"
+
+#include <cctype>
+#include <cstdint>
+
+namespace sjson
+{
+	struct PathQueryResult
+	{
+		PathQueryResult()
+			: raw_value()
+			, type(ValueType::Unknown)
+			, line(0)
+			, column(0)
+			, is_found(false)
+		{}
+
+		// A raw view of the value in the input, strings retain their quotation marks
+		StringView raw_value;
+
+		ValueType type;
+
+		// Where the value begins in the input
+		uint32_t line;
+		uint32_t column;
+
+		bool is_found;
+
+		// Converts the raw value into the requested type, any type supported by Parser::read(value) can be used
+		template<typename DestinationType>
+		bool get(DestinationType& value) const
+		{
+			if (!is_found)
+				return false;
+
+			Parser parser(raw_value.c_str(), raw_value.size());
+			return parser.read(value) && parser.eof();
+		}
+	};
+
+	//////////////////////////////////////////////////////////////////////////
+	// A path query finds the values of one or more paths in a single pass over the input.
+	// Subtrees that cannot contain any of the paths are skipped in bulk.
+	//
+	// Paths are made of keys and array indices separated by '.':
+	//    settings.render.shadows.resolution
+	//    settings.render.lights.2.intensity
+	// A JSON Pointer can be used as well when the path starts with '/':
+	//    /settings/render/lights/2/intensity
+	// Escaped symbols are not supported in either form.
+	//
+	// const char* paths[] = { "render.width", "render.height" };
+	// PathQuery query(paths, 2);
+	// if (query.evaluate(parser))
+	//     query.get_result(0).get(width);
+	//
+	// Evaluation starts at the current parser position which must be within an object (e.g. the root)
+	// and it stops as soon as every path has been found.
+	// A query with more than k_max_num_paths paths or k_max_num_segments segments in total is invalid,
+	// evaluating it fails with ParserError::TooManyPaths.
+	// Paths are not copied and must outlive the query.
+	//////////////////////////////////////////////////////////////////////////
+	class PathQuery
+	{
+	public:
+		static constexpr uint32_t k_max_num_paths = 64;
+		static constexpr uint32_t k_max_num_segments = 256;
+
+		inline PathQuery(const char* const* paths, uint32_t num_paths);
+
+		template<class DialectType>
+		inline bool evaluate(BasicParser<DialectType>& parser);
+
+		// Whether or not the paths fit within the limits of a query
+		bool is_valid() const { return m_is_valid; }
+
+		uint32_t get_num_paths() const { return m_num_paths; }
+		const PathQueryResult& get_result(uint32_t path_index) const { return m_results[path_index]; }
+
+		// Returns how many paths have not been found by the last evaluation
+		uint32_t get_num_missing() const { return m_num_pending; }
+
+	private:
+		static constexpr uint32_t k_invalid_index = 0xFFFFFFFFu;
+
+		struct Segment
+		{
+			StringView key;
+
+			// Set when the segment is a valid array index
+			uint32_t index;
+		};
+
+		PathQuery(const PathQuery&) = delete;
+		PathQuery& operator=(const PathQuery&) = delete;
+
+		template<class DialectType>
+		inline bool evaluate_members(BasicParser<DialectType>& parser, uint32_t depth, uint64_t candidates, bool is_root);
+
+		template<class DialectType>
+		inline bool evaluate_elements(BasicParser<DialectType>& parser, uint32_t depth, uint64_t candidates);
+
+		template<class DialectType>
+		inline bool evaluate_value(BasicParser<DialectType>& parser, uint32_t depth, uint64_t matches, uint64_t prefixes);
+
+		template<typename MatchFunction>
+		inline void match_segment(uint32_t depth, uint64_t candidates, MatchFunction match, uint64_t& out_matches, uint64_t& out_prefixes) const;
+
+		Segment m_segments[k_max_num_segments];
+		uint32_t m_path_first_segment[k_max_num_paths];
+		uint32_t m_path_num_segments[k_max_num_paths];
+		PathQueryResult m_results[k_max_num_paths];
+
+		uint32_t m_num_paths;
+		uint32_t m_num_pending;
+		bool m_is_valid;
+	};
+
+	//////////////////////////////////////////////////////////////////////////
+
+	inline PathQuery::PathQuery(const char* const* paths, uint32_t num_paths)
+		: m_num_paths(num_paths)
+		, m_num_pending(0)
+		, m_is_valid(true)
+	{
+		if (num_paths > k_max_num_paths)
+		{
+			m_num_paths = 0;
+			m_is_valid = false;
+			return;
+		}
+
+		uint32_t num_segments = 0;
+		for (uint32_t path_index = 0; path_index < num_paths; ++path_index)
+		{
+			const char* path = paths[path_index];
+			char separator = '.';
+			if (path[0] == '/')
+			{
+				separator = '/';
+				path++;
+			}
+
+			m_path_first_segment[path_index] = num_segments;
+
+			while (true)
+			{
+				const char* segment_end = path;
+				while (*segment_end != '\0' && *segment_end != separator)
+					segment_end++;
+
+				if (num_segments == k_max_num_segments)
+				{
+					m_num_paths = 0;
+					m_is_valid = false;
+					return;
+				}
+
+				Segment& segment = m_segments[num_segments++];
+				segment.key = StringView(path, segment_end - path);
+				segment.index = k_invalid_index;
+
+				if (segment_end != path && segment_end - path < 10)
+				{
+					uint32_t index = 0;
+					const char* digit = path;
+					for (; digit != segment_end && std::isdigit(*digit); ++digit)
+						index = (index * 10) + uint32_t(*digit - '0');
+
+					if (digit == segment_end)
+						segment.index = index;
+				}
+
+				if (*segment_end == '\0')
+					break;
+
+				path = segment_end + 1;
+			}
+
+			m_path_num_segments[path_index] = num_segments - m_path_first_segment[path_index];
+		}
+	}
+
+	template<class DialectType>
+	inline bool PathQuery::evaluate(BasicParser<DialectType>& parser)
+	{
+		for (uint32_t path_index = 0; path_index < m_num_paths; ++path_index)
+			m_results[path_index] = PathQueryResult();
+
+		if (!m_is_valid)
+		{
+			uint32_t line;
+			uint32_t column;
+			parser.get_position(line, column);
+			parser.report_error(ParserError::TooManyPaths, line, column);
+			return false;
+		}
+
+		m_num_pending = m_num_paths;
+		if (m_num_paths == 0)
+			return true;
+
+		const uint64_t candidates = m_num_paths == 64 ? ~uint64_t(0) : ((uint64_t(1) << m_num_paths) - 1);
+		return evaluate_members(parser, 0, candidates, true);
+	}
+
+	template<class DialectType>
+	inline bool PathQuery::evaluate_members(BasicParser<DialectType>& parser, uint32_t depth, uint64_t candidates, bool is_root)
+	{
+		StringView key;
+
+		while (m_num_pending != 0)
+		{
+			if (is_root)
+			{
+				if (!parser.skip_comments_and_whitespace())
+					return false;
+
+				if (parser.is_root_object_end())
+					return true;
+			}
+			else if (parser.try_object_ends())
+				return true;
+
+			if (!parser.read_next_key(key))
+				return false;
+
+			uint64_t matches;
+			uint64_t prefixes;
+			match_segment(depth, candidates, [&key](const Segment& segment) { return segment.key == key; }, matches, prefixes);
+
+			if (!evaluate_value(parser, depth + 1, matches, prefixes))
+				return false;
+		}
+
+		return true;
+	}
+
+	template<class DialectType>
+	inline bool PathQuery::evaluate_elements(BasicParser<DialectType>& parser, uint32_t depth, uint64_t candidates)
+	{
+		if (!parser.array_begins())
+			return false;
+
+		uint32_t index = 0;
+		while (m_num_pending != 0)
+		{
+			if (parser.try_array_ends())
+				return true;
+
+			if (index != 0 && !parser.read_array_separator())
+				return false;
+
+			uint64_t matches;
+			uint64_t prefixes;
+			match_segment(depth, candidates, [index](const Segment& segment) { return segment.index == index; }, matches, prefixes);
+
+			if (!evaluate_value(parser, depth + 1, matches, prefixes))
+				return false;
+
+			index++;
+		}
+
+		return true;
+	}
+
+	template<class DialectType>
+	inline bool PathQuery::evaluate_value(BasicParser<DialectType>& parser, uint32_t depth, uint64_t matches, uint64_t prefixes)
+	{
+		if (matches == 0 && prefixes == 0)
+			return parser.skip_value();
+
+		const ValueType type = parser.peek_value_type();
+		const ParserState start_of_value = parser.save_state();
+
+		if (prefixes != 0 && type == ValueType::Object)
+		{
+			if (!parser.object_begins() || !evaluate_members(parser, depth, prefixes, false))
+				return false;
+		}
+		else if (prefixes != 0 && type == ValueType::Array)
+		{
+			if (!evaluate_elements(parser, depth, prefixes))
+				return false;
+		}
+		else if (!parser.skip_value())
+			return false;
+
+		// Paths that end here are still pending which guarantees that the value has been fully read
+		const size_t end_offset = parser.save_state().offset;
+		for (uint32_t path_index = 0; path_index < m_num_paths; ++path_index)
+		{
+			PathQueryResult& result = m_results[path_index];
+			if ((matches & (uint64_t(1) << path_index)) == 0 || result.is_found)
+				continue;
+
+			result.raw_value = StringView(parser.get_input() + start_of_value.offset, end_offset - start_of_value.offset);
+			result.type = type;
+			result.line = start_of_value.line;
+			result.column = start_of_value.column;
+			result.is_found = true;
+			m_num_pending--;
+		}
+
+		return true;
+	}
+
+	template<typename MatchFunction>
+	inline void PathQuery::match_segment(uint32_t depth, uint64_t candidates, MatchFunction match, uint64_t& out_matches, uint64_t& out_prefixes) const
+	{
+		out_matches = 0;
+		out_prefixes = 0;
+
+		for (uint32_t path_index = 0; path_index < m_num_paths; ++path_index)
+		{
+			const uint64_t path_bit = uint64_t(1) << path_index;
+			if ((candidates & path_bit) == 0 || m_results[path_index].is_found)
+				continue;
+
+			const uint32_t num_segments = m_path_num_segments[path_index];
+			if (depth >= num_segments || !match(m_segments[m_path_first_segment[path_index] + depth]))
+				continue;
+
+			if (depth + 1 == num_segments)
+				out_matches |= path_bit;
+			else
+				out_prefixes |= path_bit;
+		}
+	}
+}
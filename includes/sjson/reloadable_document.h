@@ -0,0 +1,203 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+// The MIT License (MIT)
+//
+// Copyright (c) 2018 Nicholas Frechette, Cody Jones, and sjson-cpp contributors
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "sjson/document.h"
+#include "sjson/file_reader.h"
+#include "sjson/parser_dialect.h"
+#include "sjson/parser_error.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// The free atomic_load/atomic_store overloads for shared_ptr are deprecated in C++20
+#if defined(__cpp_lib_atomic_shared_ptr) && __cpp_lib_atomic_shared_ptr >= 201711L
+	#define SJSON_CPP_HAS_ATOMIC_SHARED_PTR
+#endif
+
+namespace sjson
+{
+	//////////////////////////////////////////////////////////////////////////
+	// A reloadable document publishes immutable documents to concurrent readers.
+	//
+	// New documents are fully built before they are published with an atomic pointer swap:
+	// readers never wait for a reload to parse and never observe a partially built document.
+	// The swap itself is not lock free: std::atomic<std::shared_ptr> (C++20) and the older
+	// std::atomic_load/std::atomic_store overloads guard the reference count update with a short
+	// internal lock, the latter from a global pool shared by every shared_ptr in the process.
+	// Readers that hold on to a document for a while should keep it rather than calling get() often.
+	// Readers keep the document they acquired alive for as long as they hold it, the previous
+	// document is released once its last reader lets go of it.
+	//
+	// Reader threads:
+	//    std::shared_ptr<const Document> document = config.get();
+	//    document->find("render.width").get(width);
+	//
+	// Reload thread, e.g. when a file watcher reports a change:
+	//    config.reload_file_in_background("config.sjson");
+	//
+	// A reload that fails leaves the current document untouched.
+	// Reloads must be requested from a single thread at a time. A reload first waits for the background
+	// reload in flight, if any, so reloads are published in the order they are requested.
+	//////////////////////////////////////////////////////////////////////////
+	class ReloadableDocument
+	{
+	public:
+		ReloadableDocument()
+			: m_document()
+			, m_reload_thread()
+			, m_last_error()
+			, m_generation(0)
+			, m_last_reload_succeeded(true)
+		{}
+
+		explicit ReloadableDocument(std::shared_ptr<const Document> document)
+			: m_document(std::move(document))
+			, m_reload_thread()
+			, m_last_error()
+			, m_generation(0)
+			, m_last_reload_succeeded(true)
+		{}
+
+		~ReloadableDocument() { wait_for_reload(); }
+
+		// Returns the current document, it can be null if nothing has been published yet
+#if defined(SJSON_CPP_HAS_ATOMIC_SHARED_PTR)
+		std::shared_ptr<const Document> get() const { return m_document.load(std::memory_order_acquire); }
+#else
+		std::shared_ptr<const Document> get() const { return std::atomic_load(&m_document); }
+#endif
+
+		// Incremented every time a document is published
+		uint32_t get_generation() const { return m_generation.load(std::memory_order_acquire); }
+
+		void publish(std::shared_ptr<const Document> document)
+		{
+#if defined(SJSON_CPP_HAS_ATOMIC_SHARED_PTR)
+			m_document.store(std::move(document), std::memory_order_release);
+#else
+			std::atomic_store(&m_document, std::move(document));
+#endif
+			m_generation.fetch_add(1, std::memory_order_release);
+		}
+
+		// Builds a new document on the calling thread and publishes it if it is valid
+		template<class DialectType = SJSONDialect>
+		bool reload(const char* input, size_t input_length)
+		{
+			wait_for_reload();
+			m_last_reload_succeeded = build_and_publish<DialectType>(input, input_length);
+			return m_last_reload_succeeded;
+		}
+
+		template<class DialectType = SJSONDialect>
+		bool reload_file(const char* path)
+		{
+			wait_for_reload();
+			m_last_reload_succeeded = build_and_publish_file<DialectType>(path);
+			return m_last_reload_succeeded;
+		}
+
+		// Builds and publishes a new document on a background thread, a reload still in flight is waited on first
+		template<class DialectType = SJSONDialect>
+		void reload_in_background(std::string input)
+		{
+			wait_for_reload();
+
+			m_reload_thread = std::thread([this](const std::string& owned_input)
+			{
+				m_last_reload_succeeded = build_and_publish<DialectType>(owned_input.c_str(), owned_input.size());
+			}, std::move(input));
+		}
+
+		template<class DialectType = SJSONDialect>
+		void reload_file_in_background(std::string path)
+		{
+			wait_for_reload();
+
+			m_reload_thread = std::thread([this](const std::string& owned_path)
+			{
+				m_last_reload_succeeded = build_and_publish_file<DialectType>(owned_path.c_str());
+			}, std::move(path));
+		}
+
+		// Waits for a background reload, if any, and returns whether the last reload succeeded
+		bool wait_for_reload()
+		{
+			if (m_reload_thread.joinable())
+				m_reload_thread.join();
+
+			return m_last_reload_succeeded;
+		}
+
+		// Why the last reload failed, only safe to query once no reload is in flight
+		ParserError get_last_error() const { return m_last_error; }
+
+	private:
+		ReloadableDocument(const ReloadableDocument&) = delete;
+		ReloadableDocument& operator=(const ReloadableDocument&) = delete;
+
+		template<class DialectType>
+		bool build_and_publish(const char* input, size_t input_length)
+		{
+			std::shared_ptr<const Document> document = Document::parse<DialectType>(input, input_length, &m_last_error);
+			if (!document)
+				return false;
+
+			publish(std::move(document));
+			return true;
+		}
+
+		template<class DialectType>
+		bool build_and_publish_file(const char* path)
+		{
+			std::vector<char> input;
+			size_t input_length = 0;
+			if (!impl::read_file_into(path, input, 0, input_length))
+			{
+				m_last_error = ParserError();
+				m_last_error.error = ParserError::FileCouldNotBeRead;
+				return false;
+			}
+
+			return build_and_publish<DialectType>(input.data(), input_length);
+		}
+
+#if defined(SJSON_CPP_HAS_ATOMIC_SHARED_PTR)
+		std::atomic<std::shared_ptr<const Document>> m_document;
+#else
+		std::shared_ptr<const Document> m_document;
+#endif
+		std::thread m_reload_thread;
+		ParserError m_last_error;
+		std::atomic<uint32_t> m_generation;
+		bool m_last_reload_succeeded;
+	};
+}
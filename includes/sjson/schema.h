@@ -0,0 +1,522 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+// The MIT License (MIT)
+//
+// Copyright (c) 2018 Nicholas Frechette, Cody Jones, and sjson-cpp contributors
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "sjson/error.h"
+#include "sjson/parser.h"
+#include "sjson/parser_error.h"
+#include "sjson/parser_state.h"
+#include "sjson/string_view.h"
+
+#include <cstdint>
+#include <limits>
+
+namespace sjson
+{
+	enum class SchemaType
+	{
+		Any,
+		Bool,
+		Number,
+		Integer,
+		String,
+		Object,
+		Array,
+	};
+
+	//////////////////////////////////////////////////////////////////////////
+	// Describes a single value of a schema.
+	//
+	// The path uses the same '.' separated form as PathQuery. The elements of an array
+	// are described with the '*' segment, e.g. 'lights.*.intensity'.
+	// Every object and array along the path must be described by a field that comes before it.
+	//
+	// Fields are required by default and their value can be bound to a destination
+	// which is written as soon as the value has been validated.
+	//////////////////////////////////////////////////////////////////////////
+	struct SchemaField
+	{
+		static constexpr uint32_t k_unbounded_length = 0xFFFFFFFFu;
+
+		const char* path;
+		SchemaType type;
+		bool is_required;
+
+		// Inclusive range of numbers and integers
+		double min_value;
+		double max_value;
+
+		// Inclusive range of the length of strings and of the number of elements of arrays
+		uint32_t min_length;
+		uint32_t max_length;
+
+		// Optional destination of the value, its type depends on the type of the field:
+		// bool for Bool, double for Number, int64_t for Integer, and StringView for String
+		void* destination;
+
+		static SchemaField any(const char* path) { return SchemaField(path, SchemaType::Any); }
+		static SchemaField boolean(const char* path) { return SchemaField(path, SchemaType::Bool); }
+		static SchemaField object(const char* path) { return SchemaField(path, SchemaType::Object); }
+
+		static SchemaField number(const char* path, double min_value = -std::numeric_limits<double>::infinity(), double max_value = std::numeric_limits<double>::infinity())
+		{
+			SchemaField field(path, SchemaType::Number);
+			field.min_value = min_value;
+			field.max_value = max_value;
+			return field;
+		}
+
+		static SchemaField integer(const char* path, int64_t min_value = std::numeric_limits<int64_t>::min(), int64_t max_value = std::numeric_limits<int64_t>::max())
+		{
+			SchemaField field(path, SchemaType::Integer);
+			field.min_value = double(min_value);
+			field.max_value = double(max_value);
+			return field;
+		}
+
+		static SchemaField string(const char* path, uint32_t min_length = 0, uint32_t max_length = k_unbounded_length)
+		{
+			SchemaField field(path, SchemaType::String);
+			field.min_length = min_length;
+			field.max_length = max_length;
+			return field;
+		}
+
+		static SchemaField array(const char* path, uint32_t min_length = 0, uint32_t max_length = k_unbounded_length)
+		{
+			SchemaField field(path, SchemaType::Array);
+			field.min_length = min_length;
+			field.max_length = max_length;
+			return field;
+		}
+
+		SchemaField& optional() { is_required = false; return *this; }
+
+		SchemaField& bind(bool* value) { return bind_destination(SchemaType::Bool, value); }
+		SchemaField& bind(double* value) { return bind_destination(SchemaType::Number, value); }
+		SchemaField& bind(int64_t* value) { return bind_destination(SchemaType::Integer, value); }
+		SchemaField& bind(StringView* value) { return bind_destination(SchemaType::String, value); }
+
+	private:
+		SchemaField(const char* path_, SchemaType type_)
+			: path(path_)
+			, type(type_)
+			, is_required(true)
+			, min_value(-std::numeric_limits<double>::infinity())
+			, max_value(std::numeric_limits<double>::infinity())
+			, min_length(0)
+			, max_length(k_unbounded_length)
+			, destination(nullptr)
+		{}
+
+		SchemaField& bind_destination(SchemaType expected_type, void* value)
+		{
+			SJSON_CPP_ASSERT(type == expected_type, "The destination type does not match the type of schema field '%s'", path);
+			(void)expected_type;
+			destination = value;
+			return *this;
+		}
+	};
+
+	//////////////////////////////////////////////////////////////////////////
+	// A schema validator compiles a table of fields into a tree once and then checks
+	// inputs against it in a single forward pass. The values of bound fields are read
+	// during that same pass which removes the need to parse the input a second time.
+	//
+	// SchemaField fields[] =
+	// {
+	//     SchemaField::object("render"),
+	//     SchemaField::integer("render.width", 1, 8192).bind(&width),
+	//     SchemaField::array("render.lights", 0, 8).optional(),
+	//     SchemaField::object("render.lights.*"),
+	//     SchemaField::number("render.lights.*.intensity", 0.0, 10.0),
+	// };
+	// SchemaValidator validator(fields, 5);
+	// if (!validator.validate(parser))
+	//     report(parser.get_error());
+	//
+	// Validation errors are reported through the parser like syntax errors, with the
+	// position of the offending value, key, or closing brace.
+	// Validation starts at the current parser position which must be within an object (e.g. the root).
+	// A schema with more than k_max_num_fields fields or with a field whose parent isn't described
+	// before it is invalid, validating with it fails with ParserError::InvalidSchema.
+	// Fields are not copied and must outlive the validator.
+	//////////////////////////////////////////////////////////////////////////
+	class SchemaValidator
+	{
+	public:
+		static constexpr uint32_t k_max_num_fields = 128;
+		static constexpr uint32_t k_invalid_index = 0xFFFFFFFFu;
+
+		inline SchemaValidator(const SchemaField* fields, uint32_t num_fields, bool allow_unknown_keys = false);
+
+		template<class DialectType>
+		inline bool validate(BasicParser<DialectType>& parser);
+
+		// Returns the index of the field responsible for the last validation error, if any
+		uint32_t get_error_field_index() const { return m_error_field_index; }
+
+		// Whether or not the schema could be compiled
+		bool is_valid() const { return m_is_valid; }
+
+	private:
+		struct Node
+		{
+			StringView key;
+			uint32_t field_index;
+			uint32_t first_child;
+			uint32_t next_sibling;
+			uint32_t element;
+			bool is_within_array;
+		};
+
+		SchemaValidator(const SchemaValidator&) = delete;
+		SchemaValidator& operator=(const SchemaValidator&) = delete;
+
+		inline uint32_t find_child(uint32_t node_index, const StringView& key) const;
+
+		template<class DialectType>
+		inline bool validate_members(BasicParser<DialectType>& parser, uint32_t node_index, bool is_root);
+
+		template<class DialectType>
+		inline bool validate_elements(BasicParser<DialectType>& parser, uint32_t node_index, const ParserState& start_of_value);
+
+		template<class DialectType>
+		inline bool validate_value(BasicParser<DialectType>& parser, uint32_t node_index);
+
+		template<class DialectType>
+		inline bool fail(BasicParser<DialectType>& parser, uint32_t error, const ParserState& at, uint32_t field_index);
+
+		const SchemaField* m_fields;
+
+		// The root object is the first node, every field follows
+		Node m_nodes[k_max_num_fields + 1];
+		bool m_is_seen[k_max_num_fields + 1];
+
+		uint32_t m_num_nodes;
+		uint32_t m_error_field_index;
+
+		// The field that makes the schema invalid, if it is a single one
+		uint32_t m_invalid_field_index;
+		bool m_is_valid;
+		bool m_allow_unknown_keys;
+	};
+
+	//////////////////////////////////////////////////////////////////////////
+
+	inline SchemaValidator::SchemaValidator(const SchemaField* fields, uint32_t num_fields, bool allow_unknown_keys)
+		: m_fields(fields)
+		, m_num_nodes(num_fields + 1)
+		, m_error_field_index(k_invalid_index)
+		, m_invalid_field_index(k_invalid_index)
+		, m_is_valid(true)
+		, m_allow_unknown_keys(allow_unknown_keys)
+	{
+		Node& root = m_nodes[0];
+		root.field_index = k_invalid_index;
+		root.first_child = k_invalid_index;
+		root.next_sibling = k_invalid_index;
+		root.element = k_invalid_index;
+		root.is_within_array = false;
+
+		if (num_fields > k_max_num_fields)
+		{
+			m_num_nodes = 1;
+			m_is_valid = false;
+			return;
+		}
+
+		for (uint32_t field_index = 0; field_index < num_fields; ++field_index)
+		{
+			const SchemaField& field = fields[field_index];
+			const char* segment = field.path;
+			uint32_t parent_index = 0;
+
+			while (true)
+			{
+				const char* segment_end = segment;
+				while (*segment_end != '\0' && *segment_end != '.')
+					segment_end++;
+
+				const StringView key(segment, segment_end - segment);
+				const bool is_element = key == "*";
+
+				if (*segment_end == '\0')
+				{
+					const SchemaType parent_type = parent_index == 0 ? SchemaType::Object : fields[m_nodes[parent_index].field_index].type;
+					(void)parent_type;
+
+					Node& node = m_nodes[field_index + 1];
+					node.key = key;
+					node.field_index = field_index;
+					node.first_child = k_invalid_index;
+					node.next_sibling = k_invalid_index;
+					node.element = k_invalid_index;
+					node.is_within_array = m_nodes[parent_index].is_within_array || is_element;
+
+					Node& parent = m_nodes[parent_index];
+					if (is_element)
+					{
+						SJSON_CPP_ASSERT(parent_type == SchemaType::Array, "Schema field '%s' describes elements of a value that isn't an array", field.path);
+						SJSON_CPP_ASSERT(parent.element == k_invalid_index, "Schema field '%s' is a duplicate", field.path);
+						parent.element = field_index + 1;
+					}
+					else
+					{
+						SJSON_CPP_ASSERT(parent_type == SchemaType::Object, "Schema field '%s' describes a member of a value that isn't an object", field.path);
+						SJSON_CPP_ASSERT(find_child(parent_index, key) == k_invalid_index, "Schema field '%s' is a duplicate", field.path);
+						node.next_sibling = parent.first_child;
+						parent.first_child = field_index + 1;
+					}
+
+					SJSON_CPP_ASSERT(field.destination == nullptr || !node.is_within_array, "Schema field '%s' cannot be bound, it is part of an array", field.path);
+					break;
+				}
+
+				parent_index = is_element ? m_nodes[parent_index].element : find_child(parent_index, key);
+				if (parent_index == k_invalid_index)
+				{
+					// The parent of the field must be described before it
+					m_invalid_field_index = field_index;
+					m_is_valid = false;
+					return;
+				}
+
+				segment = segment_end + 1;
+			}
+		}
+	}
+
+	inline uint32_t SchemaValidator::find_child(uint32_t node_index, const StringView& key) const
+	{
+		for (uint32_t child_index = m_nodes[node_index].first_child; child_index != k_invalid_index; child_index = m_nodes[child_index].next_sibling)
+		{
+			if (m_nodes[child_index].key == key)
+				return child_index;
+		}
+
+		return k_invalid_index;
+	}
+
+	template<class DialectType>
+	inline bool SchemaValidator::validate(BasicParser<DialectType>& parser)
+	{
+		m_error_field_index = k_invalid_index;
+		if (!m_is_valid)
+			return fail(parser, ParserError::InvalidSchema, parser.save_state(), m_invalid_field_index);
+
+		return validate_members(parser, 0, true);
+	}
+
+	template<class DialectType>
+	inline bool SchemaValidator::validate_members(BasicParser<DialectType>& parser, uint32_t node_index, bool is_root)
+	{
+		for (uint32_t child_index = m_nodes[node_index].first_child; child_index != k_invalid_index; child_index = m_nodes[child_index].next_sibling)
+			m_is_seen[child_index] = false;
+
+		StringView key;
+		ParserState end_of_object = parser.save_state();
+
+		while (true)
+		{
+			if (!parser.skip_comments_and_whitespace())
+				return false;
+
+			end_of_object = parser.save_state();
+
+			if (is_root)
+			{
+				if (parser.is_root_object_end())
+					break;
+			}
+			else if (parser.try_object_ends())
+				break;
+
+			if (!parser.read_next_key(key))
+				return false;
+
+			const uint32_t child_index = find_child(node_index, key);
+			if (child_index == k_invalid_index)
+			{
+				if (!m_allow_unknown_keys)
+					return fail(parser, ParserError::UnexpectedKey, end_of_object, k_invalid_index);
+
+				if (!parser.skip_value())
+					return false;
+
+				continue;
+			}
+
+			m_is_seen[child_index] = true;
+
+			if (!validate_value(parser, child_index))
+				return false;
+		}
+
+		for (uint32_t child_index = m_nodes[node_index].first_child; child_index != k_invalid_index; child_index = m_nodes[child_index].next_sibling)
+		{
+			const uint32_t field_index = m_nodes[child_index].field_index;
+			if (!m_is_seen[child_index] && m_fields[field_index].is_required)
+				return fail(parser, ParserError::RequiredKeyMissing, end_of_object, field_index);
+		}
+
+		return true;
+	}
+
+	template<class DialectType>
+	inline bool SchemaValidator::validate_elements(BasicParser<DialectType>& parser, uint32_t node_index, const ParserState& start_of_value)
+	{
+		if (!parser.array_begins())
+			return false;
+
+		const uint32_t element_index = m_nodes[node_index].element;
+		uint32_t num_elements = 0;
+
+		while (!parser.try_array_ends())
+		{
+			if (num_elements != 0 && !parser.read_array_separator())
+				return false;
+
+			if (element_index != k_invalid_index)
+			{
+				if (!validate_value(parser, element_index))
+					return false;
+			}
+			else if (!parser.skip_value())
+				return false;
+
+			num_elements++;
+		}
+
+		const uint32_t field_index = m_nodes[node_index].field_index;
+		const SchemaField& field = m_fields[field_index];
+		if (num_elements < field.min_length || num_elements > field.max_length)
+			return fail(parser, ParserError::LengthOutOfRange, start_of_value, field_index);
+
+		return true;
+	}
+
+	template<class DialectType>
+	inline bool SchemaValidator::validate_value(BasicParser<DialectType>& parser, uint32_t node_index)
+	{
+		const uint32_t field_index = m_nodes[node_index].field_index;
+		const SchemaField& field = m_fields[field_index];
+
+		const ValueType type = parser.peek_value_type();
+		const ParserState start_of_value = parser.save_state();
+
+		if (type == ValueType::Unknown || field.type == SchemaType::Any)
+			return parser.skip_value();
+
+		switch (field.type)
+		{
+		case SchemaType::Bool:
+		{
+			if (type != ValueType::Bool)
+				break;
+
+			bool value;
+			if (!parser.read(value))
+				return false;
+
+			if (field.destination != nullptr)
+				*static_cast<bool*>(field.destination) = value;
+			return true;
+		}
+		case SchemaType::Number:
+		{
+			if (type != ValueType::Number)
+				break;
+
+			double value;
+			if (!parser.read(value))
+				return false;
+
+			if (value < field.min_value || value > field.max_value)
+				return fail(parser, ParserError::ValueOutOfRange, start_of_value, field_index);
+
+			if (field.destination != nullptr)
+				*static_cast<double*>(field.destination) = value;
+			return true;
+		}
+		case SchemaType::Integer:
+		{
+			// A real number is a type mismatch, it isn't read as an integer
+			if (type != ValueType::Number || !impl::is_integer_token(parser.get_input(), parser.get_input_length(), start_of_value.offset))
+				break;
+
+			int64_t value;
+			if (!parser.read(value))
+				return false;
+
+			if (double(value) < field.min_value || double(value) > field.max_value)
+				return fail(parser, ParserError::ValueOutOfRange, start_of_value, field_index);
+
+			if (field.destination != nullptr)
+				*static_cast<int64_t*>(field.destination) = value;
+			return true;
+		}
+		case SchemaType::String:
+		{
+			if (type != ValueType::String)
+				break;
+
+			StringView value;
+			if (!parser.read(value))
+				return false;
+
+			if (value.size() < field.min_length || value.size() > field.max_length)
+				return fail(parser, ParserError::LengthOutOfRange, start_of_value, field_index);
+
+			if (field.destination != nullptr)
+				*static_cast<StringView*>(field.destination) = value;
+			return true;
+		}
+		case SchemaType::Object:
+			if (type != ValueType::Object)
+				break;
+
+			// The closing brace is read along with the members
+			return parser.object_begins() && validate_members(parser, node_index, false);
+		case SchemaType::Array:
+			if (type != ValueType::Array)
+				break;
+
+			return validate_elements(parser, node_index, start_of_value);
+		default:
+			break;
+		}
+
+		return fail(parser, ParserError::TypeMismatch, start_of_value, field_index);
+	}
+
+	template<class DialectType>
+	inline bool SchemaValidator::fail(BasicParser<DialectType>& parser, uint32_t error, const ParserState& at, uint32_t field_index)
+	{
+		parser.report_error(error, at.line, at.column);
+		m_error_field_index = field_index;
+		return false;
+	}
+}
@@ -29,8 +29,11 @@
 	#define SJSON_CPP_WRITER
 #endif
 
+#include "sjson/base64.h"
 #include "sjson/error.h"
+#include "sjson/kernels.h"
 
+#include <algorithm>
 #include <functional>
 #include <cstdio>
 #include <cstdint>
@@ -44,11 +47,32 @@ namespace sjson
 	class Writer;
 	class ArrayWriter;
 	class ObjectWriter;
+	class ObjectShape;
 
 	// TODO: Make this an argument to the writer. For now we assume that SJSON generated files
 	// can be shared between various OS and having the most conservative line ending is safer.
 	constexpr const char* k_line_terminator = "\r\n";
 
+	struct WriterSettings
+	{
+		WriterSettings()
+			: indentation_symbol('\t')
+			, indentation_width(1)
+			, use_hex_floats(false)
+		{}
+
+		// The symbol used to indent nested values, either a tab or a space
+		char indentation_symbol;
+
+		// How many indentation symbols are written per nesting level
+		uint32_t indentation_width;
+
+		// Whether or not floating point numbers are written in the exact C99 hexadecimal form, e.g. 0x1.8p+1
+		// Values round trip bit for bit and are written and read without any decimal conversion.
+		// The output can only be read by dialects that allow hexadecimal floats, JSON does not.
+		bool use_hex_floats;
+	};
+
 	class StreamWriter
 	{
 	public:
@@ -103,6 +127,143 @@ namespace sjson
 	}
 #endif
 
+	namespace impl
+	{
+		// Indentation is written as a single slice of these runs, optionally along with the line terminator
+		// that precedes it. Both runs must start with k_line_terminator.
+		// Only an object pushed into an array folds its terminator in. Object members end their line as soon as
+		// their value is written, often in the same write, and the next member starts with its own indentation.
+		constexpr size_t k_line_terminator_length = 2;
+		constexpr size_t k_max_indentation_slice_length = 64;
+		constexpr const char k_tab_indentation_run[] = "\r\n\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t";
+		constexpr const char k_space_indentation_run[] = "\r\n                                                                ";
+
+		inline void write_indentation(StreamWriter& stream_writer, const WriterSettings& settings, uint32_t indent_level, bool with_line_terminator)
+		{
+			SJSON_CPP_ASSERT(settings.indentation_symbol == '\t' || settings.indentation_symbol == ' ', "Unsupported indentation symbol: %d", settings.indentation_symbol);
+
+			const char* run = settings.indentation_symbol == ' ' ? k_space_indentation_run : k_tab_indentation_run;
+			size_t indentation_length = size_t(indent_level) * settings.indentation_width;
+			size_t slice_length = std::min(indentation_length, k_max_indentation_slice_length);
+
+			if (with_line_terminator)
+				stream_writer.write(run, k_line_terminator_length + slice_length);
+			else if (slice_length != 0)
+				stream_writer.write(run + k_line_terminator_length, slice_length);
+
+			indentation_length -= slice_length;
+
+			// Very deep nesting requires more than one slice
+			while (indentation_length != 0)
+			{
+				slice_length = std::min(indentation_length, k_max_indentation_slice_length);
+				stream_writer.write(run + k_line_terminator_length, slice_length);
+				indentation_length -= slice_length;
+			}
+		}
+
+		// Writes a double in the exact C99 hexadecimal form with a few shifts and masks, e.g. 0x1.8p+1
+		// Infinities and NaN have no such form and are written like decimal numbers.
+		inline int write_hex_double(char* buffer, size_t buffer_size, double value)
+		{
+			// The longest form is -0x1.fffffffffffffp-1022
+			constexpr size_t k_max_hex_double_length = 24;
+			constexpr uint64_t k_mantissa_mask = 0x000FFFFFFFFFFFFFull;
+
+			uint64_t bits;
+			std::memcpy(&bits, &value, sizeof(bits));
+
+			const uint32_t biased_exponent = uint32_t(bits >> 52) & 0x7FF;
+			if (biased_exponent == 0x7FF)
+				return snprintf(buffer, buffer_size, "%.17g", value);
+
+			if (buffer_size <= k_max_hex_double_length)
+				return -1;
+
+			char* cursor = buffer;
+			if ((bits >> 63) != 0)
+				*cursor++ = '-';
+
+			*cursor++ = '0';
+			*cursor++ = 'x';
+
+			// Subnormals have no implicit leading bit and share the exponent of the smallest normal
+			uint64_t mantissa = bits & k_mantissa_mask;
+			int32_t exponent = int32_t(biased_exponent) - 1023;
+			if (biased_exponent == 0)
+			{
+				*cursor++ = '0';
+				exponent = mantissa == 0 ? 0 : -1022;
+			}
+			else
+				*cursor++ = '1';
+
+			if (mantissa != 0)
+			{
+				*cursor++ = '.';
+
+				// Trailing zero digits are dropped
+				for (; mantissa != 0; mantissa = (mantissa << 4) & k_mantissa_mask)
+					*cursor++ = "0123456789abcdef"[(mantissa >> 48) & 0xF];
+			}
+
+			*cursor++ = 'p';
+			*cursor++ = exponent < 0 ? '-' : '+';
+
+			uint32_t exponent_magnitude = uint32_t(exponent < 0 ? -exponent : exponent);
+			char exponent_digits[4];
+			uint32_t num_exponent_digits = 0;
+			do
+			{
+				exponent_digits[num_exponent_digits++] = char('0' + (exponent_magnitude % 10));
+				exponent_magnitude /= 10;
+			} while (exponent_magnitude != 0);
+
+			while (num_exponent_digits != 0)
+				*cursor++ = exponent_digits[--num_exponent_digits];
+
+			*cursor = '\0';
+			return int(cursor - buffer);
+		}
+
+		// Formats a double like snprintf(..) does and returns its length
+		inline int format_double(char* buffer, size_t buffer_size, double value, const WriterSettings& settings)
+		{
+			if (settings.use_hex_floats)
+				return write_hex_double(buffer, buffer_size, value);
+
+			return snprintf(buffer, buffer_size, "%.17g", value);
+		}
+
+		// Writes a binary value as a quoted base64 string, it is encoded in chunks that are written as they fill up
+		inline void write_base64(StreamWriter& stream_writer, const void* data, size_t size)
+		{
+			// Chunks hold a whole number of groups of three bytes
+			constexpr size_t k_chunk_size = 768;
+
+			char buffer[get_base64_encoded_length(k_chunk_size) + 2];
+			const uint8_t* bytes = static_cast<const uint8_t*>(data);
+			size_t length = 0;
+
+			buffer[length++] = '"';
+
+			for (size_t offset = 0; offset < size; offset += k_chunk_size)
+			{
+				const size_t chunk_size = std::min(size - offset, k_chunk_size);
+				length += encode_base64(bytes + offset, chunk_size, buffer + length);
+
+				if (offset + chunk_size < size)
+				{
+					stream_writer.write(buffer, length);
+					length = 0;
+				}
+			}
+
+			buffer[length++] = '"';
+			stream_writer.write(buffer, length);
+		}
+	}
+
 	class ArrayWriter
 	{
 	public:
@@ -119,6 +280,13 @@ namespace sjson
 		inline void push(int64_t value) { push_signed_integer(value); }
 		inline void push(uint64_t value) { push_unsigned_integer(value); }
 
+		// Pushes multiple numbers at once, they are formatted into a local buffer and written with as few writes as possible
+		inline void push(const double* values, uint32_t num_values) { push_numbers(values, num_values); }
+		inline void push(const float* values, uint32_t num_values) { push_numbers(values, num_values); }
+
+		// Pushes a binary value as a base64 string, see ObjectWriter::insert_binary(..)
+		inline void push_binary(const void* data, size_t size);
+
 		// Note: This is funky because of C++ lambda coercion rules
 		// A lambda that does not capture anything is equivalent to a static function
 		// and calling a function with it as an argument is equivalent to passing a function pointer.
@@ -146,16 +314,18 @@ namespace sjson
 		void push_newline();
 
 	private:
-		inline ArrayWriter(StreamWriter& stream_writer, uint32_t indent_level);
+		inline ArrayWriter(StreamWriter& stream_writer, const WriterSettings& settings, uint32_t indent_level);
 
 		ArrayWriter(const ArrayWriter&) = delete;
 		ArrayWriter& operator=(const ArrayWriter&) = delete;
 
 		inline void push_signed_integer(int64_t value);
 		inline void push_unsigned_integer(uint64_t value);
-		inline void write_indentation();
+		template<typename NumberType> inline void push_numbers(const NumberType* values, uint32_t num_values);
+		inline void write_indentation(bool with_line_terminator = false);
 
 		StreamWriter& m_stream_writer;
+		WriterSettings m_settings;
 		uint32_t m_indent_level;
 		bool m_is_empty;
 		bool m_is_locked;
@@ -164,6 +334,64 @@ namespace sjson
 		friend ObjectWriter;
 	};
 
+	//////////////////////////////////////////////////////////////////////////
+	// An object shape describes keys that are written over and over again, e.g. when writing
+	// an array of objects that all have the same keys. The complete prefix of every key
+	// (indentation, key, and separator) is rendered once in a contiguous buffer and each insertion
+	// then copies it along with the value in a single write.
+	//
+	// const char* keys[] = { "x", "y", "z" };
+	// ObjectShape shape(keys, 3);
+	// array_writer.push([&](ObjectWriter& object_writer)
+	// {
+	//     object_writer.insert(shape, 0, point.x);
+	//     object_writer.insert(shape, 1, point.y);
+	//     object_writer.insert(shape, 2, point.z);
+	// });
+	//
+	// The prefixes are rendered for the indentation of the object they are used with and are
+	// rendered again if it changes. The keys, and the array that holds them, must outlive the shape.
+	// Keys past the first k_max_num_keys and keys whose prefix does not fit are not rendered,
+	// they are inserted like any other key.
+	//////////////////////////////////////////////////////////////////////////
+	class ObjectShape
+	{
+	public:
+		static constexpr uint32_t k_max_num_keys = 64;
+		static constexpr size_t k_max_prefix_length = 256;
+		static constexpr size_t k_max_rendered_size = 4096;
+
+		inline ObjectShape(const char* const* keys, uint32_t num_keys);
+
+		uint32_t get_num_keys() const { return m_num_keys; }
+		const char* get_key(uint32_t key_index) const { return m_keys[key_index]; }
+
+		// Returns whether the key is rendered at the current indentation, see ObjectWriter::insert(shape, ..)
+		bool is_key_rendered(uint32_t key_index) const { return key_index < k_max_num_keys && m_prefix_lengths[key_index] != 0; }
+
+	private:
+		ObjectShape(const ObjectShape&) = delete;
+		ObjectShape& operator=(const ObjectShape&) = delete;
+
+		inline const char* get_prefix(uint32_t key_index, const WriterSettings& settings, uint32_t indent_level, size_t& out_prefix_length);
+		inline void render(const WriterSettings& settings, uint32_t indent_level);
+
+		const char* const* m_keys;
+		uint32_t m_num_keys;
+
+		// The settings and indentation level our prefixes are currently rendered for
+		char m_indentation_symbol;
+		uint32_t m_indentation_length;
+		bool m_is_rendered;
+
+		// A key that isn't rendered has a prefix length of 0
+		uint32_t m_prefix_offsets[k_max_num_keys];
+		uint32_t m_prefix_lengths[k_max_num_keys];
+		char m_prefixes[k_max_rendered_size];
+
+		friend ObjectWriter;
+	};
+
 	class ObjectWriter
 	{
 	public:
@@ -180,6 +408,38 @@ namespace sjson
 		inline void insert(const char* key, int64_t value) { insert_signed_integer(key, int64_t(value)); }
 		inline void insert(const char* key, uint64_t value) { insert_unsigned_integer(key, uint64_t(value)); }
 
+		// Inserts an array of numbers: key = [ 1.0, 2.0, 3.0 ]
+		inline void insert(const char* key, const double* values, uint32_t num_values);
+		inline void insert(const char* key, const float* values, uint32_t num_values);
+
+		// Inserts a batch of records in a columnar layout: every column is written as an array of numbers
+		// within an object. This is much more compact and faster to read and write than an array of objects.
+		// key = {
+		//     column0 = [ row0, row1, row2 ]
+		//     column1 = [ row0, row1, row2 ]
+		// }
+		// See Parser::read_columns(..) to read it back.
+		inline void insert_columns(const char* key, const char* const* column_names, const double* const* columns, uint32_t num_columns, uint32_t num_rows);
+		inline void insert_columns(const char* key, const char* const* column_names, const float* const* columns, uint32_t num_columns, uint32_t num_rows);
+
+		// Inserts a binary value as a base64 string: key = "AAECAw=="
+		// It is encoded straight into the output, see Parser::read_binary(..) to read it back.
+		inline void insert_binary(const char* key, const void* data, size_t size);
+
+		// Inserts a value whose key is pre-rendered by an object shape, see ObjectShape for details
+		inline void insert(ObjectShape& shape, uint32_t key_index, const char* value);
+		inline void insert(ObjectShape& shape, uint32_t key_index, bool value);
+		inline void insert(ObjectShape& shape, uint32_t key_index, double value);
+		inline void insert(ObjectShape& shape, uint32_t key_index, float value) { insert(shape, key_index, double(value)); }
+		inline void insert(ObjectShape& shape, uint32_t key_index, int8_t value) { insert_signed_integer(shape, key_index, int64_t(value)); }
+		inline void insert(ObjectShape& shape, uint32_t key_index, uint8_t value) { insert_unsigned_integer(shape, key_index, uint64_t(value)); }
+		inline void insert(ObjectShape& shape, uint32_t key_index, int16_t value) { insert_signed_integer(shape, key_index, int64_t(value)); }
+		inline void insert(ObjectShape& shape, uint32_t key_index, uint16_t value) { insert_unsigned_integer(shape, key_index, uint64_t(value)); }
+		inline void insert(ObjectShape& shape, uint32_t key_index, int32_t value) { insert_signed_integer(shape, key_index, int64_t(value)); }
+		inline void insert(ObjectShape& shape, uint32_t key_index, uint32_t value) { insert_unsigned_integer(shape, key_index, uint64_t(value)); }
+		inline void insert(ObjectShape& shape, uint32_t key_index, int64_t value) { insert_signed_integer(shape, key_index, int64_t(value)); }
+		inline void insert(ObjectShape& shape, uint32_t key_index, uint64_t value) { insert_unsigned_integer(shape, key_index, uint64_t(value)); }
+
 		// Note: This is funky because of C++ lambda coercion rules
 		// A lambda that does not capture anything is equivalent to a static function
 		// and calling a function with it as an argument is equivalent to passing a function pointer.
@@ -267,16 +527,22 @@ namespace sjson
 		inline ValueRef operator[](const char* key) { return ValueRef(*this, key); }
 
 	protected:
-		inline ObjectWriter(StreamWriter& stream_writer, uint32_t indent_level);
+		inline ObjectWriter(StreamWriter& stream_writer, const WriterSettings& settings, uint32_t indent_level);
 
 		ObjectWriter(const ObjectWriter&) = delete;
 		ObjectWriter& operator=(const ObjectWriter&) = delete;
 
 		inline void insert_signed_integer(const char* key, int64_t value);
 		inline void insert_unsigned_integer(const char* key, uint64_t value);
+		inline void insert_signed_integer(ObjectShape& shape, uint32_t key_index, int64_t value);
+		inline void insert_unsigned_integer(ObjectShape& shape, uint32_t key_index, uint64_t value);
+		inline bool write_shape_prefix(ObjectShape& shape, uint32_t key_index, char* buffer, size_t& out_prefix_length);
+		template<typename NumberType> inline void insert_numbers(const char* key, const NumberType* values, uint32_t num_values);
+		template<typename NumberType> inline void insert_number_columns(const char* key, const char* const* column_names, const NumberType* const* columns, uint32_t num_columns, uint32_t num_rows);
 		inline void write_indentation();
 
 		StreamWriter& m_stream_writer;
+		WriterSettings m_settings;
 		uint32_t m_indent_level;
 		bool m_is_locked;
 		bool m_has_live_value_ref;
@@ -287,7 +553,7 @@ namespace sjson
 	class Writer : public ObjectWriter
 	{
 	public:
-		inline Writer(StreamWriter& stream_writer);
+		inline Writer(StreamWriter& stream_writer, const WriterSettings& settings = WriterSettings());
 
 	private:
 		Writer(const Writer&) = delete;
@@ -296,8 +562,9 @@ namespace sjson
 
 	//////////////////////////////////////////////////////////////////////////
 
-	inline ObjectWriter::ObjectWriter(StreamWriter& stream_writer, uint32_t indent_level)
+	inline ObjectWriter::ObjectWriter(StreamWriter& stream_writer, const WriterSettings& settings, uint32_t indent_level)
 		: m_stream_writer(stream_writer)
+		, m_settings(settings)
 		, m_indent_level(indent_level)
 		, m_is_locked(false)
 		, m_has_live_value_ref(false)
@@ -317,6 +584,19 @@ namespace sjson
 		m_stream_writer.write(k_line_terminator);
 	}
 
+	inline void ObjectWriter::insert_binary(const char* key, const void* data, size_t size)
+	{
+		SJSON_CPP_ASSERT(!m_is_locked, "Cannot insert SJSON value in locked object");
+		SJSON_CPP_ASSERT(!m_has_live_value_ref, "Cannot insert SJSON value in object when it has a live ValueRef");
+
+		write_indentation();
+
+		m_stream_writer.write(key);
+		m_stream_writer.write(" = ");
+		impl::write_base64(m_stream_writer, data, size);
+		m_stream_writer.write(k_line_terminator);
+	}
+
 	inline void ObjectWriter::insert(const char* key, bool value)
 	{
 		SJSON_CPP_ASSERT(!m_is_locked, "Cannot insert SJSON value in locked object");
@@ -344,9 +624,10 @@ namespace sjson
 		m_stream_writer.write(" = ");
 
 		char buffer[256];
-		size_t length = snprintf(buffer, sizeof(buffer), "%.17g%s", value, k_line_terminator);
-		SJSON_CPP_ASSERT(length > 0 && length < sizeof(buffer), "Failed to insert SJSON value: [%s = %.17g]", key, value);
-		m_stream_writer.write(buffer, length);
+		const int length = impl::format_double(buffer, sizeof(buffer) - impl::k_line_terminator_length, value, m_settings);
+		SJSON_CPP_ASSERT(length > 0 && size_t(length) < sizeof(buffer) - impl::k_line_terminator_length, "Failed to insert SJSON value: [%s = %.17g]", key, value);
+		std::memcpy(buffer + length, k_line_terminator, impl::k_line_terminator_length);
+		m_stream_writer.write(buffer, size_t(length) + impl::k_line_terminator_length);
 	}
 
 	inline void ObjectWriter::insert_signed_integer(const char* key, int64_t value)
@@ -399,7 +680,7 @@ namespace sjson
 		m_stream_writer.write(k_line_terminator);
 		m_is_locked = true;
 
-		ObjectWriter object_writer(m_stream_writer, m_indent_level + 1);
+		ObjectWriter object_writer(m_stream_writer, m_settings, m_indent_level + 1);
 		writer_fun(object_writer);
 
 		m_is_locked = false;
@@ -426,7 +707,7 @@ namespace sjson
 		m_stream_writer.write(" = [ ");
 		m_is_locked = true;
 
-		ArrayWriter array_writer(m_stream_writer, m_indent_level + 1);
+		ArrayWriter array_writer(m_stream_writer, m_settings, m_indent_level + 1);
 		writer_fun(array_writer);
 
 		if (array_writer.m_is_newline)
@@ -444,10 +725,138 @@ namespace sjson
 		m_is_locked = false;
 	}
 
+	inline void ObjectWriter::insert(const char* key, const double* values, uint32_t num_values)
+	{
+		insert_numbers(key, values, num_values);
+	}
+
+	inline void ObjectWriter::insert(const char* key, const float* values, uint32_t num_values)
+	{
+		insert_numbers(key, values, num_values);
+	}
+
+	template<typename NumberType>
+	inline void ObjectWriter::insert_numbers(const char* key, const NumberType* values, uint32_t num_values)
+	{
+		insert(key, [values, num_values](ArrayWriter& array_writer) { array_writer.push(values, num_values); });
+	}
+
+	inline void ObjectWriter::insert_columns(const char* key, const char* const* column_names, const double* const* columns, uint32_t num_columns, uint32_t num_rows)
+	{
+		insert_number_columns(key, column_names, columns, num_columns, num_rows);
+	}
+
+	inline void ObjectWriter::insert_columns(const char* key, const char* const* column_names, const float* const* columns, uint32_t num_columns, uint32_t num_rows)
+	{
+		insert_number_columns(key, column_names, columns, num_columns, num_rows);
+	}
+
+	template<typename NumberType>
+	inline void ObjectWriter::insert_number_columns(const char* key, const char* const* column_names, const NumberType* const* columns, uint32_t num_columns, uint32_t num_rows)
+	{
+		insert(key, [column_names, columns, num_columns, num_rows](ObjectWriter& object_writer)
+		{
+			for (uint32_t column_index = 0; column_index < num_columns; ++column_index)
+				object_writer.insert(column_names[column_index], columns[column_index], num_rows);
+		});
+	}
+
+	inline void ObjectWriter::insert(ObjectShape& shape, uint32_t key_index, const char* value)
+	{
+		char buffer[ObjectShape::k_max_prefix_length + 256];
+		size_t length;
+		if (!write_shape_prefix(shape, key_index, buffer, length))
+			return insert(shape.get_key(key_index), value);
+
+		const size_t value_length = std::strlen(value);
+		if (length + value_length + 3 <= sizeof(buffer))
+		{
+			buffer[length++] = '"';
+			std::memcpy(buffer + length, value, value_length);
+			length += value_length;
+			buffer[length++] = '"';
+			m_stream_writer.write(buffer, length);
+		}
+		else
+		{
+			// Long strings are not worth copying
+			buffer[length++] = '"';
+			m_stream_writer.write(buffer, length);
+			m_stream_writer.write(value, value_length);
+			m_stream_writer.write("\"");
+		}
+
+		m_stream_writer.write(k_line_terminator);
+	}
+
+	inline void ObjectWriter::insert(ObjectShape& shape, uint32_t key_index, bool value)
+	{
+		char buffer[ObjectShape::k_max_prefix_length + 256];
+		size_t prefix_length;
+		if (!write_shape_prefix(shape, key_index, buffer, prefix_length))
+			return insert(shape.get_key(key_index), value);
+
+		size_t length = snprintf(buffer + prefix_length, sizeof(buffer) - prefix_length, "%s%s", value ? "true" : "false", k_line_terminator);
+		SJSON_CPP_ASSERT(length > 0 && length < sizeof(buffer) - prefix_length, "Failed to insert SJSON value: [%s = %s]", shape.get_key(key_index), value);
+		m_stream_writer.write(buffer, prefix_length + length);
+	}
+
+	inline void ObjectWriter::insert(ObjectShape& shape, uint32_t key_index, double value)
+	{
+		char buffer[ObjectShape::k_max_prefix_length + 256];
+		size_t prefix_length;
+		if (!write_shape_prefix(shape, key_index, buffer, prefix_length))
+			return insert(shape.get_key(key_index), value);
+
+		const size_t available_length = sizeof(buffer) - prefix_length - impl::k_line_terminator_length;
+		const int length = impl::format_double(buffer + prefix_length, available_length, value, m_settings);
+		SJSON_CPP_ASSERT(length > 0 && size_t(length) < available_length, "Failed to insert SJSON value: [%s = %.17g]", shape.get_key(key_index), value);
+		std::memcpy(buffer + prefix_length + length, k_line_terminator, impl::k_line_terminator_length);
+		m_stream_writer.write(buffer, prefix_length + size_t(length) + impl::k_line_terminator_length);
+	}
+
+	inline void ObjectWriter::insert_signed_integer(ObjectShape& shape, uint32_t key_index, int64_t value)
+	{
+		char buffer[ObjectShape::k_max_prefix_length + 256];
+		size_t prefix_length;
+		if (!write_shape_prefix(shape, key_index, buffer, prefix_length))
+			return insert_signed_integer(shape.get_key(key_index), value);
+
+		size_t length = snprintf(buffer + prefix_length, sizeof(buffer) - prefix_length, "%" PRId64 "%s", value, k_line_terminator);
+		SJSON_CPP_ASSERT(length > 0 && length < sizeof(buffer) - prefix_length, "Failed to insert SJSON value: [%s = %lld]", shape.get_key(key_index), value);
+		m_stream_writer.write(buffer, prefix_length + length);
+	}
+
+	inline void ObjectWriter::insert_unsigned_integer(ObjectShape& shape, uint32_t key_index, uint64_t value)
+	{
+		char buffer[ObjectShape::k_max_prefix_length + 256];
+		size_t prefix_length;
+		if (!write_shape_prefix(shape, key_index, buffer, prefix_length))
+			return insert_unsigned_integer(shape.get_key(key_index), value);
+
+		size_t length = snprintf(buffer + prefix_length, sizeof(buffer) - prefix_length, "%" PRIu64 "%s", value, k_line_terminator);
+		SJSON_CPP_ASSERT(length > 0 && length < sizeof(buffer) - prefix_length, "Failed to insert SJSON value: [%s = %llu]", shape.get_key(key_index), value);
+		m_stream_writer.write(buffer, prefix_length + length);
+	}
+
+	// Copies the pre-rendered prefix into the buffer, the buffer must hold at least ObjectShape::k_max_prefix_length symbols.
+	// Returns false if the key isn't rendered.
+	inline bool ObjectWriter::write_shape_prefix(ObjectShape& shape, uint32_t key_index, char* buffer, size_t& out_prefix_length)
+	{
+		SJSON_CPP_ASSERT(!m_is_locked, "Cannot insert SJSON value in locked object");
+		SJSON_CPP_ASSERT(!m_has_live_value_ref, "Cannot insert SJSON value in object when it has a live ValueRef");
+
+		const char* prefix = shape.get_prefix(key_index, m_settings, m_indent_level, out_prefix_length);
+		if (prefix == nullptr)
+			return false;
+
+		std::memcpy(buffer, prefix, out_prefix_length);
+		return true;
+	}
+
 	inline void ObjectWriter::write_indentation()
 	{
-		for (uint32_t level = 0; level < m_indent_level; ++level)
-			m_stream_writer.write("\t");
+		impl::write_indentation(m_stream_writer, m_settings, m_indent_level, false);
 	}
 
 	inline void ObjectWriter::insert_newline()
@@ -528,9 +937,10 @@ namespace sjson
 		SJSON_CPP_ASSERT(!m_is_locked, "Cannot assign a value when locked");
 
 		char buffer[256];
-		size_t length = snprintf(buffer, sizeof(buffer), "%.17g%s", value, k_line_terminator);
-		SJSON_CPP_ASSERT(length > 0 && length < sizeof(buffer), "Failed to assign SJSON value: %.17g", value);
-		m_object_writer->m_stream_writer.write(buffer, length);
+		const int length = impl::format_double(buffer, sizeof(buffer) - impl::k_line_terminator_length, value, m_object_writer->m_settings);
+		SJSON_CPP_ASSERT(length > 0 && size_t(length) < sizeof(buffer) - impl::k_line_terminator_length, "Failed to assign SJSON value: %.17g", value);
+		std::memcpy(buffer + length, k_line_terminator, impl::k_line_terminator_length);
+		m_object_writer->m_stream_writer.write(buffer, size_t(length) + impl::k_line_terminator_length);
 		m_is_empty = false;
 	}
 
@@ -550,7 +960,7 @@ namespace sjson
 		m_object_writer->m_stream_writer.write(k_line_terminator);
 		m_is_locked = true;
 
-		ObjectWriter object_writer(m_object_writer->m_stream_writer, m_object_writer->m_indent_level + 1);
+		ObjectWriter object_writer(m_object_writer->m_stream_writer, m_object_writer->m_settings, m_object_writer->m_indent_level + 1);
 		writer_fun(object_writer);
 
 		m_is_locked = false;
@@ -575,7 +985,7 @@ namespace sjson
 		m_object_writer->m_stream_writer.write("[ ");
 		m_is_locked = true;
 
-		ArrayWriter array_writer(m_object_writer->m_stream_writer, m_object_writer->m_indent_level + 1);
+		ArrayWriter array_writer(m_object_writer->m_stream_writer, m_object_writer->m_settings, m_object_writer->m_indent_level + 1);
 		writer_fun(array_writer);
 
 		if (array_writer.m_is_newline)
@@ -622,14 +1032,91 @@ namespace sjson
 
 	//////////////////////////////////////////////////////////////////////////
 
-	inline ArrayWriter::ArrayWriter(StreamWriter& stream_writer, uint32_t indent_level)
+	inline ObjectShape::ObjectShape(const char* const* keys, uint32_t num_keys)
+		: m_keys(keys)
+		, m_num_keys(num_keys)
+		, m_indentation_symbol('\0')
+		, m_indentation_length(0)
+		, m_is_rendered(false)
+	{
+	}
+
+	inline const char* ObjectShape::get_prefix(uint32_t key_index, const WriterSettings& settings, uint32_t indent_level, size_t& out_prefix_length)
+	{
+		SJSON_CPP_ASSERT(key_index < m_num_keys, "Invalid key index: %u >= %u", key_index, m_num_keys);
+
+		const uint32_t indentation_length = indent_level * settings.indentation_width;
+		if (!m_is_rendered || m_indentation_symbol != settings.indentation_symbol || m_indentation_length != indentation_length)
+			render(settings, indent_level);
+
+		if (!is_key_rendered(key_index))
+			return nullptr;
+
+		out_prefix_length = m_prefix_lengths[key_index];
+		return m_prefixes + m_prefix_offsets[key_index];
+	}
+
+	inline void ObjectShape::render(const WriterSettings& settings, uint32_t indent_level)
+	{
+		m_indentation_symbol = settings.indentation_symbol;
+		m_indentation_length = indent_level * settings.indentation_width;
+		m_is_rendered = true;
+
+		const uint32_t num_keys = m_num_keys < k_max_num_keys ? m_num_keys : k_max_num_keys;
+		uint32_t offset = 0;
+		for (uint32_t key_index = 0; key_index < num_keys; ++key_index)
+		{
+			const size_t key_length = std::strlen(m_keys[key_index]);
+			const size_t prefix_length = size_t(m_indentation_length) + key_length + 3;
+
+			// Deep indentation and long keys are inserted without a prefix
+			if (prefix_length > k_max_prefix_length || offset + prefix_length > sizeof(m_prefixes))
+			{
+				m_prefix_offsets[key_index] = offset;
+				m_prefix_lengths[key_index] = 0;
+				continue;
+			}
+
+			m_prefix_offsets[key_index] = offset;
+			m_prefix_lengths[key_index] = uint32_t(prefix_length);
+
+			std::memset(m_prefixes + offset, m_indentation_symbol, m_indentation_length);
+			offset += m_indentation_length;
+
+			std::memcpy(m_prefixes + offset, m_keys[key_index], key_length);
+			offset += uint32_t(key_length);
+
+			std::memcpy(m_prefixes + offset, " = ", 3);
+			offset += 3;
+		}
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+
+	inline ArrayWriter::ArrayWriter(StreamWriter& stream_writer, const WriterSettings& settings, uint32_t indent_level)
 		: m_stream_writer(stream_writer)
+		, m_settings(settings)
 		, m_indent_level(indent_level)
 		, m_is_empty(true)
 		, m_is_locked(false)
 		, m_is_newline(false)
 	{}
 
+	inline void ArrayWriter::push_binary(const void* data, size_t size)
+	{
+		SJSON_CPP_ASSERT(!m_is_locked, "Cannot push SJSON value in locked array");
+
+		if (!m_is_empty && !m_is_newline)
+			m_stream_writer.write(", ");
+
+		if (m_is_newline)
+			write_indentation();
+
+		impl::write_base64(m_stream_writer, data, size);
+		m_is_empty = false;
+		m_is_newline = false;
+	}
+
 	inline void ArrayWriter::push(const char* value)
 	{
 		SJSON_CPP_ASSERT(!m_is_locked, "Cannot push SJSON value in locked array");
@@ -676,9 +1163,9 @@ namespace sjson
 			write_indentation();
 
 		char buffer[256];
-		size_t length = snprintf(buffer, sizeof(buffer), "%.17g", value);
-		SJSON_CPP_ASSERT(length > 0 && length < sizeof(buffer), "Failed to push SJSON value: %.17g", value);
-		m_stream_writer.write(buffer, length);
+		const int length = impl::format_double(buffer, sizeof(buffer), value, m_settings);
+		SJSON_CPP_ASSERT(length > 0 && size_t(length) < sizeof(buffer), "Failed to push SJSON value: %.17g", value);
+		m_stream_writer.write(buffer, size_t(length));
 		m_is_empty = false;
 		m_is_newline = false;
 	}
@@ -719,6 +1206,50 @@ namespace sjson
 		m_is_newline = false;
 	}
 
+	template<typename NumberType>
+	inline void ArrayWriter::push_numbers(const NumberType* values, uint32_t num_values)
+	{
+		SJSON_CPP_ASSERT(!m_is_locked, "Cannot push SJSON value in locked array");
+
+		if (num_values == 0)
+			return;
+
+		if (m_is_newline)
+			write_indentation();
+
+		// A formatted double never needs more than 24 symbols, leave some room for the separator
+		constexpr size_t k_max_formatted_number_length = 32;
+
+		char buffer[1024];
+		size_t length = 0;
+
+		for (uint32_t value_index = 0; value_index < num_values; ++value_index)
+		{
+			if (!m_is_empty && !m_is_newline)
+			{
+				buffer[length++] = ',';
+				buffer[length++] = ' ';
+			}
+
+			const double value = double(values[value_index]);
+			const int value_length = impl::format_double(buffer + length, sizeof(buffer) - length, value, m_settings);
+			SJSON_CPP_ASSERT(value_length > 0 && size_t(value_length) < sizeof(buffer) - length, "Failed to push SJSON value: %.17g", value);
+			length += value_length;
+
+			m_is_empty = false;
+			m_is_newline = false;
+
+			if (length > sizeof(buffer) - k_max_formatted_number_length)
+			{
+				m_stream_writer.write(buffer, length);
+				length = 0;
+			}
+		}
+
+		if (length != 0)
+			m_stream_writer.write(buffer, length);
+	}
+
 #if defined(_MSC_VER)
 	inline void ArrayWriter::push(std::function<void(ObjectWriter& object_writer)> writer_fun)
 #else
@@ -730,19 +1261,15 @@ namespace sjson
 		SJSON_CPP_ASSERT(!m_is_locked, "Cannot push SJSON object in locked array");
 
 		if (!m_is_empty && !m_is_newline)
-		{
-			m_stream_writer.write(",");
-			m_stream_writer.write(k_line_terminator);
-		}
-		else if (m_is_empty)
-			m_stream_writer.write(k_line_terminator);
+			m_stream_writer.write(",", 1);
 
-		write_indentation();
+		// Objects always start on a new line
+		write_indentation(m_is_empty || !m_is_newline);
 		m_stream_writer.write("{");
 		m_stream_writer.write(k_line_terminator);
 		m_is_locked = true;
 
-		ObjectWriter object_writer(m_stream_writer, m_indent_level + 1);
+		ObjectWriter object_writer(m_stream_writer, m_settings, m_indent_level + 1);
 		writer_fun(object_writer);
 
 		write_indentation();
@@ -773,7 +1300,7 @@ namespace sjson
 		m_stream_writer.write("[ ");
 		m_is_locked = true;
 
-		ArrayWriter array_writer(m_stream_writer, m_indent_level);
+		ArrayWriter array_writer(m_stream_writer, m_settings, m_indent_level);
 		writer_fun(array_writer);
 
 		m_is_locked = false;
@@ -790,15 +1317,14 @@ namespace sjson
 		m_is_newline = true;
 	}
 
-	inline void ArrayWriter::write_indentation()
+	inline void ArrayWriter::write_indentation(bool with_line_terminator)
 	{
-		for (uint32_t level = 0; level < m_indent_level; ++level)
-			m_stream_writer.write("\t");
+		impl::write_indentation(m_stream_writer, m_settings, m_indent_level, with_line_terminator);
 	}
 
 	//////////////////////////////////////////////////////////////////////////
 
-	inline Writer::Writer(StreamWriter& stream_writer)
-		: ObjectWriter(stream_writer, 0)
+	inline Writer::Writer(StreamWriter& stream_writer, const WriterSettings& settings)
+		: ObjectWriter(stream_writer, settings, 0)
 	{}
 }
@@ -0,0 +1,107 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+// The MIT License (MIT)
+//
+// Copyright (c) 2018 Nicholas Frechette, Cody Jones, and sjson-cpp contributors
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#if defined(_WIN32)
+	#include <direct.h>
+#else
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+// Returns a path in the temporary directory of the platform, tests must not write to the working directory
+inline std::string get_temp_file_path(const char* file_name)
+{
+#if defined(_MSC_VER)
+	#pragma warning(push)
+	#pragma warning(disable : 4996)	// getenv is deprecated
+#endif
+	const char* directory = std::getenv("TMPDIR");
+	if (directory == nullptr)
+		directory = std::getenv("TEMP");
+	if (directory == nullptr)
+		directory = std::getenv("TMP");
+#if defined(_MSC_VER)
+	#pragma warning(pop)
+#endif
+
+	if (directory == nullptr)
+	{
+#if defined(_WIN32)
+		directory = ".";
+#elif defined(__ANDROID__)
+		directory = "/data/local/tmp";
+#else
+		directory = "/tmp";
+#endif
+	}
+
+	std::string path(directory);
+	if (!path.empty() && path.back() != '/' && path.back() != '\\')
+		path += '/';
+
+	path += file_name;
+	return path;
+}
+
+// Writes a whole file and returns whether it succeeded
+inline bool write_temp_file(const std::string& path, const char* content)
+{
+	std::FILE* file = std::fopen(path.c_str(), "wb");
+	if (file == nullptr)
+		return false;
+
+	const size_t content_length = std::strlen(content);
+	const bool is_written = std::fwrite(content, 1, content_length, file) == content_length;
+	std::fclose(file);
+	return is_written;
+}
+
+// Creates a directory, returns whether it exists afterwards
+inline bool create_temp_directory(const std::string& path)
+{
+#if defined(_WIN32)
+	const int result = _mkdir(path.c_str());
+#else
+	const int result = mkdir(path.c_str(), 0755);
+#endif
+	return result == 0 || errno == EEXIST;
+}
+
+// Removes an empty directory
+inline void remove_temp_directory(const std::string& path)
+{
+#if defined(_WIN32)
+	_rmdir(path.c_str());
+#else
+	rmdir(path.c_str());
+#endif
+}
@@ -0,0 +1,170 @@
+////////////////////////////////////////////////////////////////////////////////
+// The MIT License (MIT)
+//
+// Copyright (c) 2018 Nicholas Frechette, Cody Jones, and sjson-cpp contributors
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <catch.hpp>
+
+#include <sjson/array_range.h>
+
+#include <cstring>
+
+using namespace sjson;
+
+TEST_CASE("Array Range", "[array_range]")
+{
+	{
+		const char* input = "values = [ 1.0, 2.0 3.0, 4.5 ] count = 4";
+		Parser parser(input, std::strlen(input));
+
+		ArrayRange<double> values(parser, "values");
+		double sum = 0.0;
+		for (double value : values)
+			sum += value;
+
+		REQUIRE(parser.is_valid());
+		REQUIRE(values.get_num_elements() == 4);
+		REQUIRE(sum == 10.5);
+
+		uint32_t count;
+		REQUIRE(parser.read("count", count));
+		REQUIRE(parser.remainder_is_comments_and_whitespace());
+	}
+
+	{
+		const char* input = "values = [ ] names = [ \"a\", \"bc\" ]";
+		Parser parser(input, std::strlen(input));
+
+		uint32_t num_values = 0;
+		for (int32_t value : read_array_range<int32_t>(parser, "values"))
+			num_values += uint32_t(value);
+		REQUIRE(num_values == 0);
+
+		size_t total_length = 0;
+		for (const StringView& name : read_array_range<StringView>(parser, "names"))
+			total_length += name.size();
+		REQUIRE(total_length == 3);
+		REQUIRE(parser.remainder_is_comments_and_whitespace());
+	}
+
+	{
+		const char* input = "values = [ 1, true, 3 ]";
+		Parser parser(input, std::strlen(input));
+
+		uint32_t num_values = 0;
+		for (double value : read_array_range<double>(parser, "values"))
+			num_values += value == 1.0 ? 1 : 0;
+
+		REQUIRE(num_values == 1);
+		REQUIRE_FALSE(parser.is_valid());
+		REQUIRE(parser.get_error().error == ParserError::NumberExpected);
+	}
+
+	{
+		const char* input = "{ \"values\": [ [ 1, 2 ], [ 3 ] ] }";
+		JSONParser parser(input, std::strlen(input));
+
+		JSONArrayRange<uint8_t> rows(parser, "values");
+		REQUIRE(rows.begin() == rows.end());
+		REQUIRE_FALSE(parser.is_valid());
+	}
+
+	{
+		const char* input = "{ \"values\": [ 1, 2 3 ] }";
+		JSONParser parser(input, std::strlen(input));
+
+		uint32_t num_values = 0;
+		for (uint8_t value : read_array_range<uint8_t>(parser, "values"))
+			num_values += value;
+
+		REQUIRE(num_values == 3);
+		REQUIRE(parser.get_error().error == ParserError::CommaExpected);
+	}
+}
+
+TEST_CASE("Object Range", "[array_range]")
+{
+	{
+		const char* input =
+			"entries = [\r\n"
+			"\t{ name = \"a\" weight = 1.0 }\r\n"
+			"\t{ name = \"b\" weight = 2.0 extra = { ignored = [ 1, 2 ] } }\r\n"
+			"\t{ name = \"c\" }\r\n"
+			"]\r\n"
+			"count = 3\r\n";
+		Parser parser(input, std::strlen(input));
+
+		ObjectRange entries = read_object_range(parser, "entries");
+		double total_weight = 0.0;
+		for (Parser& entry : entries)
+		{
+			StringView name;
+			double weight;
+			REQUIRE(entry.read("name", name));
+			entry.try_read("weight", weight, 0.5);
+			total_weight += weight;
+		}
+
+		REQUIRE(parser.is_valid());
+		REQUIRE(entries.get_num_objects() == 3);
+		REQUIRE(total_weight == 3.5);
+
+		uint32_t count;
+		REQUIRE(parser.read("count", count));
+		REQUIRE(parser.remainder_is_comments_and_whitespace());
+	}
+
+	{
+		const char* input = "{ \"entries\": [ { \"a\": 1, \"b\": [ 2 ], \"c\": 3 }, { \"a\": 4 } ], \"count\": 2 }";
+		JSONParser parser(input, std::strlen(input));
+
+		double sum = 0.0;
+		for (JSONParser& entry : read_object_range(parser, "entries"))
+		{
+			double a = 0.0;
+			REQUIRE(entry.read("a", a));
+			sum += a;
+		}
+
+		REQUIRE(parser.is_valid());
+		REQUIRE(sum == 5.0);
+
+		uint32_t count;
+		REQUIRE(parser.read("count", count));
+		REQUIRE(parser.remainder_is_comments_and_whitespace());
+	}
+
+	{
+		const char* input = "entries = [ { a = 1 } 2 ]";
+		Parser parser(input, std::strlen(input));
+
+		uint32_t num_entries = 0;
+		for (Parser& entry : read_object_range(parser, "entries"))
+		{
+			(void)entry;
+			num_entries++;
+		}
+
+		REQUIRE(num_entries == 1);
+		REQUIRE(parser.get_error().error == ParserError::OpeningBraceExpected);
+	}
+}
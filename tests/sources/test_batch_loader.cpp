@@ -0,0 +1,213 @@
+////////////////////////////////////////////////////////////////////////////////
+// The MIT License (MIT)
+//
+// Copyright (c) 2018 Nicholas Frechette, Cody Jones, and sjson-cpp contributors
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <catch.hpp>
+
+#include "temp_file.h"
+
+#include <sjson/batch_loader.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace sjson;
+
+TEST_CASE("Batch Loader", "[batch_loader]")
+{
+	const std::string path_storage[] =
+	{
+		get_temp_file_path("batch_loader_test_0.sjson"),
+		get_temp_file_path("batch_loader_test_1.sjson"),
+		get_temp_file_path("this/file/does/not/exist.sjson"),
+		get_temp_file_path("batch_loader_test_2.sjson"),
+		get_temp_file_path("batch_loader_test_3.sjson"),
+	};
+
+	const char* paths[] = { path_storage[0].c_str(), path_storage[1].c_str(), path_storage[2].c_str(), path_storage[3].c_str(), path_storage[4].c_str() };
+
+	REQUIRE(write_temp_file(path_storage[0], "id = 0\r\nweight = 1.5\r\n"));
+	REQUIRE(write_temp_file(path_storage[1], "id = 1\r\nweight = 2.5\r\n"));
+	REQUIRE(write_temp_file(path_storage[3], "id = 3\r\nweight = true\r\n"));
+	REQUIRE(write_temp_file(path_storage[4], ""));
+
+	for (uint32_t num_threads = 1; num_threads <= 4; num_threads += 3)
+	{
+		double weights[5] = { 0.0, 0.0, 0.0, 0.0, 0.0 };
+		ParserError errors[5];
+		const uint32_t num_failed = load_files_parallel(paths, 5, num_threads, [&weights](uint32_t file_index, Parser& parser)
+			{
+				uint32_t id;
+				if (parser.read("id", id) && id == file_index)
+					parser.read("weight", weights[file_index]);
+			}, errors);
+
+		REQUIRE(num_failed == 3);
+		REQUIRE(errors[0].error == ParserError::None);
+		REQUIRE(errors[1].error == ParserError::None);
+		REQUIRE(errors[2].error == ParserError::FileCouldNotBeRead);
+		REQUIRE(errors[3].error == ParserError::NumberExpected);
+		REQUIRE(errors[3].line == 2);
+		REQUIRE(errors[4].error == ParserError::InputTruncated);
+		REQUIRE(weights[0] == 1.5);
+		REQUIRE(weights[1] == 2.5);
+	}
+
+	{
+		// Padding is provided by the loader
+		double weight = 0.0;
+		ParserError error;
+		REQUIRE(load_files_parallel<PaddedInputDialect<SJSONDialect>>(paths + 1, 1, 1, [&weight](uint32_t, BasicParser<PaddedInputDialect<SJSONDialect>>& parser)
+			{
+				parser.read("weight", weight);
+				parser.read("id", weight);
+			}, &error) == 1);
+		REQUIRE(error.error == ParserError::IncorrectKey);
+
+		REQUIRE(load_files_parallel<PaddedInputDialect<SJSONDialect>>(paths + 1, 1, 1, [&weight](uint32_t, BasicParser<PaddedInputDialect<SJSONDialect>>& parser)
+			{
+				uint32_t id;
+				parser.read("id", id);
+				parser.read("weight", weight);
+			}, &error) == 0);
+		REQUIRE(weight == 2.5);
+	}
+
+	{
+		// More threads than the loader used to allow
+		std::vector<const char*> many_paths(100, paths[0]);
+		std::vector<ParserError> many_errors(many_paths.size());
+		std::atomic<uint32_t> num_loaded(0);
+		REQUIRE(load_files_parallel(many_paths.data(), 100, 100, [&num_loaded](uint32_t, Parser& parser)
+			{
+				uint32_t id;
+				if (parser.read("id", id))
+					num_loaded++;
+			}, many_errors.data()) == 0);
+		REQUIRE(num_loaded == 100);
+	}
+
+	{
+		// Exceptions reach the caller once every thread is done
+		ParserError errors[5];
+		REQUIRE_THROWS_AS(load_files_parallel(paths, 5, 4, [](uint32_t file_index, Parser&)
+			{
+				if (file_index == 1)
+					throw std::runtime_error("failed");
+			}, errors), const std::runtime_error&);
+	}
+
+	for (const char* path : paths)
+		std::remove(path);
+}
+
+TEST_CASE("Batch Loader Throughput", "[.][benchmark]")
+{
+	// An asset tree: 50 directories of 10 directories of 100 files
+	constexpr uint32_t k_num_directories = 50;
+	constexpr uint32_t k_num_sub_directories = 10;
+	constexpr uint32_t k_num_files_per_directory = 100;
+	constexpr uint32_t k_num_files = k_num_directories * k_num_sub_directories * k_num_files_per_directory;
+
+	const std::string root_path = get_temp_file_path("batch_loader_benchmark");
+	REQUIRE(create_temp_directory(root_path));
+
+	std::vector<std::string> directory_paths;
+	std::vector<std::string> path_storage;
+	std::vector<const char*> paths;
+	path_storage.reserve(k_num_files);
+	paths.reserve(k_num_files);
+
+	for (uint32_t directory_index = 0; directory_index < k_num_directories; ++directory_index)
+	{
+		char name[64];
+		snprintf(name, sizeof(name), "/group_%02u", directory_index);
+		const std::string directory_path = root_path + name;
+		REQUIRE(create_temp_directory(directory_path));
+		directory_paths.push_back(directory_path);
+
+		for (uint32_t sub_directory_index = 0; sub_directory_index < k_num_sub_directories; ++sub_directory_index)
+		{
+			snprintf(name, sizeof(name), "/category_%u", sub_directory_index);
+			const std::string sub_directory_path = directory_path + name;
+			REQUIRE(create_temp_directory(sub_directory_path));
+			directory_paths.push_back(sub_directory_path);
+
+			for (uint32_t index = 0; index < k_num_files_per_directory; ++index)
+			{
+				const uint32_t file_index = uint32_t(path_storage.size());
+				snprintf(name, sizeof(name), "/asset_%05u.sjson", file_index);
+				path_storage.push_back(sub_directory_path + name);
+
+				char content[256];
+				snprintf(content, sizeof(content), "id = %u\r\nname = \"asset_%u\"\r\nbounds = [ 0.0, 1.0, 2.0, 3.0, 4.0, 5.0 ]\r\nflags = { visible = true static = false }\r\n", file_index, file_index);
+				REQUIRE(write_temp_file(path_storage.back(), content));
+			}
+		}
+	}
+
+	for (const std::string& path : path_storage)
+		paths.push_back(path.c_str());
+
+	std::vector<ParserError> errors(k_num_files);
+	std::vector<uint32_t> ids(k_num_files);
+	auto load_asset = [&ids](uint32_t file_index, Parser& parser)
+	{
+		StringView name;
+		double bounds[6];
+		bool visible;
+		bool is_static;
+		parser.read("id", ids[file_index]);
+		parser.read("name", name);
+		parser.read("bounds", bounds, 6);
+		parser.object_begins("flags");
+		parser.read("visible", visible);
+		parser.read("static", is_static);
+		parser.object_ends();
+	};
+
+	const uint32_t num_threads = std::max(1U, std::thread::hardware_concurrency());
+	for (uint32_t threads : { 1U, num_threads })
+	{
+		const auto start = std::chrono::high_resolution_clock::now();
+		const uint32_t num_failed = load_files_parallel(paths.data(), k_num_files, threads, load_asset, errors.data());
+		const auto end = std::chrono::high_resolution_clock::now();
+
+		REQUIRE(num_failed == 0);
+		printf("Loaded %u files on %u threads in %.2f ms\n", k_num_files, threads, std::chrono::duration<double, std::milli>(end - start).count());
+	}
+
+	for (const std::string& path : path_storage)
+		std::remove(path.c_str());
+
+	// Sub directories come after their parent
+	for (auto it = directory_paths.rbegin(); it != directory_paths.rend(); ++it)
+		remove_temp_directory(*it);
+
+	remove_temp_directory(root_path);
+}
@@ -0,0 +1,226 @@
+////////////////////////////////////////////////////////////////////////////////
+// The MIT License (MIT)
+//
+// Copyright (c) 2018 Nicholas Frechette, Cody Jones, and sjson-cpp contributors
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <catch.hpp>
+
+#include <sjson/constexpr_parser.h>
+
+#if defined(SJSON_CPP_HAS_CONSTEXPR_PARSER)
+
+#include <sjson/parser.h>
+
+#include <cstring>
+#include <limits>
+
+using namespace sjson;
+
+namespace
+{
+	struct RenderDefaults
+	{
+		int32_t width;
+		uint8_t quality;
+		int64_t offset;
+		double gamma;
+		float scale;
+		bool vsync;
+		ConstexprStringView name;
+		float color[3];
+	};
+
+	constexpr const char k_render_defaults_input[] =
+		"// Built-in defaults\r\n"
+		"render = {\r\n"
+		"\twidth = 1920\r\n"
+		"\tquality = 255\r\n"
+		"\toffset = -9223372036854775808\r\n"
+		"\t\"gamma\" = 2.2\r\n"
+		"\tscale = 1.5e-3 /* comment */\r\n"
+		"\tvsync = true\r\n"
+		"\tname = \"high \\\"quality\\\"\"\r\n"
+		"\tcolor = [ 1.0, 0.5, 0.25 ]\r\n"
+		"}\r\n";
+
+	constexpr RenderDefaults make_render_defaults()
+	{
+		ConstexprParser parser(k_render_defaults_input);
+		RenderDefaults defaults = {};
+		parser.object_begins("render");
+		parser.read("width", defaults.width);
+		parser.read("quality", defaults.quality);
+		parser.read("offset", defaults.offset);
+		parser.read("gamma", defaults.gamma);
+		parser.read("scale", defaults.scale);
+		parser.read("vsync", defaults.vsync);
+		parser.read("name", defaults.name);
+		parser.read("color", defaults.color);
+		parser.object_ends();
+		parser.remainder_is_comments_and_whitespace();
+		parser.check();
+		return defaults;
+	}
+
+	// Evaluated by the compiler, any parsing error would fail to compile
+	constexpr RenderDefaults k_render_defaults = make_render_defaults();
+
+	static_assert(k_render_defaults.width == 1920, "Unexpected width");
+	static_assert(k_render_defaults.quality == 255, "Unexpected quality");
+	static_assert(k_render_defaults.offset == std::numeric_limits<int64_t>::min(), "Unexpected offset");
+	static_assert(k_render_defaults.gamma == 2.2, "Unexpected gamma");
+	static_assert(k_render_defaults.vsync, "Unexpected vsync");
+	static_assert(k_render_defaults.name == "high \\\"quality\\\"", "Unexpected name");
+	static_assert(k_render_defaults.color[2] == 0.25F, "Unexpected color");
+
+	template<size_t Size>
+	constexpr ConstexprParserError get_error_reading_width(const char (&input)[Size])
+	{
+		ConstexprParser parser(input);
+		uint8_t width = 0;
+		parser.read("width", width);
+		return parser.get_error();
+	}
+
+	static_assert(get_error_reading_width("width = 255").error == ParserError::None, "Unexpected error");
+	static_assert(get_error_reading_width("width = 256").error == ParserError::NumberCouldNotBeConverted, "Unexpected error");
+	static_assert(get_error_reading_width("width = -1").error == ParserError::NumberCouldNotBeConverted, "Unexpected error");
+	static_assert(get_error_reading_width("width = 1.5").error == ParserError::NumberExpected, "Unexpected error");
+	static_assert(get_error_reading_width("width 1").error == ParserError::EqualSignExpected, "Unexpected error");
+	static_assert(get_error_reading_width("height = 1").error == ParserError::IncorrectKey, "Unexpected error");
+	static_assert(get_error_reading_width("\r\n\"width = 1").error == ParserError::InputTruncated, "Unexpected error");
+	static_assert(get_error_reading_width("\r\n  height = 1").line == 2, "Unexpected error line");
+	static_assert(get_error_reading_width("\r\n  height = 1").column == 4, "Unexpected error column");
+
+	template<size_t Size>
+	constexpr ConstexprParserError get_error_reading_gamma(const char (&input)[Size])
+	{
+		ConstexprParser parser(input);
+		double gamma = 0.0;
+		parser.read("gamma", gamma);
+		return parser.get_error();
+	}
+
+	template<size_t Size>
+	constexpr double read_gamma(const char (&input)[Size])
+	{
+		ConstexprParser parser(input);
+		double gamma = 0.0;
+		parser.read("gamma", gamma);
+		return gamma;
+	}
+
+	static_assert(get_error_reading_gamma("gamma = 1e").error == ParserError::InvalidNumber, "Unexpected error");
+	static_assert(get_error_reading_gamma("gamma = 1e400").error == ParserError::None, "Unexpected error");
+	static_assert(read_gamma("gamma = 1e400") == std::numeric_limits<double>::infinity(), "Unexpected value");
+	static_assert(read_gamma("gamma = -1e400") == -std::numeric_limits<double>::infinity(), "Unexpected value");
+	static_assert(read_gamma("gamma = 1e-400") == 0.0, "Unexpected value");
+
+	template<size_t Size>
+	constexpr int32_t read_width(const char (&input)[Size])
+	{
+		ConstexprParser parser(input);
+		int32_t width = -1;
+		parser.read("width", width);
+		return width;
+	}
+
+	// Leading zeros make octal integers like they do at runtime
+	static_assert(read_width("width = 017") == 15, "Unexpected octal value");
+	static_assert(read_width("width = 0x1F") == 31, "Unexpected hexadecimal value");
+	static_assert(read_width("width = -0x10") == -16, "Unexpected hexadecimal value");
+	static_assert(read_width("width = 0") == 0, "Unexpected value");
+}
+
+TEST_CASE("Constexpr Parser", "[constexpr_parser]")
+{
+	// The same code runs at runtime and agrees with the runtime parser
+	const RenderDefaults defaults = make_render_defaults();
+	REQUIRE(defaults.width == k_render_defaults.width);
+	REQUIRE(defaults.gamma == k_render_defaults.gamma);
+
+	Parser parser(k_render_defaults_input, std::strlen(k_render_defaults_input));
+	int32_t width = 0;
+	uint8_t quality = 0;
+	int64_t offset = 0;
+	double gamma = 0.0;
+	float scale = 0.0F;
+	REQUIRE(parser.object_begins("render"));
+	REQUIRE(parser.read("width", width));
+	REQUIRE(parser.read("quality", quality));
+	REQUIRE(parser.read("offset", offset));
+	REQUIRE(parser.read("gamma", gamma));
+	REQUIRE(parser.read("scale", scale));
+	REQUIRE(width == k_render_defaults.width);
+	REQUIRE(quality == k_render_defaults.quality);
+	REQUIRE(offset == k_render_defaults.offset);
+	REQUIRE(gamma == k_render_defaults.gamma);
+	REQUIRE(scale == k_render_defaults.scale);
+
+	const char* inputs[] = { "width = ", "width = x", "width = 99999999999999999999", "width = 1 /x", "width = 017", "width = 0x1F", "width = 0X1f", "width = -010", "width = 0", "width = 0x1p4", "width = 0.5", "width = 0xFFFFFFFF" };
+	for (const char* input : inputs)
+	{
+		ConstexprParser constexpr_parser(input, std::strlen(input));
+		Parser runtime_parser(input, std::strlen(input));
+
+		int32_t constexpr_value = 0;
+		int32_t runtime_value = 0;
+		const bool constexpr_result = constexpr_parser.read("width", constexpr_value) && constexpr_parser.remainder_is_comments_and_whitespace();
+		const bool runtime_result = runtime_parser.read("width", runtime_value) && runtime_parser.remainder_is_comments_and_whitespace();
+
+		REQUIRE(constexpr_result == runtime_result);
+		if (constexpr_result)
+			REQUIRE(constexpr_value == runtime_value);
+		REQUIRE(constexpr_parser.get_error().error == runtime_parser.get_error().error);
+		REQUIRE(constexpr_parser.get_error().line == runtime_parser.get_error().line);
+		REQUIRE(constexpr_parser.get_error().column == runtime_parser.get_error().column);
+	}
+
+	const char* number_inputs[] = { "gamma = 1e", "gamma = 1e+", "gamma = 1e- ", "gamma = 1.", "gamma = 1e5x", "gamma = 1e400", "gamma = -1e400", "gamma = 1e-400", "gamma = 2.5e-3" };
+	for (const char* input : number_inputs)
+	{
+		ConstexprParser constexpr_parser(input, std::strlen(input));
+		Parser runtime_parser(input, std::strlen(input));
+
+		double constexpr_value = 0.0;
+		double runtime_value = 0.0;
+		const bool constexpr_result = constexpr_parser.read("gamma", constexpr_value) && constexpr_parser.remainder_is_comments_and_whitespace();
+		const bool runtime_result = runtime_parser.read("gamma", runtime_value) && runtime_parser.remainder_is_comments_and_whitespace();
+
+		REQUIRE(constexpr_result == runtime_result);
+		if (constexpr_result)
+			REQUIRE(constexpr_value == runtime_value);
+		REQUIRE(constexpr_parser.get_error().error == runtime_parser.get_error().error);
+		REQUIRE(constexpr_parser.get_error().line == runtime_parser.get_error().line);
+		REQUIRE(constexpr_parser.get_error().column == runtime_parser.get_error().column);
+	}
+
+	{
+		const char* input = "scale = 1e39";
+		ConstexprParser constexpr_parser(input, std::strlen(input));
+		float scale = 0.0F;
+		REQUIRE(constexpr_parser.read("scale", scale));
+		REQUIRE(scale == std::numeric_limits<float>::infinity());
+	}
+}
+
+#endif
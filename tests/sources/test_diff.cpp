@@ -0,0 +1,207 @@
+////////////////////////////////////////////////////////////////////////////////
+// The MIT License (MIT)
+//
+// Copyright (c) 2018 Nicholas Frechette, Cody Jones, and sjson-cpp contributors
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <catch.hpp>
+
+#include <sjson/diff.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace sjson;
+
+namespace
+{
+	struct TestDiffEntry
+	{
+		DiffType type;
+		std::string path;
+		std::string old_value;
+		std::string new_value;
+		uint32_t old_line;
+		uint32_t new_line;
+	};
+
+	template<class DialectType = SJSONDialect>
+	std::vector<TestDiffEntry> diff_inputs(const char* old_input, const char* new_input)
+	{
+		BasicParser<DialectType> old_parser(old_input, std::strlen(old_input));
+		BasicParser<DialectType> new_parser(new_input, std::strlen(new_input));
+
+		std::vector<TestDiffEntry> entries;
+		DocumentDiff diff;
+		const bool is_valid = diff.evaluate(old_parser, new_parser, [&entries](const DiffEntry& entry)
+			{
+				TestDiffEntry test_entry;
+				test_entry.type = entry.type;
+				test_entry.path = std::string(entry.path.c_str(), entry.path.size());
+				test_entry.old_value = std::string(entry.old_value.c_str(), entry.old_value.size());
+				test_entry.new_value = std::string(entry.new_value.c_str(), entry.new_value.size());
+				test_entry.old_line = entry.old_line;
+				test_entry.new_line = entry.new_line;
+				entries.push_back(test_entry);
+			});
+
+		REQUIRE(is_valid);
+		REQUIRE(diff.get_num_differences() == entries.size());
+		return entries;
+	}
+}
+
+TEST_CASE("Document Diff", "[diff]")
+{
+	const char* old_input =
+		"version = 3\r\n"
+		"settings = {\r\n"
+		"\trender = { width = 1280 height = 720 }\r\n"
+		"\tname = \"low\"\r\n"
+		"\tlights = [ { intensity = 0.5 } { intensity = 1.5 } ]\r\n"
+		"}\r\n"
+		"removed = true\r\n";
+
+	{
+		// Formatting and comments do not matter
+		const char* new_input =
+			"// Reformatted\r\n"
+			"version = 3 settings = { render = { width = 1280 height = 720 } name = \"low\" lights = [ { intensity = 0.5 }, { intensity = 1.5 } ] }\r\n"
+			"removed = true";
+
+		REQUIRE(diff_inputs(old_input, new_input).empty());
+		REQUIRE(diff_inputs(old_input, old_input).empty());
+	}
+
+	{
+		const char* new_input =
+			"version = 4\r\n"
+			"settings = {\r\n"
+			"\trender = { width = 1920 height = 720 }\r\n"
+			"\tname = \"low\"\r\n"
+			"\tlights = [ { intensity = 0.5 } { intensity = 2.5 } { intensity = 1.0 } ]\r\n"
+			"}\r\n";
+
+		const std::vector<TestDiffEntry> entries = diff_inputs(old_input, new_input);
+		REQUIRE(entries.size() == 5);
+
+		REQUIRE(entries[0].type == DiffType::Changed);
+		REQUIRE(entries[0].path == "version");
+		REQUIRE(entries[0].old_value == "3");
+		REQUIRE(entries[0].new_value == "4");
+		REQUIRE(entries[0].old_line == 1);
+
+		REQUIRE(entries[1].type == DiffType::Changed);
+		REQUIRE(entries[1].path == "settings.render.width");
+		REQUIRE(entries[1].new_value == "1920");
+		REQUIRE(entries[1].new_line == 3);
+
+		REQUIRE(entries[2].path == "settings.lights.1.intensity");
+		REQUIRE(entries[2].old_value == "1.5");
+		REQUIRE(entries[2].new_value == "2.5");
+
+		REQUIRE(entries[3].type == DiffType::Added);
+		REQUIRE(entries[3].path == "settings.lights.2");
+		REQUIRE(entries[3].old_value.empty());
+		REQUIRE(entries[3].new_value == "{ intensity = 1.0 }");
+		REQUIRE(entries[3].old_line == 0);
+
+		REQUIRE(entries[4].type == DiffType::Removed);
+		REQUIRE(entries[4].path == "removed");
+		REQUIRE(entries[4].old_value == "true");
+	}
+
+	{
+		// Reordered members are matched by key
+		const char* new_input =
+			"removed = true\r\n"
+			"added = [ 1 ]\r\n"
+			"settings = { name = \"high\" lights = [ ] render = { height = 720 width = 1280 } }\r\n"
+			"version = 3\r\n";
+
+		const std::vector<TestDiffEntry> entries = diff_inputs(old_input, new_input);
+		REQUIRE(entries.size() == 4);
+
+		REQUIRE(entries[0].type == DiffType::Changed);
+		REQUIRE(entries[0].path == "settings.name");
+		REQUIRE(entries[0].new_value == "\"high\"");
+
+		REQUIRE(entries[1].type == DiffType::Removed);
+		REQUIRE(entries[1].path == "settings.lights.0");
+		REQUIRE(entries[2].type == DiffType::Removed);
+		REQUIRE(entries[2].path == "settings.lights.1");
+
+		REQUIRE(entries[3].type == DiffType::Added);
+		REQUIRE(entries[3].path == "added");
+		REQUIRE(entries[3].new_value == "[ 1 ]");
+	}
+
+	{
+		// A value that changes type is reported as a whole
+		const std::vector<TestDiffEntry> entries = diff_inputs("a = { b = 1 } c = [ 1, 2 ]", "a = [ 1 ] c = [ 1, 2.0 ]");
+		REQUIRE(entries.size() == 2);
+		REQUIRE(entries[0].path == "a");
+		REQUIRE(entries[0].new_value == "[ 1 ]");
+		REQUIRE(entries[1].path == "c.1");
+		REQUIRE(entries[1].new_value == "2.0");
+	}
+
+	{
+		const std::vector<TestDiffEntry> entries = diff_inputs<JSONDialect>("{ \"a\": 1, \"b\": { \"c\": [ 1, 2 ] } }", "{ \"b\": { \"c\": [ 1 ] }, \"a\": 1, \"d\": null }");
+		REQUIRE(entries.size() == 2);
+		REQUIRE(entries[0].type == DiffType::Removed);
+		REQUIRE(entries[0].path == "b.c.1");
+		REQUIRE(entries[1].type == DiffType::Added);
+		REQUIRE(entries[1].path == "d");
+		REQUIRE(entries[1].new_value == "null");
+	}
+
+	{
+		// Reversed members are matched by key, the first of duplicate keys is used
+		std::string old_members;
+		std::string new_members;
+		for (uint32_t member_index = 0; member_index < 200; ++member_index)
+		{
+			old_members += "key" + std::to_string(member_index) + " = { value = " + std::to_string(member_index) + " }\r\n";
+			new_members += "key" + std::to_string(199 - member_index) + " = { value = " + std::to_string(member_index == 0 ? 0 : 199 - member_index) + " }\r\n";
+		}
+
+		new_members += "key7 = 1\r\n";
+
+		const std::vector<TestDiffEntry> entries = diff_inputs(old_members.c_str(), new_members.c_str());
+		REQUIRE(entries.size() == 1);
+		REQUIRE(entries[0].type == DiffType::Changed);
+		REQUIRE(entries[0].path == "key199.value");
+		REQUIRE(entries[0].old_value == "199");
+		REQUIRE(entries[0].new_value == "0");
+	}
+
+	{
+		const char* new_input = "version = 3 settings = { render = { width = } }";
+		Parser old_parser(old_input, std::strlen(old_input));
+		Parser new_parser(new_input, std::strlen(new_input));
+
+		DocumentDiff diff;
+		REQUIRE_FALSE(diff.evaluate(old_parser, new_parser, [](const DiffEntry&) {}));
+		REQUIRE_FALSE(new_parser.is_valid());
+	}
+}
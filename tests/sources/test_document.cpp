@@ -0,0 +1,253 @@
+////////////////////////////////////////////////////////////////////////////////
+// The MIT License (MIT)
+//
+// Copyright (c) 2018 Nicholas Frechette, Cody Jones, and sjson-cpp contributors
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <catch.hpp>
+
+#include <sjson/document.h>
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <thread>
+#include <vector>
+
+using namespace sjson;
+
+static const char* k_document_input =
+	"version = 3\r\n"
+	"render = {\r\n"
+	"\twidth = 1920\r\n"
+	"\tname = \"high\"\r\n"
+	"\tvsync = true\r\n"
+	"\tgamma = 2.2\r\n"
+	"\tlights = [ { intensity = 0.5 } { intensity = 1.5 color = [ 1, 0, 0 ] } ]\r\n"
+	"\tnothing = null\r\n"
+	"}\r\n";
+
+TEST_CASE("Document", "[document]")
+{
+	std::shared_ptr<const Document> document = Document::parse(k_document_input, std::strlen(k_document_input));
+	REQUIRE(document);
+	REQUIRE(document->get_num_values() == 17);
+
+	// The document owns its input
+	REQUIRE(document->get_input().c_str() != k_document_input);
+
+	uint32_t version = 0;
+	REQUIRE(document->find("version").get(version));
+	REQUIRE(version == 3);
+
+	int16_t width = 0;
+	REQUIRE(document->find("render.width").get(width));
+	REQUIRE(width == 1920);
+
+	int8_t small_width = 0;
+	REQUIRE_FALSE(document->find("render.width").get(small_width));
+
+	StringView name;
+	REQUIRE(document->find("render.name").get(name));
+	REQUIRE(name == "high");
+
+	bool vsync = false;
+	REQUIRE(document->find("render.vsync").get(vsync));
+	REQUIRE(vsync);
+
+	double gamma = 0.0;
+	REQUIRE(document->find("render.gamma").get(gamma));
+	REQUIRE(gamma == 2.2);
+
+	int32_t integer_gamma = 0;
+	REQUIRE_FALSE(document->find("render.gamma").get(integer_gamma));
+	REQUIRE_FALSE(document->find("render.gamma").get(name));
+
+	float intensity = 0.0F;
+	REQUIRE(document->find("/render/lights/1/intensity").get(intensity));
+	REQUIRE(intensity == 1.5F);
+
+	REQUIRE(document->find("render.nothing").get_type() == ValueType::Null);
+	REQUIRE_FALSE(document->find("render.missing").is_valid());
+	REQUIRE_FALSE(document->find("render.lights.2").is_valid());
+	REQUIRE_FALSE(document->find("render.lights.x").is_valid());
+	REQUIRE_FALSE(document->find("version.x").is_valid());
+
+	DocumentValue lights = document->find("render.lights");
+	REQUIRE(lights.get_type() == ValueType::Array);
+	REQUIRE(lights.get_num_children() == 2);
+	REQUIRE(lights.get_line() == 7);
+	REQUIRE(lights.get_raw_value() == "[ { intensity = 0.5 } { intensity = 1.5 color = [ 1, 0, 0 ] } ]");
+
+	DocumentValue color = lights.get_child(1).find("color");
+	REQUIRE(color.get_key() == "color");
+	REQUIRE(color.get_num_children() == 3);
+	REQUIRE(color.get_child(0).get(intensity));
+	REQUIRE(intensity == 1.0F);
+	REQUIRE_FALSE(color.get_child(3).is_valid());
+
+	DocumentValue root = document->get_root();
+	REQUIRE(root.get_num_children() == 2);
+	REQUIRE(root.get_child(1).get_key() == "render");
+	REQUIRE(root.find_member("render").get_num_children() == 6);
+	REQUIRE_FALSE(root.find_member("render.width").is_valid());
+	REQUIRE_FALSE(lights.find_member("0").is_valid());
+	REQUIRE(document->get_value(lights.get_index()).get_raw_value() == lights.get_raw_value());
+	REQUIRE_FALSE(document->get_value(document->get_num_values()).is_valid());
+
+	{
+		const char* json = "{ \"size\": [ 2, 4 ], \"name\": \"grid\" }";
+		std::shared_ptr<const Document> json_document = Document::parse<JSONDialect>(json, std::strlen(json));
+		REQUIRE(json_document);
+
+		uint32_t size = 0;
+		REQUIRE(json_document->find("size.1").get(size));
+		REQUIRE(size == 4);
+	}
+
+	{
+		const char* numbers = "octal = 017 hex = 0x1F max = 18446744073709551615 min = -9223372036854775808 real = 1e3 negative_zero = -0 hex_float = 0x1.8p1";
+		std::shared_ptr<const Document> number_document = Document::parse(numbers, std::strlen(numbers));
+		REQUIRE(number_document);
+
+		int32_t value = 0;
+		REQUIRE(number_document->find("octal").get(value));
+		REQUIRE(value == 15);
+		REQUIRE(number_document->find("hex").get(value));
+		REQUIRE(value == 31);
+
+		uint64_t max_value = 0;
+		int64_t signed_value = 0;
+		REQUIRE(number_document->find("max").get(max_value));
+		REQUIRE(max_value == 18446744073709551615ULL);
+		REQUIRE_FALSE(number_document->find("max").get(signed_value));
+		REQUIRE_FALSE(number_document->find("max").get(value));
+		REQUIRE(number_document->find("min").get(signed_value));
+		REQUIRE(signed_value == std::numeric_limits<int64_t>::min());
+		REQUIRE_FALSE(number_document->find("min").get(max_value));
+
+		double real = 0.0;
+		REQUIRE(number_document->find("max").get(real));
+		REQUIRE(real == 18446744073709551615.0);
+		REQUIRE(number_document->find("real").get(real));
+		REQUIRE(real == 1000.0);
+		REQUIRE_FALSE(number_document->find("real").get(value));
+		REQUIRE(number_document->find("negative_zero").get(real));
+		REQUIRE(std::signbit(real));
+		REQUIRE(number_document->find("hex_float").get(real));
+		REQUIRE(real == 3.0);
+	}
+
+	{
+		const char* invalid = "a = {\r\n\tb = [ 1 }";
+		ParserError error;
+		REQUIRE_FALSE(Document::parse(invalid, std::strlen(invalid), &error));
+		REQUIRE(error.error == ParserError::NumberExpected);
+		REQUIRE(error.line == 2);
+	}
+
+	if (sizeof(size_t) > sizeof(uint32_t))
+	{
+		// Inputs beyond 32 bit offsets are refused before they are read
+		const uint64_t too_large = uint64_t(std::numeric_limits<uint32_t>::max()) + 1;
+		ParserError error;
+		REQUIRE_FALSE(Document::parse("a = 1", size_t(too_large), &error));
+		REQUIRE(error.error == ParserError::InputTooLarge);
+	}
+}
+
+TEST_CASE("Document Concurrent Readers", "[document]")
+{
+	std::shared_ptr<const Document> document = Document::parse(k_document_input, std::strlen(k_document_input));
+	REQUIRE(document);
+
+	constexpr uint32_t k_num_threads = 8;
+	std::atomic<uint32_t> num_failures(0);
+
+	std::vector<std::thread> threads;
+	for (uint32_t thread_index = 0; thread_index < k_num_threads; ++thread_index)
+	{
+		// Every thread holds its own reference to the document
+		threads.push_back(std::thread([document, &num_failures]()
+		{
+			for (uint32_t iteration = 0; iteration < 10000; ++iteration)
+			{
+				uint32_t width = 0;
+				double intensity = 0.0;
+				if (!document->find("render.width").get(width) || width != 1920
+					|| !document->find("render.lights.1.intensity").get(intensity) || intensity != 1.5)
+					num_failures++;
+			}
+		}));
+	}
+
+	for (std::thread& thread : threads)
+		thread.join();
+
+	REQUIRE(num_failures == 0);
+}
+
+// Hidden by default, run it explicitly with the [benchmark] tag
+TEST_CASE("Document Query Throughput", "[.][benchmark]")
+{
+	std::shared_ptr<const Document> document = Document::parse(k_document_input, std::strlen(k_document_input));
+	REQUIRE(document);
+
+	constexpr uint32_t k_num_queries_per_thread = 2000000;
+	const uint32_t max_num_threads = std::max(1U, std::thread::hardware_concurrency());
+
+	for (uint32_t num_threads = 1; num_threads <= max_num_threads; num_threads *= 2)
+	{
+		std::atomic<uint64_t> checksum(0);
+
+		const auto start_time = std::chrono::high_resolution_clock::now();
+
+		std::vector<std::thread> threads;
+		for (uint32_t thread_index = 0; thread_index < num_threads; ++thread_index)
+		{
+			threads.push_back(std::thread([document, &checksum]()
+			{
+				uint64_t sum = 0;
+				for (uint32_t query_index = 0; query_index < k_num_queries_per_thread; ++query_index)
+				{
+					uint32_t width = 0;
+					document->find("render.lights.1.intensity");
+					document->find("render.width").get(width);
+					sum += width;
+				}
+				checksum += sum;
+			}));
+		}
+
+		for (std::thread& thread : threads)
+			thread.join();
+
+		const auto end_time = std::chrono::high_resolution_clock::now();
+		const double elapsed_seconds = std::chrono::duration<double>(end_time - start_time).count();
+		const double num_queries = 2.0 * k_num_queries_per_thread * num_threads;
+
+		std::printf("%2u threads: %8.2f million queries/sec\n", num_threads, num_queries / elapsed_seconds / 1000000.0);
+		REQUIRE(checksum == uint64_t(1920) * k_num_queries_per_thread * num_threads);
+	}
+}
@@ -0,0 +1,215 @@
+////////////////////////////////////////////////////////////////////////////////
+// The MIT License (MIT)
+//
+// Copyright (c) 2018 Nicholas Frechette, Cody Jones, and sjson-cpp contributors
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <catch.hpp>
+
+#include <sjson/document_overlay.h>
+
+#include <cstring>
+
+using namespace sjson;
+
+static std::shared_ptr<const Document> parse_layer(const char* input)
+{
+	return Document::parse(input, std::strlen(input));
+}
+
+TEST_CASE("Document Overlay", "[document_overlay]")
+{
+	std::shared_ptr<const Document> base = parse_layer(
+		"version = 1\r\n"
+		"render = {\r\n"
+		"\twidth = 1280\r\n"
+		"\theight = 720\r\n"
+		"\tshadows = { enabled = true resolution = 1024 }\r\n"
+		"\tlights = [ 1, 2, 3 ]\r\n"
+		"}\r\n"
+		"audio = { volume = 0.5 }\r\n");
+	std::shared_ptr<const Document> platform = parse_layer(
+		"render = {\r\n"
+		"\twidth = 1920\r\n"
+		"\tshadows = { resolution = 2048 }\r\n"
+		"\tlights = [ 4 ]\r\n"
+		"}\r\n");
+	std::shared_ptr<const Document> user = parse_layer(
+		"render = { height = 1080 }\r\n"
+		"audio = \"muted\"\r\n");
+	REQUIRE(base);
+	REQUIRE(platform);
+	REQUIRE(user);
+
+	DocumentOverlay overlay;
+	REQUIRE_FALSE(overlay.find("version").is_valid());
+
+	REQUIRE(overlay.add_layer(base) == 0);
+	REQUIRE(overlay.add_layer(platform) == 1);
+	REQUIRE(overlay.add_layer(user) == 2);
+	REQUIRE(overlay.get_num_layers() == 3);
+	REQUIRE(overlay.get_root().get_num_sources() == 3);
+
+	uint32_t value = 0;
+	REQUIRE(overlay.find("version").get(value));
+	REQUIRE(value == 1);
+	REQUIRE(overlay.find("render.width").get(value));
+	REQUIRE(value == 1920);
+	REQUIRE(overlay.find("render.height").get(value));
+	REQUIRE(value == 1080);
+	REQUIRE(overlay.find("render.shadows.resolution").get(value));
+	REQUIRE(value == 2048);
+	REQUIRE(overlay.find("/render/shadows/resolution").get(value));
+	REQUIRE(value == 2048);
+
+	bool enabled = false;
+	REQUIRE(overlay.find("render.shadows.enabled").get(enabled));
+	REQUIRE(enabled);
+
+	// Objects merge with every layer that has them
+	OverlayValue render = overlay.find("render");
+	REQUIRE(render.get_type() == ValueType::Object);
+	REQUIRE(render.get_num_sources() == 3);
+	REQUIRE(render.get_source_layer(0) == 2);
+	REQUIRE(render.get_source_layer(2) == 0);
+	REQUIRE(render.find("width").get(value));
+	REQUIRE(value == 1920);
+
+	// The location comes from the layer that defines the value
+	OverlayValue width = overlay.find("render.width");
+	REQUIRE(width.get_num_sources() == 1);
+	REQUIRE(width.get_source_layer(0) == 1);
+	REQUIRE(width.get_value().get_line() == 2);
+
+	// Arrays are replaced as a whole
+	OverlayValue lights = overlay.find("render.lights");
+	REQUIRE(lights.get_type() == ValueType::Array);
+	REQUIRE(lights.get_value().get_num_children() == 1);
+	REQUIRE(overlay.find("render.lights.0").get(value));
+	REQUIRE(value == 4);
+	REQUIRE_FALSE(overlay.find("render.lights.1").is_valid());
+	REQUIRE_FALSE(overlay.find("render.lights.x").is_valid());
+
+	// Other values hide the objects below them
+	StringView audio;
+	REQUIRE(overlay.find("audio").get(audio));
+	REQUIRE(audio == "muted");
+	REQUIRE(overlay.find("audio").get_num_sources() == 1);
+	REQUIRE_FALSE(overlay.find("audio.volume").is_valid());
+
+	REQUIRE_FALSE(overlay.find("render.depth").is_valid());
+	REQUIRE_FALSE(overlay.find("version.major").is_valid());
+	REQUIRE_FALSE(overlay.find("render.width").get(audio));
+
+	// Removing a layer reveals the values under it
+	REQUIRE(overlay.remove_layer(user.get()));
+	REQUIRE_FALSE(overlay.remove_layer(user.get()));
+	REQUIRE(overlay.get_num_layers() == 2);
+
+	double volume = 0.0;
+	REQUIRE(overlay.find("audio.volume").get(volume));
+	REQUIRE(volume == 0.5);
+	REQUIRE(overlay.find("render.height").get(value));
+	REQUIRE(value == 720);
+
+	REQUIRE(overlay.remove_layer(platform.get()));
+	REQUIRE(overlay.find("render.width").get(value));
+	REQUIRE(value == 1280);
+	REQUIRE(overlay.find("render.lights").get_value().get_num_children() == 3);
+
+	// An object on top replaces a lower value that isn't one
+	overlay.add_layer(parse_layer("version = { major = 2 }\r\n"));
+	REQUIRE(overlay.find("version.major").get(value));
+	REQUIRE(value == 2);
+	REQUIRE(overlay.find("version").get_num_sources() == 1);
+
+	overlay.clear();
+	REQUIRE_FALSE(overlay.find("render").is_valid());
+}
+
+TEST_CASE("Document Overlay Stale Values", "[document_overlay]")
+{
+	DocumentOverlay overlay;
+	overlay.add_layer(parse_layer("a = { x = 1 }\r\n"));
+	std::shared_ptr<const Document> middle = parse_layer("a = { x = 2 }\r\n");
+	overlay.add_layer(middle);
+	overlay.add_layer(parse_layer("b = 3\r\n"));
+
+	OverlayValue a = overlay.find("a");
+	OverlayValue x = overlay.find("a.x");
+	REQUIRE(a.get_num_sources() == 2);
+	REQUIRE(x.get_source_layer(0) == 1);
+
+	// The top layer moves down into the slot of the middle one, values found before must not read it
+	REQUIRE(overlay.remove_layer(middle.get()));
+
+	uint32_t value = 0;
+	REQUIRE_FALSE(x.is_valid());
+	REQUIRE_FALSE(x.get(value));
+	REQUIRE_FALSE(x.get_source(0).is_valid());
+	REQUIRE(x.get_num_sources() == 0);
+	REQUIRE_FALSE(a.find("x").is_valid());
+
+	// Values found again see the current layers
+	REQUIRE(overlay.find("a.x").get(value));
+	REQUIRE(value == 1);
+
+	// Adding a layer makes values stale as well, they would miss its members
+	x = overlay.find("a.x");
+	overlay.add_layer(parse_layer("a = { x = 4 }\r\n"));
+	REQUIRE_FALSE(x.is_valid());
+	REQUIRE(overlay.find("a.x").get(value));
+	REQUIRE(value == 4);
+}
+
+TEST_CASE("Document Overlay Hidden Layers", "[document_overlay]")
+{
+	DocumentOverlay overlay;
+	overlay.add_layer(parse_layer("a = { x = 1 y = 1 }\r\n"));
+	overlay.add_layer(parse_layer("a = 2\r\n"));
+	overlay.add_layer(parse_layer("a = { y = 3 }\r\n"));
+
+	// Merging bottom-up, the middle layer drops 'x' before the top one restores an object
+	uint32_t value = 0;
+	REQUIRE(overlay.find("a").get_num_sources() == 1);
+	REQUIRE(overlay.find("a.y").get(value));
+	REQUIRE(value == 3);
+	REQUIRE_FALSE(overlay.find("a.x").is_valid());
+
+	const uint32_t invalid_layer_index = DocumentOverlay::k_invalid_layer_index;
+	const uint32_t max_num_layers = DocumentOverlay::k_max_num_layers;
+	REQUIRE(overlay.add_layer(nullptr) == invalid_layer_index);
+	REQUIRE(overlay.get_num_layers() == 3);
+
+	// Layers beyond the limit are refused
+	for (uint32_t layer_index = 3; layer_index < max_num_layers; ++layer_index)
+		REQUIRE(overlay.add_layer(parse_layer("a = { z = 4 }\r\n")) == layer_index);
+
+	REQUIRE(overlay.add_layer(parse_layer("a = { z = 5 }\r\n")) == invalid_layer_index);
+	REQUIRE(overlay.get_num_layers() == max_num_layers);
+
+	// Every layer but the two at the bottom contributes to the object
+	REQUIRE(overlay.find("a").get_num_sources() == max_num_layers - 2);
+	REQUIRE(overlay.find("a.z").get(value));
+	REQUIRE(value == 4);
+	REQUIRE(overlay.find("a.y").get(value));
+	REQUIRE(value == 3);
+}
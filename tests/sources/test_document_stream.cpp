@@ -0,0 +1,158 @@
+////////////////////////////////////////////////////////////////////////////////
+// The MIT License (MIT)
+//
+// Copyright (c) 2018 Nicholas Frechette, Cody Jones, and sjson-cpp contributors
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <catch.hpp>
+
+#include <sjson/document_stream.h>
+
+#include <cstdio>
+#include <cstring>
+
+using namespace sjson;
+
+TEST_CASE("Document Stream", "[document_stream]")
+{
+	{
+		const char* input =
+			"{ type = \"load\" time = 1.5 }\r\n"
+			"// Comments between documents are skipped\r\n"
+			"{ type = \"save\" nested = { a = \"}\" } }{}\r\n";
+
+		DocumentStream stream(input, std::strlen(input));
+		StreamDocument document;
+
+		REQUIRE(stream.read_next(document));
+		REQUIRE(document.index == 0);
+		REQUIRE(document.line == 1);
+		REQUIRE(document.content == " type = \"load\" time = 1.5 ");
+
+		Parser parser(document.content.c_str(), document.content.size());
+		StringView type;
+		double time = 0.0;
+		REQUIRE(parser.read("type", type));
+		REQUIRE(parser.read("time", time));
+		REQUIRE(parser.remainder_is_comments_and_whitespace());
+		REQUIRE(type == "load");
+		REQUIRE(time == 1.5);
+
+		REQUIRE(stream.read_next(document));
+		REQUIRE(document.index == 1);
+		REQUIRE(document.line == 3);
+		REQUIRE(document.content == " type = \"save\" nested = { a = \"}\" } ");
+
+		REQUIRE(stream.read_next(document));
+		REQUIRE(document.index == 2);
+		REQUIRE(document.content.size() == 0);
+
+		REQUIRE_FALSE(stream.read_next(document));
+		REQUIRE(stream.eof());
+		REQUIRE(stream.is_valid());
+		REQUIRE(stream.get_num_documents() == 3);
+	}
+
+	{
+		const char* input = "{ \"a\": 1 }\n{ \"a\": 2 }\n";
+
+		JSONDocumentStream stream(input, std::strlen(input));
+		StreamDocument documents[4];
+		REQUIRE(stream.read_batch(documents, 4) == 2);
+		REQUIRE(stream.is_valid());
+
+		JSONParser parser(documents[1].content.c_str(), documents[1].content.size());
+		int32_t value = 0;
+		REQUIRE(parser.read("a", value));
+		REQUIRE(parser.remainder_is_comments_and_whitespace());
+		REQUIRE(value == 2);
+	}
+
+	{
+		const char* input = "{ a = 1 }\r\nb = 2";
+
+		DocumentStream stream(input, std::strlen(input));
+		StreamDocument document;
+		REQUIRE(stream.read_next(document));
+		REQUIRE_FALSE(stream.read_next(document));
+		REQUIRE(stream.get_error().error == ParserError::OpeningBraceExpected);
+		REQUIRE(stream.get_error().line == 2);
+	}
+
+	{
+		const char* input = "{ \"a\": 1 }\n[ 2 ]\n";
+
+		JSONDocumentStream stream(input, std::strlen(input));
+		StreamDocument document;
+		REQUIRE(stream.read_next(document));
+		REQUIRE_FALSE(stream.read_next(document));
+		REQUIRE(stream.get_error().error == ParserError::OpeningBraceExpected);
+		REQUIRE(stream.get_error().line == 2);
+	}
+
+	{
+		const char* input = "{ a = 1 } { a = [ 2 }";
+
+		DocumentStream stream(input, std::strlen(input));
+		StreamDocument document;
+		REQUIRE(stream.read_next(document));
+		REQUIRE_FALSE(stream.read_next(document));
+		REQUIRE(stream.get_error().error == ParserError::InputTruncated);
+	}
+}
+
+TEST_CASE("Document Stream Parallel Parsing", "[document_stream]")
+{
+	constexpr uint32_t k_num_documents = 200;
+
+	char input[k_num_documents * 32];
+	size_t input_length = 0;
+	for (uint32_t document_index = 0; document_index < k_num_documents; ++document_index)
+		input_length += snprintf(input + input_length, sizeof(input) - input_length, "{ value = %u }\n", document_index * 3);
+
+	DocumentStream stream(input, input_length);
+	StreamDocument documents[64];
+	uint32_t results[64];
+
+	auto parse_value = [](const StreamDocument& document, uint32_t& result)
+	{
+		Parser parser(document.content.c_str(), document.content.size());
+		if (!parser.read("value", result))
+			result = 0xFFFFFFFFu;
+	};
+
+	uint32_t num_parsed = 0;
+	uint32_t num_documents;
+	while ((num_documents = stream.read_batch(documents, 64)) != 0)
+	{
+		parse_documents_parallel(documents, num_documents, results, 4, parse_value);
+
+		for (uint32_t document_index = 0; document_index < num_documents; ++document_index)
+		{
+			REQUIRE(documents[document_index].index == num_parsed);
+			REQUIRE(results[document_index] == num_parsed * 3);
+			num_parsed++;
+		}
+	}
+
+	REQUIRE(stream.is_valid());
+	REQUIRE(num_parsed == k_num_documents);
+}
@@ -0,0 +1,149 @@
+////////////////////////////////////////////////////////////////////////////////
+// The MIT License (MIT)
+//
+// Copyright (c) 2018 Nicholas Frechette, Cody Jones, and sjson-cpp contributors
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <catch.hpp>
+
+#include <sjson/fingerprint.h>
+
+#include <cstring>
+#include <vector>
+
+using namespace sjson;
+
+template<class DialectType = SJSONDialect>
+static uint64_t fingerprint_of(const char* input)
+{
+	BasicParser<DialectType> parser(input, std::strlen(input));
+	uint64_t fingerprint = 0;
+	const bool is_valid = read_document_fingerprint(parser, fingerprint);
+	REQUIRE(is_valid);
+	return fingerprint;
+}
+
+TEST_CASE("Fingerprint", "[fingerprint]")
+{
+	const char* input =
+		"// A mesh\r\n"
+		"mesh = { name = \"hero\" lods = [ 1, 2, 3 ] }\r\n"
+		"material = { roughness = 0.5 }\r\n";
+
+	const uint64_t fingerprint = fingerprint_of(input);
+
+	// Whitespace, comments, and optional commas do not matter
+	REQUIRE(fingerprint_of("mesh={name=\"hero\" lods=[1 2 3]} /* */ material={roughness=0.5}") == fingerprint);
+
+	// Neither does the dialect
+	REQUIRE(fingerprint_of<JSONDialect>("{ \"mesh\": { \"name\": \"hero\", \"lods\": [ 1, 2, 3 ] }, \"material\": { \"roughness\": 0.5 } }") == fingerprint);
+
+	// Keys, values, order, and structure do
+	REQUIRE(fingerprint_of("mesh = { name = \"hero\" lods = [ 1, 2, 4 ] } material = { roughness = 0.5 }") != fingerprint);
+	REQUIRE(fingerprint_of("mesh = { name = \"hero\" lods = [ 1, 3, 2 ] } material = { roughness = 0.5 }") != fingerprint);
+	REQUIRE(fingerprint_of("mesh = { name = \"hero\" lodz = [ 1, 2, 3 ] } material = { roughness = 0.5 }") != fingerprint);
+	REQUIRE(fingerprint_of("mesh = { name = \"hero\" lods = [ [ 1, 2 ], 3 ] } material = { roughness = 0.5 }") != fingerprint);
+	REQUIRE(fingerprint_of("mesh = { name = \"hero\" lods = [ 1, 2, 3 ] } material = { roughness = 0.50 }") != fingerprint);
+	REQUIRE(fingerprint_of("mesh = { name = \"hero\" lods = [ 1, 2, 3 ] } material = { roughness = \"0.5\" }") != fingerprint);
+	REQUIRE(fingerprint_of("mesh = { } material = { }") != fingerprint_of("mesh = [ ] material = { }"));
+
+	{
+		Parser parser(input, std::strlen(input));
+		uint64_t mesh_fingerprint;
+		uint64_t material_fingerprint;
+		StringView key;
+		REQUIRE(parser.read_next_key(key));
+		REQUIRE(read_fingerprint(parser, mesh_fingerprint));
+		REQUIRE(parser.read_next_key(key));
+		REQUIRE(read_fingerprint(parser, material_fingerprint));
+		REQUIRE(mesh_fingerprint != material_fingerprint);
+		REQUIRE(parser.remainder_is_comments_and_whitespace());
+	}
+}
+
+TEST_CASE("Subtree Fingerprints", "[fingerprint]")
+{
+	const char* paths[] = { "mesh", "mesh.lods", "material.roughness", "missing" };
+
+	const char* before = "mesh = { name = \"hero\" lods = [ 1, 2, 3 ] } material = { roughness = 0.5 }";
+	const char* after = "mesh = { name = \"villain\" lods = [ 1, 2, 3 ] } // Tweaked\r\nmaterial = { roughness = 0.5 }";
+
+	SubtreeFingerprints before_fingerprints(paths, 4);
+	Parser before_parser(before, std::strlen(before));
+	REQUIRE(before_fingerprints.evaluate(before_parser));
+
+	SubtreeFingerprints after_fingerprints(paths, 4);
+	Parser after_parser(after, std::strlen(after));
+	REQUIRE(after_fingerprints.evaluate(after_parser));
+
+	REQUIRE(before_fingerprints.is_found(0));
+	REQUIRE(before_fingerprints.get_fingerprint(0) != after_fingerprints.get_fingerprint(0));
+	REQUIRE(before_fingerprints.get_fingerprint(1) == after_fingerprints.get_fingerprint(1));
+	REQUIRE(before_fingerprints.get_fingerprint(2) == after_fingerprints.get_fingerprint(2));
+	REQUIRE_FALSE(before_fingerprints.is_found(3));
+
+	// The fingerprint of a subtree is the one of the same value read on its own
+	uint64_t lods_fingerprint = 0;
+	Parser lods_parser("[1,2,3]", 7);
+	REQUIRE(read_fingerprint(lods_parser, lods_fingerprint));
+	REQUIRE(lods_fingerprint == before_fingerprints.get_fingerprint(1));
+
+	{
+		// JSON subtrees are read with the JSON dialect and hash like their SJSON equivalent
+		const char* json = "{ \"mesh\": { \"name\": \"hero\", \"lods\": [ 1, 2, 3 ] },\r\n\"material\": { \"roughness\": 0.5 } }";
+		const char* json_paths[] = { "/mesh", "/mesh/lods", "/material" };
+		SubtreeFingerprints json_fingerprints(json_paths, 3);
+		JSONParser parser(json, std::strlen(json));
+		REQUIRE(json_fingerprints.evaluate(parser));
+		REQUIRE(json_fingerprints.get_fingerprint(0) == before_fingerprints.get_fingerprint(0));
+		REQUIRE(json_fingerprints.get_fingerprint(1) == before_fingerprints.get_fingerprint(1));
+
+		const char* invalid_json = "{ \"mesh\": { \"name\" = \"hero\" } }";
+		const char* mesh_path[] = { "/mesh" };
+		SubtreeFingerprints invalid_fingerprints(mesh_path, 1);
+		JSONParser invalid_parser(invalid_json, std::strlen(invalid_json));
+		REQUIRE_FALSE(invalid_fingerprints.evaluate(invalid_parser));
+		REQUIRE(invalid_parser.get_error().error == ParserError::KeyValueSeparatorExpected);
+	}
+
+	{
+		const char* invalid = "version = 1\r\nmesh = { lods = [ 1, = ] }";
+		const char* mesh_path[] = { "mesh" };
+		SubtreeFingerprints fingerprints(mesh_path, 1);
+		Parser parser(invalid, std::strlen(invalid));
+		REQUIRE_FALSE(fingerprints.evaluate(parser));
+		REQUIRE_FALSE(parser.is_valid());
+		REQUIRE(parser.get_error().line == 2);
+	}
+	{
+		// Subtrees of a padded input are slices which aren't padded themselves
+		const size_t before_length = std::strlen(before);
+		std::vector<char> buffer(get_padded_input_size(before_length));
+		REQUIRE(make_padded_input(before, before_length, buffer.data(), buffer.size()));
+
+		SubtreeFingerprints padded_fingerprints(paths, 4);
+		BasicParser<PaddedInputDialect<SJSONDialect>> parser(buffer.data(), before_length);
+		REQUIRE(padded_fingerprints.evaluate(parser));
+		REQUIRE(padded_fingerprints.get_fingerprint(0) == before_fingerprints.get_fingerprint(0));
+		REQUIRE(padded_fingerprints.get_fingerprint(1) == before_fingerprints.get_fingerprint(1));
+		REQUIRE(padded_fingerprints.get_fingerprint(2) == before_fingerprints.get_fingerprint(2));
+	}
+}
@@ -0,0 +1,233 @@
+////////////////////////////////////////////////////////////////////////////////
+// The MIT License (MIT)
+//
+// Copyright (c) 2018 Nicholas Frechette, Cody Jones, and sjson-cpp contributors
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <catch.hpp>
+
+#include "temp_file.h"
+
+#include <sjson/include_cache.h>
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+using namespace sjson;
+
+namespace
+{
+	void write_test_file(const char* path, const char* content)
+	{
+		std::FILE* file = std::fopen(path, "wb");
+		REQUIRE(file != nullptr);
+		std::fwrite(content, 1, std::strlen(content), file);
+		std::fclose(file);
+	}
+}
+
+TEST_CASE("Include Cache", "[include_cache]")
+{
+	const char* paths[] =
+	{
+		"include_cache_test_root.sjson",
+		"include_cache_test_render.sjson",
+		"include_cache_test_light.sjson",
+	};
+
+	write_test_file(paths[0],
+		"name = \"root\"\r\n"
+		"render = { include = \"include_cache_test_render.sjson\" }\r\n"
+		"lights = [ { include = \"include_cache_test_light.sjson\" } { include = \"include_cache_test_light.sjson\" } ]\r\n");
+	write_test_file(paths[1],
+		"width = 1920\r\n"
+		"shadows = { include = \"include_cache_test_light.sjson\" }\r\n");
+	write_test_file(paths[2], "intensity = 1.5\r\n");
+
+	for (uint32_t num_threads = 1; num_threads <= 100; num_threads *= 10)
+	{
+		IncludeCache cache(num_threads);
+		IncludeError error;
+		std::shared_ptr<const IncludedFile> root = cache.load(paths[0], &error);
+		REQUIRE(root);
+		REQUIRE(error.error == ParserError::None);
+		REQUIRE(root->get_path() == paths[0]);
+		REQUIRE(root->get_num_includes() == 3);
+
+		// Shared includes are loaded once
+		REQUIRE(cache.get_num_files() == 3);
+		REQUIRE(root->get_include(1) == root->get_include(2));
+		REQUIRE(root->get_include(0)->get_include(0) == root->get_include(1));
+
+		StringView name;
+		REQUIRE(root->find("name").get(name));
+		REQUIRE(name == "root");
+
+		uint32_t width = 0;
+		IncludeValue width_value = root->find("render.width");
+		REQUIRE(width_value.get(width));
+		REQUIRE(width == 1920);
+		REQUIRE(width_value.get_file()->get_path() == paths[1]);
+		REQUIRE(width_value.get_value().get_line() == 1);
+
+		double intensity = 0.0;
+		REQUIRE(root->find("lights.1.intensity").get(intensity));
+		REQUIRE(intensity == 1.5);
+		REQUIRE(root->find("/render/shadows/intensity").get(intensity));
+		REQUIRE(intensity == 1.5);
+
+		IncludeValue render = root->find("render");
+		REQUIRE(render.get_type() == ValueType::Object);
+		REQUIRE(render.get_num_children() == 2);
+		REQUIRE(render.get_child(1).find("intensity").get(intensity));
+
+		IncludeValue lights = root->find("lights");
+		REQUIRE(lights.get_num_children() == 2);
+		REQUIRE(lights.get_child(0).get_file() == root->get_include(1));
+		REQUIRE_FALSE(lights.get_child(2).is_valid());
+
+		REQUIRE_FALSE(root->find("render.include").is_valid());
+		REQUIRE_FALSE(root->find("render.height").is_valid());
+		REQUIRE_FALSE(root->find("lights.2").is_valid());
+		REQUIRE_FALSE(root->find("name.x").is_valid());
+
+		// Cached files are returned as is, by any path that loads them
+		REQUIRE(cache.load(paths[1]).get() == root->get_include(0));
+		REQUIRE(cache.load(paths[0]) == root);
+
+		cache.clear();
+		REQUIRE(cache.get_num_files() == 0);
+		REQUIRE(root->find("render.width").get(width));
+		REQUIRE(cache.load(paths[0]) != root);
+	}
+
+	for (const char* path : paths)
+		std::remove(path);
+}
+
+TEST_CASE("Include Cache Errors", "[include_cache]")
+{
+	const char* paths[] =
+	{
+		"include_cache_test_missing.sjson",
+		"include_cache_test_invalid.sjson",
+		"include_cache_test_invalid_include.sjson",
+		"include_cache_test_cycle_a.sjson",
+		"include_cache_test_cycle_b.sjson",
+		"include_cache_test_self.sjson",
+	};
+
+	write_test_file(paths[0], "a = 1\r\nb = { include = \"include_cache_test_does_not_exist.sjson\" }\r\n");
+	write_test_file(paths[1], "a = 1\r\nb = [ 1 }\r\n");
+	write_test_file(paths[2], "value = { include = \"include_cache_test_invalid.sjson\" }\r\n");
+	write_test_file(paths[3], "b = { include = \"include_cache_test_cycle_b.sjson\" }\r\n");
+	write_test_file(paths[4], "x = 1\r\na = [ { include = \"include_cache_test_cycle_a.sjson\" } ]\r\n");
+	write_test_file(paths[5], "include = \"include_cache_test_self.sjson\"\r\n");
+
+	IncludeCache cache(2);
+	IncludeError error;
+
+	REQUIRE_FALSE(cache.load("include_cache_test_does_not_exist.sjson", &error));
+	REQUIRE(error.error == ParserError::FileCouldNotBeRead);
+	REQUIRE(error.path == "include_cache_test_does_not_exist.sjson");
+
+	// A missing include is reported where it is included
+	REQUIRE_FALSE(cache.load(paths[0], &error));
+	REQUIRE(error.error == ParserError::FileCouldNotBeRead);
+	REQUIRE(error.path == paths[0]);
+	REQUIRE(error.line == 2);
+	REQUIRE(error.column == 6);
+
+	// Parsing errors are reported in the included file
+	REQUIRE_FALSE(cache.load(paths[2], &error));
+	REQUIRE(error.error == ParserError::NumberExpected);
+	REQUIRE(error.path == paths[1]);
+	REQUIRE(error.line == 2);
+
+	REQUIRE_FALSE(cache.load(paths[3], &error));
+	REQUIRE(error.error == ParserError::IncludeCycle);
+	REQUIRE(error.path == paths[4]);
+	REQUIRE(error.line == 2);
+	REQUIRE(std::strcmp(error.get_description(), "This file is included by one of the files it includes") == 0);
+
+	REQUIRE_FALSE(cache.load(paths[5], &error));
+	REQUIRE(error.error == ParserError::IncludeCycle);
+	REQUIRE(error.path == paths[5]);
+
+	// Nothing is cached when a load fails
+	REQUIRE(cache.get_num_files() == 0);
+
+	REQUIRE(cache.load(paths[1]) == nullptr);
+	REQUIRE_THROWS(IncludeCache(0));
+
+	for (const char* path : paths)
+		std::remove(path);
+}
+
+TEST_CASE("Include Path Resolution", "[include_cache]")
+{
+	REQUIRE(impl::resolve_include_path("config.sjson", StringView("render.sjson")) == "render.sjson");
+	REQUIRE(impl::resolve_include_path("data/config.sjson", StringView("render.sjson")) == "data/render.sjson");
+	REQUIRE(impl::resolve_include_path("data\\config.sjson", StringView("shared/render.sjson")) == "data/shared/render.sjson");
+	REQUIRE(impl::resolve_include_path("data/config.sjson", StringView("/shared/render.sjson")) == "/shared/render.sjson");
+	REQUIRE(impl::resolve_include_path("data/config.sjson", StringView("C:/render.sjson")) == "C:/render.sjson");
+
+	// Aliases of a path resolve to the same one
+	REQUIRE(impl::resolve_include_path("data/config.sjson", StringView("./render.sjson")) == "data/render.sjson");
+	REQUIRE(impl::resolve_include_path("data/config.sjson", StringView("../data//render.sjson")) == "data/render.sjson");
+	REQUIRE(impl::resolve_include_path("data/config.sjson", StringView("../../shared/./render.sjson")) == "../shared/render.sjson");
+	REQUIRE(impl::resolve_include_path("/data/config.sjson", StringView("../../render.sjson")) == "/render.sjson");
+	REQUIRE(impl::resolve_include_path("C:\\data\\config.sjson", StringView("..\\render.sjson")) == "C:/render.sjson");
+	REQUIRE(impl::normalize_include_path("./a/b/../../c") == "c");
+	REQUIRE(impl::normalize_include_path("a/..") == ".");
+	REQUIRE(impl::normalize_include_path("../../a") == "../../a");
+}
+
+TEST_CASE("Include Cache Aliases", "[include_cache]")
+{
+	const std::string self_path = get_temp_file_path("include_cache_test_alias_self.sjson");
+	const std::string shared_path = get_temp_file_path("include_cache_test_alias_shared.sjson");
+	const std::string root_path = get_temp_file_path("include_cache_test_alias_root.sjson");
+	REQUIRE(write_temp_file(self_path, "x = { include = \"./include_cache_test_alias_self.sjson\" }\r\n"));
+	REQUIRE(write_temp_file(shared_path, "value = 1\r\n"));
+	REQUIRE(write_temp_file(root_path,
+		"a = { include = \"include_cache_test_alias_shared.sjson\" }\r\n"
+		"b = { include = \"./include_cache_test_alias_shared.sjson\" }\r\n"));
+
+	IncludeCache cache(2);
+	IncludeError error;
+
+	// A file that includes itself through an alias is a cycle
+	REQUIRE_FALSE(cache.load(self_path.c_str(), &error));
+	REQUIRE(error.error == ParserError::IncludeCycle);
+	REQUIRE(error.line == 1);
+
+	// Aliases of a file are loaded once
+	std::shared_ptr<const IncludedFile> root = cache.load(root_path.c_str(), &error);
+	REQUIRE(root);
+	REQUIRE(cache.get_num_files() == 2);
+	REQUIRE(root->get_include(0) == root->get_include(1));
+
+	std::remove(self_path.c_str());
+	std::remove(shared_path.c_str());
+	std::remove(root_path.c_str());
+}
@@ -0,0 +1,263 @@
+////////////////////////////////////////////////////////////////////////////////
+// The MIT License (MIT)
+//
+// Copyright (c) 2018 Nicholas Frechette, Cody Jones, and sjson-cpp contributors
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <catch.hpp>
+
+#include <sjson/kernels.h>
+#include <sjson/parser.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace sjson;
+
+static const KernelSet k_kernel_sets[] = { KernelSet::Scalar, KernelSet::SSE42, KernelSet::AVX2, KernelSet::AVX512 };
+
+TEST_CASE("Kernel Selection", "[kernels]")
+{
+	const KernelSet detected_kernel_set = detect_kernel_set();
+	REQUIRE(is_kernel_set_supported(KernelSet::Scalar));
+	REQUIRE(is_kernel_set_supported(detected_kernel_set));
+	REQUIRE(get_kernel_set() == detected_kernel_set);
+
+	override_kernel_set(KernelSet::Scalar);
+	REQUIRE(get_kernel_set() == KernelSet::Scalar);
+
+	reset_kernel_set();
+	REQUIRE(get_kernel_set() == detected_kernel_set);
+
+	if (detected_kernel_set != KernelSet::AVX512)
+		REQUIRE_THROWS(override_kernel_set(KernelSet::AVX512));
+}
+
+TEST_CASE("Kernel Find Any Of", "[kernels]")
+{
+	const impl::SymbolSet symbols("\"{}[]/");
+
+	// Symbols are sparse, every input is also scanned with NUL padding
+	std::vector<char> input(300 + k_input_padding, '\0');
+	uint32_t seed = 12345;
+	for (size_t offset = 0; offset < 300; ++offset)
+	{
+		seed = seed * 1103515245u + 12345u;
+		const uint32_t random = (seed >> 16) % 64;
+		input[offset] = random < 6 ? "\"{}[]/"[random] : char('a' + (random % 26));
+	}
+
+	for (KernelSet kernel_set : k_kernel_sets)
+	{
+		if (!is_kernel_set_supported(kernel_set))
+			continue;
+
+		const impl::Kernels kernels = impl::make_kernels(kernel_set);
+		REQUIRE(kernels.kernel_set == kernel_set);
+
+		for (size_t input_length = 0; input_length <= 300; input_length += 7)
+		{
+			std::vector<char> padded_input(input.begin(), input.begin() + input_length);
+			padded_input.resize(input_length + k_input_padding, '\0');
+
+			for (size_t offset = 0; offset <= input_length + 3; ++offset)
+			{
+				const size_t expected = impl::find_any_of_scalar(input.data(), offset, input_length, input_length, symbols);
+				REQUIRE(kernels.find_any_of(input.data(), offset, input_length, input_length, symbols) == expected);
+				REQUIRE(kernels.find_any_of(padded_input.data(), offset, input_length, input_length + k_input_padding, symbols) == expected);
+			}
+		}
+	}
+}
+
+TEST_CASE("Kernel Base64", "[kernels]")
+{
+	std::vector<uint8_t> data(200);
+	uint32_t seed = 12345;
+	for (uint8_t& value : data)
+	{
+		seed = seed * 1103515245u + 12345u;
+		value = uint8_t(seed >> 16);
+	}
+
+	for (KernelSet kernel_set : k_kernel_sets)
+	{
+		if (!is_kernel_set_supported(kernel_set))
+			continue;
+
+		const impl::Kernels kernels = impl::make_kernels(kernel_set);
+
+		for (size_t size = 0; size <= data.size(); ++size)
+		{
+			std::string expected(get_base64_encoded_length(size), '\0');
+			REQUIRE(impl::encode_base64_scalar(data.data(), size, &expected[0]) == expected.size());
+
+			std::string encoded(expected.size(), '\0');
+			REQUIRE(kernels.encode_base64(data.data(), size, &encoded[0]) == expected.size());
+			REQUIRE(encoded == expected);
+
+			// Strings end with a quotation mark, it stops the decoding
+			encoded += '"';
+
+			std::vector<uint8_t> decoded(size + 64);
+			size_t num_symbols;
+			size_t decoded_size;
+			REQUIRE(kernels.decode_base64(encoded.c_str(), encoded.size(), decoded.data(), size, num_symbols, decoded_size) == impl::Base64Result::Success);
+			REQUIRE(num_symbols == expected.size());
+			REQUIRE(decoded_size == size);
+			REQUIRE(std::equal(data.begin(), data.begin() + size, decoded.begin()));
+
+			if (size != 0)
+				REQUIRE(kernels.decode_base64(encoded.c_str(), encoded.size(), decoded.data(), size - 1, num_symbols, decoded_size) == impl::Base64Result::BufferTooSmall);
+
+			// Invalid symbols are reported wherever they are
+			for (size_t offset = 0; offset < expected.size(); offset += 5)
+			{
+				std::string invalid = encoded;
+				invalid[offset] = char(0x80 | offset);
+
+				size_t expected_num_symbols;
+				size_t expected_size;
+				const impl::Base64Result expected_result = impl::decode_base64_scalar(invalid.c_str(), invalid.size(), decoded.data(), decoded.size(), expected_num_symbols, expected_size);
+
+				REQUIRE(kernels.decode_base64(invalid.c_str(), invalid.size(), decoded.data(), decoded.size(), num_symbols, decoded_size) == expected_result);
+				REQUIRE(num_symbols == expected_num_symbols);
+				REQUIRE(decoded_size == expected_size);
+			}
+		}
+	}
+}
+
+TEST_CASE("Kernel Parsing", "[kernels]")
+{
+	std::string input = "a = \"a long string with an escaped \\\" and \\u0041 that spans several vectors\"\r\n";
+	input += "b = { c = [ \"}\", \"\\\\\" ] // ]\r\n /* } */ d = { e = 1 } }\r\n";
+	input += "f = 2\r\n";
+
+	for (KernelSet kernel_set : k_kernel_sets)
+	{
+		if (!is_kernel_set_supported(kernel_set))
+			continue;
+
+		override_kernel_set(kernel_set);
+
+		Parser parser(input.c_str(), input.size());
+		StringView a;
+		REQUIRE(parser.read("a", a));
+		REQUIRE(a == "a long string with an escaped \\\" and \\u0041 that spans several vectors");
+
+		StringView key;
+		REQUIRE(parser.read_next_key(key));
+		REQUIRE(parser.skip_value());
+
+		uint32_t line;
+		uint32_t column;
+		parser.get_position(line, column);
+		REQUIRE(line == 3);
+
+		uint32_t f = 0;
+		REQUIRE(parser.read("f", f));
+		REQUIRE(f == 2);
+		REQUIRE(parser.remainder_is_comments_and_whitespace());
+
+		const char* truncated = "a = \"abc\\";
+		Parser truncated_parser(truncated, std::strlen(truncated));
+		REQUIRE_FALSE(truncated_parser.read("a", a));
+		REQUIRE(truncated_parser.get_error().error == ParserError::InputTruncated);
+	}
+
+	reset_kernel_set();
+}
+
+// Hidden by default, run it explicitly with the [benchmark] tag
+TEST_CASE("Kernel Throughput", "[.][benchmark]")
+{
+	constexpr size_t k_input_length = 1024 * 1024;
+	constexpr uint32_t k_num_iterations = 200;
+
+	// A long string without escapes, the kernels must scan all of it
+	std::vector<char> input(k_input_length + k_input_padding, 'x');
+	input[k_input_length - 1] = '"';
+
+	const impl::SymbolSet& string_symbols = impl::get_string_symbols();
+
+	for (KernelSet kernel_set : k_kernel_sets)
+	{
+		if (!is_kernel_set_supported(kernel_set))
+			continue;
+
+		const impl::Kernels kernels = impl::make_kernels(kernel_set);
+
+		size_t checksum = 0;
+		const auto start_time = std::chrono::high_resolution_clock::now();
+		for (uint32_t iteration = 0; iteration < k_num_iterations; ++iteration)
+			checksum += kernels.find_any_of(input.data(), iteration % 8, k_input_length, k_input_length, string_symbols);
+		const auto end_time = std::chrono::high_resolution_clock::now();
+
+		const double elapsed_seconds = std::chrono::duration<double>(end_time - start_time).count();
+		std::printf("%-8s %8.2f GB/sec\n", get_kernel_set_name(kernel_set), double(k_input_length) * k_num_iterations / elapsed_seconds / (1024.0 * 1024.0 * 1024.0));
+		REQUIRE(checksum == size_t(k_input_length - 1) * k_num_iterations);
+	}
+}
+
+// Hidden by default, run it explicitly with the [benchmark] tag
+TEST_CASE("Kernel Base64 Throughput", "[.][benchmark]")
+{
+	constexpr size_t k_data_size = 3 * 1024 * 1024;
+	constexpr uint32_t k_num_iterations = 20;
+
+	std::vector<uint8_t> data(k_data_size);
+	for (size_t offset = 0; offset < k_data_size; ++offset)
+		data[offset] = uint8_t(offset * 7);
+
+	std::vector<char> encoded(get_base64_encoded_length(k_data_size));
+	std::vector<uint8_t> decoded(k_data_size);
+
+	for (KernelSet kernel_set : k_kernel_sets)
+	{
+		if (!is_kernel_set_supported(kernel_set))
+			continue;
+
+		const impl::Kernels kernels = impl::make_kernels(kernel_set);
+
+		const auto encode_start_time = std::chrono::high_resolution_clock::now();
+		for (uint32_t iteration = 0; iteration < k_num_iterations; ++iteration)
+			kernels.encode_base64(data.data(), k_data_size, encoded.data());
+		const auto encode_end_time = std::chrono::high_resolution_clock::now();
+
+		size_t num_symbols = 0;
+		size_t decoded_size = 0;
+		const auto decode_start_time = std::chrono::high_resolution_clock::now();
+		for (uint32_t iteration = 0; iteration < k_num_iterations; ++iteration)
+			kernels.decode_base64(encoded.data(), encoded.size(), decoded.data(), decoded.size(), num_symbols, decoded_size);
+		const auto decode_end_time = std::chrono::high_resolution_clock::now();
+
+		const double encode_seconds = std::chrono::duration<double>(encode_end_time - encode_start_time).count();
+		const double decode_seconds = std::chrono::duration<double>(decode_end_time - decode_start_time).count();
+		const double num_gigabytes = double(k_data_size) * k_num_iterations / (1024.0 * 1024.0 * 1024.0);
+		std::printf("%-8s encode %6.2f GB/sec, decode %6.2f GB/sec\n", get_kernel_set_name(kernel_set), num_gigabytes / encode_seconds, num_gigabytes / decode_seconds);
+		REQUIRE(decoded == data);
+	}
+}
@@ -0,0 +1,215 @@
+////////////////////////////////////////////////////////////////////////////////
+// The MIT License (MIT)
+//
+// Copyright (c) 2018 Nicholas Frechette, Cody Jones, and sjson-cpp contributors
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <catch.hpp>
+
+#include "string_stream_writer.h"
+
+#include <sjson/key_index.h>
+
+#include <cstring>
+#include <string>
+
+using namespace sjson;
+
+TEST_CASE("Key Index", "[key_index]")
+{
+	const char* input =
+		"// Comments are skipped\r\n"
+		"version = 3\r\n"
+		"settings = {\r\n"
+		"\trender = { width = 1280 height = 720 }\r\n"
+		"\tname = \"low\"\r\n"
+		"\tlights = [ { intensity = 0.5 } { intensity = 1.5 } ]\r\n"
+		"}\r\n";
+	const size_t input_length = std::strlen(input);
+
+	KeyIndexSource source;
+	source.size = input_length;
+	source.modification_time = 1234;
+	source.content_hash = compute_key_index_content_hash(input, input_length);
+
+	StringStreamWriter index_file;
+	{
+		KeyIndex index;
+		Parser parser(input, input_length);
+		REQUIRE(index.build(parser, source));
+		REQUIRE(index.get_num_entries() == 7);
+		index.write(index_file);
+	}
+
+	KeyIndex index;
+	REQUIRE(index.load(index_file.str().data(), index_file.str().size()));
+	REQUIRE(index.is_valid_for(source));
+	REQUIRE(index.get_num_entries() == 7);
+
+	KeyIndexSource modified_source = source;
+	modified_source.modification_time++;
+	REQUIRE_FALSE(index.is_valid_for(modified_source));
+
+	{
+		Parser parser(input, input_length);
+		REQUIRE(index.seek(parser, "settings.render.height"));
+
+		uint32_t height;
+		REQUIRE(parser.read(height));
+		REQUIRE(height == 720);
+
+		REQUIRE(index.seek(parser, "settings.lights.1.intensity"));
+		double intensity;
+		REQUIRE(parser.read(intensity));
+		REQUIRE(intensity == 1.5);
+
+		uint32_t line;
+		uint32_t column;
+		parser.get_position(line, column);
+		REQUIRE(line == 6);
+
+		REQUIRE(index.seek(parser, "settings.name"));
+		StringView name;
+		REQUIRE(parser.read(name));
+		REQUIRE(name == "low");
+
+		REQUIRE_FALSE(index.seek(parser, "settings.missing"));
+	}
+
+	{
+		PathQueryResult result;
+		REQUIRE(index.find("settings.lights.0", input, input_length, result));
+		REQUIRE(result.type == ValueType::Object);
+		REQUIRE(result.raw_value == "{ intensity = 0.5 }");
+		REQUIRE(result.line == 6);
+		REQUIRE(result.column == 14);
+
+		REQUIRE(index.find("version", input, input_length, result));
+		uint32_t version;
+		REQUIRE(result.get(version));
+		REQUIRE(version == 3);
+
+		REQUIRE_FALSE(index.find("settings.lights.2", input, input_length, result));
+		REQUIRE_FALSE(result.is_found);
+	}
+
+	{
+		KeyIndex invalid_index;
+		REQUIRE_FALSE(invalid_index.load(index_file.str().data(), index_file.str().size() - 1));
+		REQUIRE_FALSE(invalid_index.load("SJSON", 5));
+	}
+
+	{
+		const char* json_input = "{ \"a\": { \"b\": [ 1, 2 ] }, \"c\": true }";
+		JSONParser parser(json_input, std::strlen(json_input));
+
+		KeyIndex json_index;
+		REQUIRE(json_index.build(parser, KeyIndexSource()));
+		REQUIRE(json_index.get_num_entries() == 3);
+		REQUIRE(json_index.seek(parser, "a.b.1"));
+
+		uint8_t value;
+		REQUIRE(parser.read(value));
+		REQUIRE(value == 2);
+	}
+
+	{
+		// Values within arrays are read with the dialect of the input
+		const char* json_input = "{\"a\":[{\"b\":1},{\"b\":2}]}";
+		const size_t json_input_length = std::strlen(json_input);
+		JSONParser parser(json_input, json_input_length);
+
+		KeyIndex json_index;
+		REQUIRE(json_index.build(parser, KeyIndexSource()));
+
+		PathQueryResult result;
+		REQUIRE(json_index.find<JSONDialect>("a.1.b", json_input, json_input_length, result));
+		REQUIRE(result.raw_value == "2");
+		REQUIRE(result.type == ValueType::Number);
+	}
+
+	{
+		// The first value of a duplicate key is found
+		const char* duplicate_input = "a = 1 b = { c = 2 } a = 3";
+		Parser parser(duplicate_input, std::strlen(duplicate_input));
+
+		KeyIndex duplicate_index;
+		REQUIRE(duplicate_index.build(parser, KeyIndexSource()));
+
+		PathQueryResult result;
+		REQUIRE(duplicate_index.find("a", duplicate_input, std::strlen(duplicate_input), result));
+		REQUIRE(result.raw_value == "1");
+
+		// A path whose hash matches but whose text differs is not found, the path data ends with "ab.cba"
+		StringStreamWriter duplicate_file;
+		duplicate_index.write(duplicate_file);
+
+		std::string altered_file = duplicate_file.str();
+		altered_file[altered_file.size() - 1] = 'z';
+		altered_file[altered_file.size() - 6] = 'z';
+
+		KeyIndex altered_index;
+		REQUIRE(altered_index.load(altered_file.data(), altered_file.size()));
+		REQUIRE_FALSE(altered_index.find("a", duplicate_input, std::strlen(duplicate_input), result));
+		REQUIRE(altered_index.find("b.c", duplicate_input, std::strlen(duplicate_input), result));
+		REQUIRE(result.raw_value == "2");
+	}
+
+	{
+		// Array elements aren't indexed, the index remains much smaller than an array heavy input
+		std::string array_input = "name = \"samples\" values = [";
+		for (uint32_t value_index = 0; value_index < 100000; ++value_index)
+			array_input += " " + std::to_string(value_index % 1000);
+		array_input += " ] points = [ { x = 1 y = 2 } { x = 3 y = [ 4 5 ] } ]";
+
+		Parser parser(array_input.c_str(), array_input.size());
+		KeyIndex array_index;
+		REQUIRE(array_index.build(parser, KeyIndexSource()));
+		REQUIRE(array_index.get_num_entries() == 3);
+
+		StringStreamWriter array_file;
+		array_index.write(array_file);
+		REQUIRE(array_file.str().size() * 100 < array_input.size());
+
+		REQUIRE(array_index.seek(parser, "values.12345"));
+		uint32_t value;
+		REQUIRE(parser.read(value));
+		REQUIRE(value == 345);
+
+		REQUIRE(array_index.seek(parser, "points.1.y.1"));
+		REQUIRE(parser.read(value));
+		REQUIRE(value == 5);
+
+		REQUIRE_FALSE(array_index.seek(parser, "values.100000"));
+		REQUIRE_FALSE(array_index.seek(parser, "values.x"));
+		REQUIRE_FALSE(array_index.seek(parser, "points.0.z"));
+		REQUIRE_FALSE(array_index.seek(parser, "name.0"));
+	}
+
+	{
+		const char* invalid_input = "a = { b = }";
+		Parser parser(invalid_input, std::strlen(invalid_input));
+
+		KeyIndex invalid_index;
+		REQUIRE_FALSE(invalid_index.build(parser, KeyIndexSource()));
+		REQUIRE(invalid_index.get_num_entries() == 0);
+	}
+}
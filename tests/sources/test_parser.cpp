@@ -26,11 +26,20 @@
 
 #include <sjson/parser.h>
 
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+
 using namespace sjson;
 
-static Parser parser_from_c_str(const char* c_str)
+template<class DialectType = SJSONDialect>
+static BasicParser<DialectType> parser_from_c_str(const char* c_str)
 {
-	return Parser(c_str, std::strlen(c_str));
+	return BasicParser<DialectType>(c_str, std::strlen(c_str));
 }
 
 TEST_CASE("Parser Misc", "[parser]")
@@ -113,6 +122,18 @@ TEST_CASE("Parser Misc", "[parser]")
 		REQUIRE(parser.eof());
 		REQUIRE(parser.is_valid());
 	}
+
+	{
+		Parser parser = parser_from_c_str("key = true");
+		bool value = false;
+		REQUIRE(parser.read("key", value));
+		parser.report_error(ParserError::ValueOutOfRange, 1, 7);
+		REQUIRE_FALSE(parser.is_valid());
+		REQUIRE(parser.get_error().error == ParserError::ValueOutOfRange);
+		REQUIRE(parser.get_error().line == 1);
+		REQUIRE(parser.get_error().column == 7);
+		REQUIRE(parser.eof());
+	}
 }
 
 TEST_CASE("Parser Bool Reading", "[parser]")
@@ -459,3 +480,951 @@ TEST_CASE("Parser Null Reading", "[parser]")
 		REQUIRE(parser.is_valid());
 	}
 }
+
+struct NoCommentsDialect : public SJSONDialect
+{
+	static constexpr bool k_allow_comments = false;
+};
+
+struct ColonDialect : public SJSONDialect
+{
+	static constexpr char k_key_value_separator = ':';
+};
+
+TEST_CASE("Parser Dialects", "[parser]")
+{
+	{
+		BasicParser<MinimalSJSONDialect> parser = parser_from_c_str<MinimalSJSONDialect>("key = 123\r\nvalues = [ 1.5, 2.5 ]");
+		int32_t value = 0;
+		REQUIRE(parser.read("key", value));
+		REQUIRE(value == 123);
+		double values[2] = { 0.0, 0.0 };
+		REQUIRE(parser.read("values", values, 2));
+		REQUIRE(values[0] == 1.5);
+		REQUIRE(values[1] == 2.5);
+		REQUIRE(parser.remainder_is_comments_and_whitespace());
+		REQUIRE(parser.is_valid());
+	}
+
+	{
+		BasicParser<MinimalSJSONDialect> parser = parser_from_c_str<MinimalSJSONDialect>("\"key\" = 123");
+		int32_t value = 0;
+		REQUIRE_FALSE(parser.read("key", value));
+		REQUIRE(parser.get_error().error == ParserError::CannotUseQuotationMarkInUnquotedString);
+	}
+
+	{
+		BasicParser<MinimalSJSONDialect> parser = parser_from_c_str<MinimalSJSONDialect>("key = 0x10");
+		int32_t value = 0;
+		REQUIRE_FALSE(parser.read("key", value));
+		REQUIRE(parser.get_error().error == ParserError::InvalidNumber);
+	}
+
+	{
+		BasicParser<MinimalSJSONDialect> parser = parser_from_c_str<MinimalSJSONDialect>("key = 017");
+		int32_t value = 0;
+		REQUIRE_FALSE(parser.read("key", value));
+		REQUIRE(parser.get_error().error == ParserError::InvalidNumber);
+	}
+
+	{
+		BasicParser<MinimalSJSONDialect> parser = parser_from_c_str<MinimalSJSONDialect>("key = 0");
+		int32_t value = 1;
+		REQUIRE(parser.read("key", value));
+		REQUIRE(value == 0);
+	}
+
+	{
+		BasicParser<NoCommentsDialect> parser = parser_from_c_str<NoCommentsDialect>("key = /* bar */ true");
+		bool value = false;
+		REQUIRE_FALSE(parser.read("key", value));
+		REQUIRE(parser.get_error().error == ParserError::TrueOrFalseExpected);
+	}
+
+	{
+		BasicParser<NoCommentsDialect> parser = parser_from_c_str<NoCommentsDialect>("key = true // bar");
+		bool value = false;
+		REQUIRE(parser.read("key", value));
+		REQUIRE(value == true);
+		REQUIRE_FALSE(parser.remainder_is_comments_and_whitespace());
+		REQUIRE(parser.get_error().error == ParserError::UnexpectedContentAtEnd);
+	}
+
+	{
+		BasicParser<ColonDialect> parser = parser_from_c_str<ColonDialect>("key: 12.5\r\n\"other\" : false");
+		double value = 0.0;
+		REQUIRE(parser.read("key", value));
+		REQUIRE(value == 12.5);
+		bool value_bool = true;
+		REQUIRE(parser.read("other", value_bool));
+		REQUIRE(value_bool == false);
+		REQUIRE(parser.eof());
+		REQUIRE(parser.is_valid());
+	}
+
+	{
+		BasicParser<ColonDialect> parser = parser_from_c_str<ColonDialect>("key = 12.5");
+		double value = 0.0;
+		REQUIRE_FALSE(parser.read("key", value));
+		REQUIRE(parser.get_error().error == ParserError::KeyValueSeparatorExpected);
+	}
+}
+
+TEST_CASE("Parser JSON Reading", "[parser]")
+{
+	{
+		JSONParser parser = parser_from_c_str<JSONDialect>("{ \"key\": 123, \"values\": [ 1.5, 2.5 ], \"nested\": { \"str\": \"foo\", \"flag\": true }, \"last\": null }");
+		int32_t value = 0;
+		REQUIRE(parser.read("key", value));
+		REQUIRE(value == 123);
+		double values[2] = { 0.0, 0.0 };
+		REQUIRE(parser.read("values", values, 2));
+		REQUIRE(values[0] == 1.5);
+		REQUIRE(values[1] == 2.5);
+		REQUIRE(parser.object_begins("nested"));
+		StringView str;
+		REQUIRE(parser.read("str", str));
+		REQUIRE(str == "foo");
+		bool flag = false;
+		REQUIRE(parser.read("flag", flag));
+		REQUIRE(flag == true);
+		REQUIRE(parser.object_ends());
+		double last = 0.0;
+		REQUIRE_FALSE(parser.try_read("last", last, 1.0));
+		REQUIRE(last == 1.0);
+		REQUIRE(parser.remainder_is_comments_and_whitespace());
+		REQUIRE(parser.is_valid());
+	}
+
+	{
+		JSONParser parser = parser_from_c_str<JSONDialect>("{\"items\":[{\"a\":1},{\"a\":2}]}");
+		REQUIRE(parser.array_begins("items"));
+		for (int32_t i = 1; i <= 2; ++i)
+		{
+			REQUIRE(parser.object_begins());
+			int32_t value = 0;
+			REQUIRE(parser.read("a", value));
+			REQUIRE(value == i);
+			REQUIRE(parser.object_ends());
+		}
+		REQUIRE(parser.array_ends());
+		REQUIRE(parser.remainder_is_comments_and_whitespace());
+		REQUIRE(parser.is_valid());
+	}
+
+	{
+		JSONParser parser = parser_from_c_str<JSONDialect>("{ \"key0\": 1 \"key1\": 2 }");
+		int32_t value = 0;
+		REQUIRE(parser.read("key0", value));
+		REQUIRE_FALSE(parser.read("key1", value));
+		REQUIRE(parser.get_error().error == ParserError::CommaExpected);
+	}
+
+	{
+		JSONParser parser = parser_from_c_str<JSONDialect>("{ \"key0\": 1, \"key1\": 2 }");
+		int32_t value = 0;
+		REQUIRE(parser.read("key0", value));
+		double missing = 0.0;
+		REQUIRE_FALSE(parser.try_read("missing", missing, 1.0));
+		REQUIRE(parser.read("key1", value));
+		REQUIRE(value == 2);
+		REQUIRE(parser.remainder_is_comments_and_whitespace());
+	}
+
+	{
+		JSONParser parser = parser_from_c_str<JSONDialect>("{ key: 1 }");
+		int32_t value = 0;
+		REQUIRE_FALSE(parser.read("key", value));
+		REQUIRE(parser.get_error().error == ParserError::QuotationMarkExpected);
+	}
+
+	{
+		JSONParser parser = parser_from_c_str<JSONDialect>("\"key\": 1");
+		REQUIRE_FALSE(parser.is_valid());
+		REQUIRE(parser.get_error().error == ParserError::OpeningBraceExpected);
+	}
+
+	{
+		JSONParser parser = parser_from_c_str<JSONDialect>("{ \"key\": 1 } extra");
+		int32_t value = 0;
+		REQUIRE(parser.read("key", value));
+		REQUIRE_FALSE(parser.remainder_is_comments_and_whitespace());
+		REQUIRE(parser.get_error().error == ParserError::UnexpectedContentAtEnd);
+	}
+}
+
+TEST_CASE("Parser Columns Reading", "[parser]")
+{
+	{
+		Parser parser = parser_from_c_str("points = {\r\n\tx = [ 1, 2 ]\r\n\ty = [ 3.5, 4.5 ]\r\n}\r\n");
+		double xs[2] = { 0.0, 0.0 };
+		double ys[2] = { 0.0, 0.0 };
+		const char* column_names[] = { "x", "y" };
+		double* columns[] = { xs, ys };
+		REQUIRE(parser.read_columns("points", column_names, columns, 2, 2));
+		REQUIRE(xs[0] == 1.0);
+		REQUIRE(xs[1] == 2.0);
+		REQUIRE(ys[0] == 3.5);
+		REQUIRE(ys[1] == 4.5);
+		REQUIRE(parser.remainder_is_comments_and_whitespace());
+		REQUIRE(parser.is_valid());
+	}
+
+	{
+		Parser parser = parser_from_c_str("points = { x = [ 1.5, 2.5 ] y = [ 3.5 ] }");
+		float xs[2] = { 0.0f, 0.0f };
+		float ys[2] = { 0.0f, 0.0f };
+		const char* column_names[] = { "x", "y" };
+		float* columns[] = { xs, ys };
+		REQUIRE_FALSE(parser.read_columns("points", column_names, columns, 2, 2));
+		REQUIRE(xs[0] == 1.5f);
+		REQUIRE(xs[1] == 2.5f);
+		REQUIRE(parser.get_error().error == ParserError::CommaExpected);
+	}
+}
+
+TEST_CASE("Parser Generic Traversal", "[parser]")
+{
+	{
+		Parser parser = parser_from_c_str("a = 1.5 b = \"str\" c = [ 1, [ 2 ], { d = \"]\" } ] e = { f = null /* } */ } g = true h = null");
+		StringView key;
+		StringView raw_value;
+
+		REQUIRE(parser.read_next_key(key));
+		REQUIRE(key == "a");
+		REQUIRE(parser.peek_value_type() == ValueType::Number);
+		double value_dbl = 0.0;
+		REQUIRE(parser.read(value_dbl));
+		REQUIRE(value_dbl == 1.5);
+
+		REQUIRE(parser.read_next_key(key));
+		REQUIRE(key == "b");
+		REQUIRE(parser.peek_value_type() == ValueType::String);
+		REQUIRE(parser.read_raw_value(raw_value));
+		REQUIRE(raw_value == "\"str\"");
+
+		REQUIRE(parser.read_next_key(key));
+		REQUIRE(key == "c");
+		REQUIRE(parser.peek_value_type() == ValueType::Array);
+		REQUIRE(parser.read_raw_value(raw_value));
+		REQUIRE(raw_value == "[ 1, [ 2 ], { d = \"]\" } ]");
+
+		REQUIRE(parser.read_next_key(key));
+		REQUIRE(key == "e");
+		REQUIRE(parser.peek_value_type() == ValueType::Object);
+		REQUIRE(parser.skip_value());
+
+		REQUIRE(parser.read_next_key(key));
+		REQUIRE(key == "g");
+		REQUIRE(parser.peek_value_type() == ValueType::Bool);
+		bool value_bool = false;
+		REQUIRE(parser.read(value_bool));
+		REQUIRE(value_bool);
+
+		REQUIRE(parser.read_next_key(key));
+		REQUIRE(key == "h");
+		REQUIRE(parser.peek_value_type() == ValueType::Null);
+		REQUIRE(parser.skip_value());
+
+		REQUIRE(parser.eof());
+		REQUIRE(parser.is_valid());
+	}
+
+	{
+		// Skipping in bulk keeps track of the position
+		Parser parser = parser_from_c_str("a = {\n\tb = [\n\t\t1\n\t]\n} c = 2");
+		StringView key;
+		REQUIRE(parser.read_next_key(key));
+		REQUIRE(parser.skip_value());
+
+		Parser reference = parser_from_c_str("a = {\n\tb = [\n\t\t1\n\t]\n} c = 2");
+		REQUIRE(reference.object_begins("a"));
+		REQUIRE(reference.array_begins("b"));
+		double value = 0.0;
+		REQUIRE(reference.read(&value, 1));
+		REQUIRE(reference.array_ends());
+		REQUIRE(reference.object_ends());
+
+		uint32_t line = 0;
+		uint32_t column = 0;
+		uint32_t reference_line = 0;
+		uint32_t reference_column = 0;
+		parser.get_position(line, column);
+		reference.get_position(reference_line, reference_column);
+		REQUIRE(line == reference_line);
+		REQUIRE(column == reference_column);
+		REQUIRE(parser.save_state().offset == reference.save_state().offset);
+	}
+
+	{
+		Parser parser = parser_from_c_str("a = { b = [ 1 }");
+		StringView key;
+		REQUIRE(parser.read_next_key(key));
+		REQUIRE_FALSE(parser.skip_value());
+		REQUIRE(parser.get_error().error == ParserError::InputTruncated);
+	}
+
+	{
+		Parser parser = parser_from_c_str("a = ?");
+		StringView key;
+		REQUIRE(parser.read_next_key(key));
+		REQUIRE(parser.peek_value_type() == ValueType::Unknown);
+		REQUIRE_FALSE(parser.skip_value());
+		REQUIRE(parser.get_error().error == ParserError::ValueExpected);
+	}
+
+	{
+		JSONParser parser = parser_from_c_str<JSONDialect>("{ \"a\": [ 1, 2 ], \"b\": { \"c\": 3 } }");
+		StringView key;
+		REQUIRE(parser.read_next_key(key));
+		REQUIRE(key == "a");
+		REQUIRE(parser.array_begins());
+		int32_t value = 0;
+		REQUIRE(parser.read(value));
+		REQUIRE(value == 1);
+		REQUIRE(parser.read_array_separator());
+		REQUIRE(parser.read(value));
+		REQUIRE(value == 2);
+		REQUIRE(parser.array_ends());
+		REQUIRE(parser.read_next_key(key));
+		REQUIRE(key == "b");
+		REQUIRE_FALSE(parser.is_root_object_end());
+		REQUIRE(parser.skip_value());
+		REQUIRE(parser.skip_comments_and_whitespace());
+		REQUIRE(parser.is_root_object_end());
+		REQUIRE(parser.remainder_is_comments_and_whitespace());
+		REQUIRE(parser.is_valid());
+	}
+
+	{
+		Parser parser = parser_from_c_str("a = 1 // Done\r\n");
+		StringView key;
+		REQUIRE(parser.read_next_key(key));
+		REQUIRE_FALSE(parser.is_root_object_end());
+		REQUIRE(parser.skip_value());
+		REQUIRE(parser.skip_comments_and_whitespace());
+		REQUIRE(parser.is_root_object_end());
+		REQUIRE(parser.remainder_is_comments_and_whitespace());
+	}
+}
+
+TEST_CASE("Parser Padded Input", "[parser]")
+{
+	using PaddedParser = BasicParser<PaddedInputDialect<SJSONDialect>>;
+
+	auto make_buffer = [](const char* input)
+	{
+		const size_t input_length = std::strlen(input);
+		std::vector<char> buffer(get_padded_input_size(input_length), 'x');
+		REQUIRE(make_padded_input(input, input_length, buffer.data(), buffer.size()));
+		return buffer;
+	};
+
+	{
+		char too_small[8];
+		REQUIRE_FALSE(make_padded_input("a = 1", 5, too_small, sizeof(too_small)));
+	}
+
+	{
+		const char* input = "// comment\r\na = \"str\\u0041\" b = [ 1, 2 ] /* comment */ c = { d = \"}\" } e = 0x10 f = 1.5";
+		std::vector<char> buffer = make_buffer(input);
+		PaddedParser parser(buffer.data(), std::strlen(input));
+
+		StringView a;
+		REQUIRE(parser.read("a", a));
+		REQUIRE(a == "str\\u0041");
+
+		double b[2];
+		REQUIRE(parser.read("b", b, 2));
+		REQUIRE(b[1] == 2.0);
+
+		StringView key;
+		REQUIRE(parser.read_next_key(key));
+		REQUIRE(parser.skip_value());
+
+		uint32_t e = 0;
+		REQUIRE(parser.read("e", e));
+		REQUIRE(e == 16);
+
+		double f = 0.0;
+		REQUIRE(parser.read("f", f));
+		REQUIRE(f == 1.5);
+
+		REQUIRE(parser.remainder_is_comments_and_whitespace());
+		REQUIRE(parser.is_valid());
+	}
+
+	{
+		// Truncated inputs are detected at the padding
+		const char* inputs[] = { "a = \"str", "a = \"str\\", "a = \"\\u00", "a = { b = \"}", "a = [ 1 /* ]", "ab", "a = 1 /* comment" };
+		for (const char* input : inputs)
+		{
+			std::vector<char> buffer = make_buffer(input);
+			PaddedParser parser(buffer.data(), std::strlen(input));
+
+			StringView key;
+			StringView value;
+			const bool is_read = parser.read_next_key(key) && parser.read_raw_value(value) && parser.remainder_is_comments_and_whitespace();
+			REQUIRE_FALSE(is_read);
+			REQUIRE(parser.get_error().error == ParserError::InputTruncated);
+		}
+	}
+
+	{
+		// Errors are reported at the same position as with the checked input
+		const char* inputs[] = { "a = ", "a = \"str", "a = 1 /* comment", "a = [ 1,\r\n", "a = 1e", "ab", "a = 1 b" };
+		for (const char* input : inputs)
+		{
+			std::vector<char> buffer = make_buffer(input);
+			PaddedParser padded_parser(buffer.data(), std::strlen(input));
+			Parser parser(input, std::strlen(input));
+
+			StringView key;
+			double number;
+			const bool is_padded_read = padded_parser.read_next_key(key) && padded_parser.read(number) && padded_parser.remainder_is_comments_and_whitespace();
+			const bool is_read = parser.read_next_key(key) && parser.read(number) && parser.remainder_is_comments_and_whitespace();
+			REQUIRE_FALSE(is_padded_read);
+			REQUIRE_FALSE(is_read);
+			REQUIRE(padded_parser.get_error().error == parser.get_error().error);
+			REQUIRE(padded_parser.get_error().line == parser.get_error().line);
+			REQUIRE(padded_parser.get_error().column == parser.get_error().column);
+		}
+	}
+
+	{
+		const char* input = "{ \"a\": [ 1, 2 ], \"b\": \"c\" }";
+		std::vector<char> buffer = make_buffer(input);
+		BasicParser<PaddedInputDialect<JSONDialect>> parser(buffer.data(), std::strlen(input));
+
+		StringView b;
+		double a[2];
+		REQUIRE(parser.read("a", a, 2));
+		REQUIRE(parser.read("b", b));
+		REQUIRE(b == "c");
+		REQUIRE(parser.remainder_is_comments_and_whitespace());
+	}
+}
+
+template<class DialectType>
+static bool parse_benchmark_input(const char* input, size_t input_length, uint32_t num_entries)
+{
+	BasicParser<DialectType> parser(input, input_length);
+	for (uint32_t entry_index = 0; entry_index < num_entries; ++entry_index)
+	{
+		StringView name;
+		double values[4];
+		if (!parser.object_begins("entry") || !parser.read("name", name) || !parser.read("values", values, 4) || !parser.object_ends())
+			return false;
+	}
+
+	return parser.remainder_is_comments_and_whitespace();
+}
+
+// Hidden by default, run it explicitly with the [benchmark] tag
+TEST_CASE("Parser Padded Input Throughput", "[.][benchmark]")
+{
+	constexpr uint32_t k_num_entries = 20000;
+	constexpr uint32_t k_num_iterations = 20;
+
+	std::string input;
+	char entry[256];
+	for (uint32_t entry_index = 0; entry_index < k_num_entries; ++entry_index)
+	{
+		snprintf(entry, sizeof(entry), "// Entry %u\r\nentry = {\r\n\tname = \"entry with a fairly long name %u\"\r\n\tvalues = [ %u.25, 1.5, -3.75, 1e-3 ]\r\n}\r\n", entry_index, entry_index, entry_index);
+		input += entry;
+	}
+
+	std::vector<char> padded_input(get_padded_input_size(input.size()));
+	REQUIRE(make_padded_input(input.c_str(), input.size(), padded_input.data(), padded_input.size()));
+
+	auto measure = [&](const char* label, bool (*parse)(const char*, size_t, uint32_t), const char* buffer)
+	{
+		const auto start_time = std::chrono::high_resolution_clock::now();
+		for (uint32_t iteration = 0; iteration < k_num_iterations; ++iteration)
+			REQUIRE(parse(buffer, input.size(), k_num_entries));
+		const auto end_time = std::chrono::high_resolution_clock::now();
+
+		const double elapsed_seconds = std::chrono::duration<double>(end_time - start_time).count();
+		std::printf("%-8s %8.2f MB/sec\n", label, double(input.size()) * k_num_iterations / elapsed_seconds / (1024.0 * 1024.0));
+	};
+
+	measure("checked", parse_benchmark_input<SJSONDialect>, input.c_str());
+	measure("padded", parse_benchmark_input<PaddedInputDialect<SJSONDialect>>, padded_input.data());
+}
+
+// Hidden by default, run it explicitly with the [benchmark] tag
+TEST_CASE("Parser Dialect Throughput", "[.][benchmark]")
+{
+	constexpr uint32_t k_num_entries = 20000;
+	constexpr uint32_t k_num_iterations = 20;
+
+	// The same entries as SJSON without comments, which every SJSON dialect reads, and as JSON
+	std::string sjson_input;
+	std::string json_input = "{\n";
+	char entry[256];
+	for (uint32_t entry_index = 0; entry_index < k_num_entries; ++entry_index)
+	{
+		snprintf(entry, sizeof(entry), "entry = {\n\tname = \"entry with a fairly long name %u\"\n\tvalues = [ %u.25, 1.5, -3.75, 1e-3 ]\n}\n", entry_index, entry_index);
+		sjson_input += entry;
+
+		snprintf(entry, sizeof(entry), "\t\"entry\": {\n\t\t\"name\": \"entry with a fairly long name %u\",\n\t\t\"values\": [ %u.25, 1.5, -3.75, 1e-3 ]\n\t}%s\n", entry_index, entry_index, entry_index + 1 < k_num_entries ? "," : "");
+		json_input += entry;
+	}
+	json_input += "}\n";
+
+	auto measure = [&](const char* label, bool (*parse)(const char*, size_t, uint32_t), const std::string& input)
+	{
+		const auto start_time = std::chrono::high_resolution_clock::now();
+		for (uint32_t iteration = 0; iteration < k_num_iterations; ++iteration)
+			REQUIRE(parse(input.c_str(), input.size(), k_num_entries));
+		const auto end_time = std::chrono::high_resolution_clock::now();
+
+		const double elapsed_seconds = std::chrono::duration<double>(end_time - start_time).count();
+		std::printf("%-14s %8.2f MB/sec %8.2f M entries/sec\n", label, double(input.size()) * k_num_iterations / elapsed_seconds / (1024.0 * 1024.0), double(k_num_entries) * k_num_iterations / elapsed_seconds / 1000000.0);
+	};
+
+	measure("SJSON", parse_benchmark_input<SJSONDialect>, sjson_input);
+	measure("Minimal SJSON", parse_benchmark_input<MinimalSJSONDialect>, sjson_input);
+	measure("JSON", parse_benchmark_input<JSONDialect>, json_input);
+}
+
+TEST_CASE("Parser Fixed Size Reading", "[parser]")
+{
+	{
+		Parser parser = parser_from_c_str(
+			"position = [ 1.5, -2.0, 3.25 ]\r\n"
+			"rotation = [ 0.0, 0.0, 0.0, 1.0 ]\r\n"
+			"indices = [ 1, 2, 3 ]\r\n"
+			"flags = [ true, false ]\r\n"
+			"transform = [ [ 1.0, 0.0 ], [ 0.0, 2.0 ], [ 3.0, 4.0 ] ]\r\n"
+			"positions = [ [ 1.0, 2.0, 3.0 ] [ 4.0, 5.0, 6.0 ] ]\r\n"
+			"names = [ \"a\", \"b\" ]\r\n");
+
+		float position[3];
+		REQUIRE(parser.read("position", position));
+		REQUIRE(position[0] == 1.5F);
+		REQUIRE(position[1] == -2.0F);
+		REQUIRE(position[2] == 3.25F);
+
+		double rotation[4];
+		REQUIRE(parser.read("rotation", rotation));
+		REQUIRE(rotation[3] == 1.0);
+
+		uint16_t indices[3];
+		REQUIRE(parser.read("indices", indices));
+		REQUIRE(indices[2] == 3);
+
+		bool flags[2];
+		REQUIRE(parser.read("flags", flags));
+		REQUIRE(flags[0]);
+		REQUIRE_FALSE(flags[1]);
+
+		float transform[3][2];
+		REQUIRE(parser.read("transform", transform));
+		REQUIRE(transform[1][1] == 2.0F);
+		REQUIRE(transform[2][0] == 3.0F);
+
+		// Padded to 4 elements per position for aligned vector loads
+		alignas(16) float positions[8] = { -1.0F, -1.0F, -1.0F, -1.0F, -1.0F, -1.0F, -1.0F, -1.0F };
+		const bool is_read = parser.read_tuples<3, 4>("positions", positions, 2);
+		REQUIRE(is_read);
+		REQUIRE(positions[0] == 1.0F);
+		REQUIRE(positions[2] == 3.0F);
+		REQUIRE(positions[3] == -1.0F);
+		REQUIRE(positions[4] == 4.0F);
+		REQUIRE(positions[6] == 6.0F);
+		REQUIRE(positions[7] == -1.0F);
+
+		StringView names[2];
+		REQUIRE(parser.read("names", names));
+		REQUIRE(names[1] == "b");
+
+		REQUIRE(parser.remainder_is_comments_and_whitespace());
+	}
+
+	{
+		Parser parser = parser_from_c_str("position = [ 1.0, 2.0 ]");
+		float position[3];
+		REQUIRE_FALSE(parser.read("position", position));
+		REQUIRE(parser.get_error().error == ParserError::CommaExpected);
+	}
+
+	{
+		Parser parser = parser_from_c_str("position = [ 1.0, 2.0, 3.0, 4.0 ]");
+		float position[3];
+		REQUIRE_FALSE(parser.read("position", position));
+		REQUIRE(parser.get_error().error == ParserError::ClosingBracketExpected);
+	}
+
+	{
+		JSONParser parser = parser_from_c_str<JSONDialect>("{ \"transform\": [ [ 1, 2 ], [ 3, 4 ] ], \"scale\": [ 2, 2 ] }");
+		double transform[2][2];
+		float scale[2];
+		REQUIRE(parser.read("transform", transform));
+		REQUIRE(parser.read("scale", scale));
+		REQUIRE(transform[1][0] == 3.0);
+		REQUIRE(scale[1] == 2.0F);
+		REQUIRE(parser.remainder_is_comments_and_whitespace());
+	}
+
+	{
+		JSONParser parser = parser_from_c_str<JSONDialect>("{ \"transform\": [ [ 1, 2 ] [ 3, 4 ] ] }");
+		double transform[2][2];
+		REQUIRE_FALSE(parser.read("transform", transform));
+		REQUIRE(parser.get_error().error == ParserError::CommaExpected);
+	}
+}
+
+TEST_CASE("Parser Nested Array Reading", "[parser]")
+{
+	{
+		Parser parser = parser_from_c_str("weights = [ [ 1.0, 2.0, 3.0 ] [ 4.0, 5.0, 6.0 ] ] bias = 1.5");
+		double weights[6];
+		REQUIRE(parser.read("weights", weights, ArrayShape(2, 3)));
+		REQUIRE(weights[0] == 1.0);
+		REQUIRE(weights[3] == 4.0);
+		REQUIRE(weights[5] == 6.0);
+
+		double bias;
+		REQUIRE(parser.read("bias", bias));
+		REQUIRE(bias == 1.5);
+		REQUIRE(parser.remainder_is_comments_and_whitespace());
+	}
+
+	{
+		Parser parser = parser_from_c_str("volume = [ [ [ 1, 2 ], [ 3, 4 ] ], [ [ 5, 6 ], [ 7, 8 ] ], [ [ 9, 10 ], [ 11, 12 ] ] ]");
+		ArrayShape shape;
+		REQUIRE(parser.read_array_shape("volume", shape));
+		REQUIRE(shape.num_dimensions == 3);
+		REQUIRE(shape.extents[0] == 3);
+		REQUIRE(shape.extents[1] == 2);
+		REQUIRE(shape.extents[2] == 2);
+		REQUIRE(shape.get_num_elements() == 12);
+
+		float volume[12];
+		REQUIRE(parser.read("volume", volume, shape));
+		REQUIRE(volume[0] == 1.0F);
+		REQUIRE(volume[6] == 7.0F);
+		REQUIRE(volume[11] == 12.0F);
+		REQUIRE(parser.remainder_is_comments_and_whitespace());
+	}
+
+	{
+		Parser parser = parser_from_c_str("weights = [ // first row\n[ 1, 2 ] /* second row */ [ 3, 4 ] [ 5, 6 ] ]");
+		double weights[8];
+		ArrayShape shape;
+		REQUIRE(parser.read("weights", weights, 8, shape));
+		REQUIRE(shape.num_dimensions == 2);
+		REQUIRE(shape.extents[0] == 3);
+		REQUIRE(shape.extents[1] == 2);
+		REQUIRE(weights[4] == 5.0);
+		REQUIRE(parser.remainder_is_comments_and_whitespace());
+	}
+
+	{
+		Parser parser = parser_from_c_str("weights = [ [ 1, 2 ] [ 3, 4 ] [ 5, 6 ] ]");
+		double weights[4];
+		ArrayShape shape;
+		REQUIRE_FALSE(parser.read("weights", weights, 4, shape));
+		REQUIRE(parser.get_error().error == ParserError::LengthOutOfRange);
+	}
+
+	{
+		Parser parser = parser_from_c_str("weights = [ [ 1, 2, 3 ] [ 4, 5 ] ]");
+		double weights[6];
+		REQUIRE_FALSE(parser.read("weights", weights, ArrayShape(2, 3)));
+		REQUIRE(parser.get_error().error == ParserError::CommaExpected);
+	}
+
+	{
+		Parser parser = parser_from_c_str("weights = [ [ 1, 2 ] [ 3, 4, 5 ] ]");
+		double weights[4];
+		ArrayShape shape;
+		REQUIRE_FALSE(parser.read("weights", weights, 4, shape));
+		REQUIRE(parser.get_error().error == ParserError::ClosingBracketExpected);
+	}
+
+	{
+		Parser parser = parser_from_c_str("weights = [ [ [ [ [ [ [ [ [ 1 ] ] ] ] ] ] ] ] ]");
+		ArrayShape shape;
+		REQUIRE_FALSE(parser.read_array_shape("weights", shape));
+		REQUIRE(parser.get_error().error == ParserError::TooManyDimensions);
+	}
+
+	{
+		Parser parser = parser_from_c_str("weights = [ [ \"a\" ] ]");
+		ArrayShape shape;
+		REQUIRE_FALSE(parser.read_array_shape("weights", shape));
+		REQUIRE(parser.get_error().error == ParserError::NumberExpected);
+	}
+
+	{
+		Parser parser = parser_from_c_str("weights = [ /*/ 7, 8 */ 1, 2 ]");
+		ArrayShape shape;
+		REQUIRE(parser.read_array_shape("weights", shape));
+		REQUIRE(shape.num_dimensions == 1);
+		REQUIRE(shape.extents[0] == 2);
+
+		double weights[2];
+		REQUIRE(parser.read("weights", weights, shape));
+		REQUIRE(weights[0] == 1.0);
+		REQUIRE(weights[1] == 2.0);
+	}
+
+	{
+		Parser parser = parser_from_c_str("weights = [ [ 1, \"a\" ] ]");
+		uint32_t start_line;
+		uint32_t start_column;
+		parser.get_position(start_line, start_column);
+
+		ArrayShape shape;
+		REQUIRE_FALSE(parser.read_array_shape("weights", shape));
+		REQUIRE(parser.get_error().error == ParserError::NumberExpected);
+		REQUIRE(parser.get_error().line == 1);
+		REQUIRE(parser.get_error().column == 18);
+
+		uint32_t line;
+		uint32_t column;
+		parser.get_position(line, column);
+		REQUIRE(line == start_line);
+		REQUIRE(column == start_column);
+	}
+
+	{
+		JSONParser parser = parser_from_c_str<JSONDialect>("{ \"weights\": [ [ 1, 2 ], [ 3, 4 ] ], \"bias\": 2 }");
+		double weights[4];
+		ArrayShape shape;
+		REQUIRE(parser.read("weights", weights, 4, shape));
+		REQUIRE(weights[3] == 4.0);
+
+		double bias;
+		REQUIRE(parser.read("bias", bias));
+		REQUIRE(parser.remainder_is_comments_and_whitespace());
+	}
+
+	{
+		JSONParser parser = parser_from_c_str<JSONDialect>("{ \"weights\": [ [ 1, 2 ] [ 3, 4 ] ] }");
+		double weights[4];
+		REQUIRE_FALSE(parser.read("weights", weights, ArrayShape(2, 2)));
+		REQUIRE(parser.get_error().error == ParserError::CommaExpected);
+	}
+}
+
+TEST_CASE("Parser Hex Float Reading", "[parser]")
+{
+	{
+		Parser parser = parser_from_c_str("a = 0x1.8p+1 b = -0x1.999999999999ap-4 c = 0x0p+0 d = 0X1P10 e = [ 0x1p-1, -0x1.0p1 ] f = 0x1.8");
+		double a;
+		double b;
+		float c;
+		double d;
+		double e[2];
+		double f;
+		REQUIRE(parser.read("a", a));
+		REQUIRE(parser.read("b", b));
+		REQUIRE(parser.read("c", c));
+		REQUIRE(parser.read("d", d));
+		REQUIRE(parser.read("e", e, 2));
+		REQUIRE(parser.read("f", f));
+		REQUIRE(a == 3.0);
+		REQUIRE(b == -0.1);
+		REQUIRE(c == 0.0F);
+		REQUIRE(d == 1024.0);
+		REQUIRE(e[0] == 0.5);
+		REQUIRE(e[1] == -2.0);
+		REQUIRE(f == 1.5);
+		REQUIRE(parser.remainder_is_comments_and_whitespace());
+	}
+
+	{
+		// Every double round trips bit for bit through the C99 form, subnormals included
+		uint64_t bits = 0x9E3779B97F4A7C15ull;
+		for (uint32_t iteration = 0; iteration < 1000; ++iteration)
+		{
+			bits ^= bits << 13;
+			bits ^= bits >> 7;
+			bits ^= bits << 17;
+
+			double expected;
+			std::memcpy(&expected, &bits, sizeof(expected));
+			if (std::isnan(expected) || std::isinf(expected))
+				continue;
+
+			char buffer[64];
+			snprintf(buffer, sizeof(buffer), "value = %a", expected);
+
+			Parser parser = parser_from_c_str(buffer);
+			double value;
+			REQUIRE(parser.read("value", value));
+
+			uint64_t value_bits;
+			std::memcpy(&value_bits, &value, sizeof(value_bits));
+			REQUIRE(value_bits == bits);
+		}
+	}
+
+	{
+		Parser parser = parser_from_c_str("b = 0xp+1");
+		double value;
+		REQUIRE_FALSE(parser.read("b", value));
+		REQUIRE(parser.get_error().error == ParserError::InvalidNumber);
+
+		parser = parser_from_c_str("c = 0x1p");
+		REQUIRE_FALSE(parser.read("c", value));
+		REQUIRE(parser.get_error().error == ParserError::InvalidNumber);
+	}
+
+	{
+		// Digits past the precision of the mantissa are rounded like strtod does
+		Parser parser = parser_from_c_str("a = 0x10000000000000000p0 b = 0x1.0000000000000000p0 c = 0x1.0000000000000800000000p0 d = 0x1.0000000000000800000001p0 e = 0x1.0000000000001800000000p0");
+		double value;
+		REQUIRE(parser.read("a", value));
+		REQUIRE(value == 18446744073709551616.0);
+		REQUIRE(parser.read("b", value));
+		REQUIRE(value == 1.0);
+		REQUIRE(parser.read("c", value));
+		REQUIRE(value == 1.0);
+		REQUIRE(parser.read("d", value));
+		REQUIRE(value == 1.0 + std::ldexp(1.0, -52));
+		REQUIRE(parser.read("e", value));
+		REQUIRE(value == 1.0 + std::ldexp(1.0, -51));
+	}
+
+	{
+		// Rounding happens once at the precision of the target type, subnormals included
+		Parser parser = parser_from_c_str("a = 0x1.000000000000001p-1075 b = 0x1.00000100000004p0 c = 0x1.000000000000001p-150 d = 0x1p-1075");
+		double dbl_value;
+		REQUIRE(parser.read("a", dbl_value));
+		REQUIRE(dbl_value == std::numeric_limits<double>::denorm_min());
+
+		float flt_value;
+		REQUIRE(parser.read("b", flt_value));
+		REQUIRE(flt_value == 1.0F + std::ldexp(1.0F, -23));
+		REQUIRE(parser.read("c", flt_value));
+		REQUIRE(flt_value == std::numeric_limits<float>::denorm_min());
+
+		// A tie with the smallest subnormal rounds to even
+		REQUIRE(parser.read("d", dbl_value));
+		REQUIRE(dbl_value == 0.0);
+	}
+
+	{
+		// Not an integer
+		Parser parser = parser_from_c_str("a = 0x1p4");
+		int32_t value;
+		REQUIRE_FALSE(parser.read("a", value));
+	}
+
+	{
+		BasicParser<MinimalSJSONDialect> parser = parser_from_c_str<MinimalSJSONDialect>("a = 0x1p4");
+		double value;
+		REQUIRE_FALSE((parser.read("a", value) && parser.remainder_is_comments_and_whitespace()));
+	}
+
+	{
+		// Hexadecimal floats are skipped like any other number
+		Parser parser = parser_from_c_str("a = [ 0x1.8p+1, 0x1p-3 ] b = 0x1p1 c = 1");
+		StringView key;
+		StringView raw_value;
+		REQUIRE(parser.read_next_key(key));
+		REQUIRE(parser.skip_value());
+		REQUIRE(parser.read_next_key(key));
+		REQUIRE(parser.read_raw_value(raw_value));
+		REQUIRE(raw_value == "0x1p1");
+
+		double c;
+		REQUIRE(parser.read("c", c));
+		REQUIRE(parser.remainder_is_comments_and_whitespace());
+	}
+}
+
+TEST_CASE("Parser Binary Reading", "[parser]")
+{
+	{
+		Parser parser = parser_from_c_str("a = \"\" b = \"Zg==\" c = \"Zm8=\" d = \"Zm9v\" e = \"Zm9vYmFy\" f = \"Zm9vYg\" g = [ \"AP/+gA==\", \"AA==\" ]");
+		uint8_t buffer[16];
+		size_t size;
+
+		REQUIRE(parser.read_binary("a", buffer, sizeof(buffer), size));
+		REQUIRE(size == 0);
+		REQUIRE(parser.read_binary("b", buffer, sizeof(buffer), size));
+		REQUIRE(size == 1);
+		REQUIRE(buffer[0] == 'f');
+		REQUIRE(parser.read_binary("c", buffer, sizeof(buffer), size));
+		REQUIRE(size == 2);
+		REQUIRE(parser.read_binary("d", buffer, sizeof(buffer), size));
+		REQUIRE(size == 3);
+		REQUIRE(parser.read_binary("e", buffer, sizeof(buffer), size));
+		REQUIRE(size == 6);
+		REQUIRE(std::memcmp(buffer, "foobar", 6) == 0);
+
+		// Padding is optional
+		REQUIRE(parser.read_binary("f", buffer, sizeof(buffer), size));
+		REQUIRE(size == 4);
+		REQUIRE(std::memcmp(buffer, "foob", 4) == 0);
+
+		REQUIRE(parser.array_begins("g"));
+		REQUIRE(parser.read_binary(buffer, sizeof(buffer), size));
+		REQUIRE(size == 4);
+		REQUIRE(buffer[1] == 0xFF);
+		REQUIRE(buffer[3] == 0x80);
+		REQUIRE(parser.read_array_separator());
+		REQUIRE(parser.read_binary(buffer, sizeof(buffer), size));
+		REQUIRE(size == 1);
+		REQUIRE(parser.array_ends());
+		REQUIRE(parser.remainder_is_comments_and_whitespace());
+	}
+
+	{
+		// Round trip through the writer
+		std::vector<uint8_t> data(5000);
+		for (size_t i = 0; i < data.size(); ++i)
+			data[i] = uint8_t((i * 7919) >> 3);
+
+		std::string input = "blob = \"";
+		std::string encoded((data.size() + 2) / 3 * 4, '\0');
+		encoded.resize(impl::encode_base64(data.data(), data.size(), &encoded[0]));
+		input += encoded + "\" next = 1";
+
+		std::vector<uint8_t> decoded(get_base64_max_decoded_size(encoded.size()));
+		Parser parser(input.c_str(), input.size());
+		size_t size;
+		REQUIRE(parser.read_binary("blob", decoded.data(), decoded.size(), size));
+		REQUIRE(size == data.size());
+		REQUIRE(std::memcmp(decoded.data(), data.data(), size) == 0);
+
+		double next;
+		REQUIRE(parser.read("next", next));
+		REQUIRE(parser.remainder_is_comments_and_whitespace());
+	}
+
+	{
+		uint8_t buffer[4];
+		size_t size;
+
+		Parser parser = parser_from_c_str("a = \"Zm9vYmFy\"");
+		REQUIRE_FALSE(parser.read_binary("a", buffer, sizeof(buffer), size));
+		REQUIRE(parser.get_error().error == ParserError::LengthOutOfRange);
+
+		parser = parser_from_c_str("a = \"Zm9v YmFy\"");
+		REQUIRE_FALSE(parser.read_binary("a", buffer, sizeof(buffer), size));
+		REQUIRE(parser.get_error().error == ParserError::InvalidBase64);
+		REQUIRE(parser.get_error().column == 10);
+
+		parser = parser_from_c_str("a = \"Zg=\"");
+		REQUIRE_FALSE(parser.read_binary("a", buffer, sizeof(buffer), size));
+		REQUIRE(parser.get_error().error == ParserError::InvalidBase64);
+
+		parser = parser_from_c_str("a = \"Z\"");
+		REQUIRE_FALSE(parser.read_binary("a", buffer, sizeof(buffer), size));
+		REQUIRE(parser.get_error().error == ParserError::InvalidBase64);
+
+		parser = parser_from_c_str("a = \"Zm9v");
+		REQUIRE_FALSE(parser.read_binary("a", buffer, sizeof(buffer), size));
+		REQUIRE(parser.get_error().error == ParserError::InputTruncated);
+
+		parser = parser_from_c_str("a = Zm9v");
+		REQUIRE_FALSE(parser.read_binary("a", buffer, sizeof(buffer), size));
+		REQUIRE(parser.get_error().error == ParserError::QuotationMarkExpected);
+	}
+}
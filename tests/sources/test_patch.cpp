@@ -0,0 +1,160 @@
+////////////////////////////////////////////////////////////////////////////////
+// The MIT License (MIT)
+//
+// Copyright (c) 2018 Nicholas Frechette, Cody Jones, and sjson-cpp contributors
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <catch.hpp>
+
+#include "string_stream_writer.h"
+
+#include <sjson/patch.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace sjson;
+
+TEST_CASE("Document Patch", "[patch]")
+{
+	const char* input =
+		"// Comments are preserved\r\n"
+		"version = 3\r\n"
+		"settings = {\r\n"
+		"\trender = { width = 1280 /* pixels */ height = 720 }\r\n"
+		"\tname = \"low\"\r\n"
+		"\tlights = [ { intensity = 0.5 } { intensity = 1.5 } ]\r\n"
+		"}\r\n"
+		"trailing = [ 1, 2, 3 ]\r\n";
+
+	{
+		PatchEdit edits[] =
+		{
+			{ "settings.name", "ultra" },
+			{ "settings.render.width", 1920 },
+			{ "settings.lights.1", PatchValue::raw("{ intensity = 2.0 }") },
+			{ "version", uint64_t(4) },
+		};
+
+		Parser parser(input, std::strlen(input));
+		StringStreamWriter output;
+		DocumentPatch patch(edits, 4);
+		REQUIRE(patch.apply(parser, output));
+
+		const char* expected =
+			"// Comments are preserved\r\n"
+			"version = 4\r\n"
+			"settings = {\r\n"
+			"\trender = { width = 1920 /* pixels */ height = 720 }\r\n"
+			"\tname = \"ultra\"\r\n"
+			"\tlights = [ { intensity = 0.5 } { intensity = 2.0 } ]\r\n"
+			"}\r\n"
+			"trailing = [ 1, 2, 3 ]\r\n";
+		REQUIRE(output.str() == expected);
+
+		Parser patched(output.str().c_str(), output.str().size());
+		double intensity = 0.0;
+		REQUIRE(patched.read("version", intensity));
+		REQUIRE(intensity == 4.0);
+	}
+
+	{
+		PatchEdit edits[] = { { "settings.render.height", 1080.5 }, { "trailing", false } };
+
+		Parser parser(input, std::strlen(input));
+		StringStreamWriter output;
+		DocumentPatch patch(edits, 2);
+		REQUIRE(patch.apply(parser, output));
+		REQUIRE(output.str().find("height = 1080.5 }") != std::string::npos);
+		REQUIRE(output.str().find("trailing = false\r\n") != std::string::npos);
+	}
+
+	{
+		PatchEdit edits[] = { { "version", 5 }, { "settings.missing", true } };
+
+		Parser parser(input, std::strlen(input));
+		StringStreamWriter output;
+		DocumentPatch patch(edits, 2);
+		REQUIRE_FALSE(patch.apply(parser, output));
+		REQUIRE(parser.get_error().error == ParserError::RequiredKeyMissing);
+		REQUIRE(patch.get_error_edit_index() == 1);
+		REQUIRE(output.str().empty());
+	}
+
+	{
+		PatchEdit edits[] = { { "settings", 1 }, { "settings.name", "a" } };
+
+		Parser parser(input, std::strlen(input));
+		StringStreamWriter output;
+		DocumentPatch patch(edits, 2);
+		REQUIRE_FALSE(patch.apply(parser, output));
+		REQUIRE(parser.get_error().error == ParserError::OverlappingPaths);
+		REQUIRE(patch.get_error_edit_index() == 1);
+		REQUIRE(output.str().empty());
+	}
+
+	{
+		PatchEdit edits[] = { { "settings.name", "b" }, { "version", 5 }, { "settings.name", "a" } };
+
+		Parser parser(input, std::strlen(input));
+		StringStreamWriter output;
+		DocumentPatch patch(edits, 3);
+		REQUIRE_FALSE(patch.apply(parser, output));
+		REQUIRE(parser.get_error().error == ParserError::OverlappingPaths);
+		REQUIRE(patch.get_error_edit_index() == 2);
+		REQUIRE(output.str().empty());
+	}
+
+	{
+		// Too many edits are refused before anything is written
+		const PatchEdit edit = { "version", 5 };
+		std::vector<PatchEdit> edits(DocumentPatch::k_max_num_edits + 1, edit);
+
+		Parser parser(input, std::strlen(input));
+		StringStreamWriter output;
+		DocumentPatch patch(edits.data(), uint32_t(edits.size()));
+		REQUIRE_FALSE(patch.apply(parser, output));
+		REQUIRE(parser.get_error().error == ParserError::TooManyPaths);
+		REQUIRE(output.str().empty());
+	}
+
+	{
+		PatchEdit edits[] = { { "settings.name", "say \"hi\" C:\\temp" } };
+
+		Parser parser(input, std::strlen(input));
+		StringStreamWriter output;
+		DocumentPatch patch(edits, 1);
+		REQUIRE(patch.apply(parser, output));
+		REQUIRE(output.str().find("\tname = \"say \\\"hi\\\" C:\\\\temp\"\r\n") != std::string::npos);
+	}
+
+	{
+		const char* json_input = "{ \"a\": [ 1, 2 ], \"b\": { \"c\": null } }";
+		PatchEdit edits[] = { { "/b/c", "x" }, { "/a/0", -3 } };
+
+		JSONParser parser(json_input, std::strlen(json_input));
+		StringStreamWriter output;
+		DocumentPatch patch(edits, 2);
+		REQUIRE(patch.apply(parser, output));
+		REQUIRE(output.str() == "{ \"a\": [ -3, 2 ], \"b\": { \"c\": \"x\" } }");
+	}
+}
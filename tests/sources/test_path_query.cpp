@@ -0,0 +1,150 @@
+////////////////////////////////////////////////////////////////////////////////
+// The MIT License (MIT)
+//
+// Copyright (c) 2018 Nicholas Frechette, Cody Jones, and sjson-cpp contributors
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <catch.hpp>
+
+#include <sjson/path_query.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace sjson;
+
+TEST_CASE("Path Query", "[path_query]")
+{
+	const char* input =
+		"// Comments are skipped\r\n"
+		"version = 3\r\n"
+		"ignored = { a = [ 1, { \"}\" = \"]\" } ], b = \"{\" } /* } */\r\n"
+		"settings = {\r\n"
+		"\trender = {\r\n"
+		"\t\tshadows = { resolution = 2048 enabled = true }\r\n"
+		"\t\tlights = [ { intensity = 0.5 } { intensity = 1.5 } ]\r\n"
+		"\t\tname = \"high\"\r\n"
+		"\t}\r\n"
+		"}\r\n";
+
+	{
+		const char* paths[] = { "settings.render.shadows.resolution", "/settings/render/lights/1/intensity", "settings.render.name", "version", "settings.render.shadows", "missing.key" };
+		PathQuery query(paths, 6);
+
+		Parser parser(input, std::strlen(input));
+		REQUIRE(query.evaluate(parser));
+		REQUIRE(query.get_num_missing() == 1);
+
+		uint32_t resolution = 0;
+		REQUIRE(query.get_result(0).type == ValueType::Number);
+		REQUIRE(query.get_result(0).get(resolution));
+		REQUIRE(resolution == 2048);
+
+		double intensity = 0.0;
+		REQUIRE(query.get_result(1).get(intensity));
+		REQUIRE(intensity == 1.5);
+
+		StringView name;
+		REQUIRE(query.get_result(2).type == ValueType::String);
+		REQUIRE(query.get_result(2).get(name));
+		REQUIRE(name == "high");
+
+		int32_t version = 0;
+		REQUIRE(query.get_result(3).get(version));
+		REQUIRE(version == 3);
+		REQUIRE(query.get_result(3).line == 2);
+
+		REQUIRE(query.get_result(4).type == ValueType::Object);
+		REQUIRE(query.get_result(4).raw_value == "{ resolution = 2048 enabled = true }");
+		REQUIRE(query.get_result(4).line == 6);
+		REQUIRE(query.get_result(4).column == 14);
+
+		REQUIRE_FALSE(query.get_result(5).is_found);
+		REQUIRE_FALSE(query.get_result(5).get(version));
+
+		REQUIRE(parser.remainder_is_comments_and_whitespace());
+		REQUIRE(parser.is_valid());
+	}
+
+	{
+		// Evaluation stops once everything has been found
+		const char* paths[] = { "version" };
+		PathQuery query(paths, 1);
+
+		Parser parser(input, std::strlen(input));
+		REQUIRE(query.evaluate(parser));
+		REQUIRE(query.get_num_missing() == 0);
+		REQUIRE_FALSE(parser.eof());
+	}
+
+	{
+		const char* json_input = "{ \"a\": { \"b\": [ 10, 20, 30 ], \"c\": null }, \"d\": false }";
+		const char* paths[] = { "a.b.2", "a.c", "d" };
+		PathQuery query(paths, 3);
+
+		JSONParser parser(json_input, std::strlen(json_input));
+		REQUIRE(query.evaluate(parser));
+		REQUIRE(query.get_num_missing() == 0);
+
+		int32_t value = 0;
+		REQUIRE(query.get_result(0).get(value));
+		REQUIRE(value == 30);
+		REQUIRE(query.get_result(1).type == ValueType::Null);
+
+		bool flag = true;
+		REQUIRE(query.get_result(2).get(flag));
+		REQUIRE(flag == false);
+		REQUIRE(parser.remainder_is_comments_and_whitespace());
+	}
+
+	{
+		const char* bad_input = "key = { foo = [ 1, 2 }";
+		const char* paths[] = { "other" };
+		PathQuery query(paths, 1);
+
+		Parser parser(bad_input, std::strlen(bad_input));
+		REQUIRE_FALSE(query.evaluate(parser));
+		REQUIRE(parser.get_error().error == ParserError::InputTruncated);
+	}
+	{
+		// Queries beyond the limits are refused when evaluated
+		std::vector<const char*> paths(PathQuery::k_max_num_paths + 1, "version");
+		PathQuery too_many_paths(paths.data(), uint32_t(paths.size()));
+		REQUIRE_FALSE(too_many_paths.is_valid());
+
+		Parser parser(input, std::strlen(input));
+		REQUIRE_FALSE(too_many_paths.evaluate(parser));
+		REQUIRE(parser.get_error().error == ParserError::TooManyPaths);
+
+		std::string long_path = "a";
+		for (uint32_t segment_index = 0; segment_index < PathQuery::k_max_num_segments; ++segment_index)
+			long_path += ".a";
+
+		const char* long_paths[] = { long_path.c_str() };
+		PathQuery too_many_segments(long_paths, 1);
+		REQUIRE_FALSE(too_many_segments.is_valid());
+
+		parser.reset_state();
+		REQUIRE_FALSE(too_many_segments.evaluate(parser));
+		REQUIRE(parser.get_error().error == ParserError::TooManyPaths);
+	}
+}
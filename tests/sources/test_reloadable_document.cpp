@@ -0,0 +1,176 @@
+////////////////////////////////////////////////////////////////////////////////
+// The MIT License (MIT)
+//
+// Copyright (c) 2018 Nicholas Frechette, Cody Jones, and sjson-cpp contributors
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <catch.hpp>
+
+#include "temp_file.h"
+
+#include <sjson/reloadable_document.h>
+
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace sjson;
+
+static std::string make_generation_input(uint32_t generation)
+{
+	// Every value holds the generation, a reader seeing two different values would have observed a partial document
+	char buffer[256];
+	snprintf(buffer, sizeof(buffer), "generation = %u\r\nsettings = { a = %u b = [ %u, %u ] }\r\ntail = %u\r\n", generation, generation, generation, generation, generation);
+	return std::string(buffer);
+}
+
+TEST_CASE("Reloadable Document", "[reloadable_document]")
+{
+	ReloadableDocument config;
+	REQUIRE_FALSE(config.get());
+	REQUIRE(config.get_generation() == 0);
+
+	const std::string input = make_generation_input(1);
+	REQUIRE(config.reload(input.c_str(), input.size()));
+	REQUIRE(config.get_generation() == 1);
+
+	std::shared_ptr<const Document> first = config.get();
+	REQUIRE(first);
+
+	// A failed reload leaves the current document in place
+	const char* invalid = "generation = [ 2";
+	REQUIRE_FALSE(config.reload(invalid, std::strlen(invalid)));
+	REQUIRE(config.get_last_error().error == ParserError::InputTruncated);
+	REQUIRE(config.get() == first);
+	REQUIRE(config.get_generation() == 1);
+
+	config.reload_in_background(make_generation_input(2));
+	REQUIRE(config.wait_for_reload());
+	REQUIRE(config.get_generation() == 2);
+
+	// Readers holding the previous document keep it alive
+	uint32_t generation = 0;
+	REQUIRE(first->find("generation").get(generation));
+	REQUIRE(generation == 1);
+	REQUIRE(config.get()->find("generation").get(generation));
+	REQUIRE(generation == 2);
+
+	config.reload_file_in_background("this/file/does/not/exist.sjson");
+	REQUIRE_FALSE(config.wait_for_reload());
+	REQUIRE(config.get_last_error().error == ParserError::FileCouldNotBeRead);
+	REQUIRE(config.get_generation() == 2);
+
+	{
+		const std::string path = get_temp_file_path("reloadable_document_test.sjson");
+		REQUIRE(write_temp_file(path, make_generation_input(3).c_str()));
+
+		const bool is_reloaded = config.reload_file(path.c_str());
+		std::remove(path.c_str());
+
+		REQUIRE(is_reloaded);
+		REQUIRE(config.get()->find("settings.b.1").get(generation));
+		REQUIRE(generation == 3);
+	}
+
+	// A reload waits for the background reload in flight and is published after it
+	config.reload_in_background(make_generation_input(4));
+	REQUIRE_FALSE(config.reload(invalid, std::strlen(invalid)));
+	REQUIRE_FALSE(config.wait_for_reload());
+	REQUIRE(config.get_generation() == 4);
+
+	const std::string last_input = make_generation_input(5);
+	config.reload_in_background(make_generation_input(6));
+	REQUIRE(config.reload(last_input.c_str(), last_input.size()));
+	REQUIRE(config.get_generation() == 6);
+	REQUIRE(config.get()->find("generation").get(generation));
+	REQUIRE(generation == 5);
+}
+
+TEST_CASE("Reloadable Document Stress", "[reloadable_document]")
+{
+	ReloadableDocument config;
+	const std::string initial_input = make_generation_input(0);
+	REQUIRE(config.reload(initial_input.c_str(), initial_input.size()));
+
+	constexpr uint32_t k_num_readers = 6;
+	constexpr uint32_t k_num_reloads = 200;
+
+	std::atomic<bool> is_done(false);
+	std::atomic<uint32_t> num_failures(0);
+	std::atomic<uint32_t> num_reads(0);
+
+	std::vector<std::thread> readers;
+	for (uint32_t reader_index = 0; reader_index < k_num_readers; ++reader_index)
+	{
+		readers.push_back(std::thread([&config, &is_done, &num_failures, &num_reads]()
+		{
+			uint32_t last_generation = 0;
+			while (!is_done.load(std::memory_order_acquire))
+			{
+				std::shared_ptr<const Document> document = config.get();
+
+				uint32_t generation = 0xFFFFFFFFu;
+				uint32_t a = 0xFFFFFFFFu;
+				uint32_t b = 0xFFFFFFFFu;
+				uint32_t tail = 0xFFFFFFFFu;
+				document->find("generation").get(generation);
+				document->find("settings.a").get(a);
+				document->find("settings.b.1").get(b);
+				document->find("tail").get(tail);
+
+				// Values must be consistent and generations must never go backwards
+				if (a != generation || b != generation || tail != generation || generation < last_generation)
+					num_failures++;
+
+				last_generation = generation;
+				num_reads++;
+			}
+		}));
+	}
+
+	for (uint32_t generation = 1; generation <= k_num_reloads; ++generation)
+	{
+		if ((generation % 2) == 0)
+			config.reload_in_background(make_generation_input(generation));
+		else
+		{
+			const std::string input = make_generation_input(generation);
+			config.reload(input.c_str(), input.size());
+		}
+
+		config.wait_for_reload();
+	}
+
+	is_done.store(true, std::memory_order_release);
+	for (std::thread& reader : readers)
+		reader.join();
+
+	REQUIRE(num_failures == 0);
+	REQUIRE(num_reads != 0);
+	REQUIRE(config.get_generation() == k_num_reloads + 1);
+
+	uint32_t generation = 0;
+	REQUIRE(config.get()->find("generation").get(generation));
+	REQUIRE(generation == k_num_reloads);
+}
@@ -0,0 +1,229 @@
+////////////////////////////////////////////////////////////////////////////////
+// The MIT License (MIT)
+//
+// Copyright (c) 2018 Nicholas Frechette, Cody Jones, and sjson-cpp contributors
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <catch.hpp>
+
+#include <sjson/schema.h>
+
+#include <cstring>
+#include <vector>
+
+using namespace sjson;
+
+TEST_CASE("Schema Validation", "[schema]")
+{
+	const char* input =
+		"version = 3\r\n"
+		"render = {\r\n"
+		"\twidth = 1920\r\n"
+		"\tname = \"high\"\r\n"
+		"\tvsync = true\r\n"
+		"\tlights = [ { intensity = 0.5 } { intensity = 1.5 color = [ 1, 0, 0 ] } ]\r\n"
+		"}\r\n";
+
+	{
+		int64_t version = 0;
+		int64_t width = 0;
+		StringView name;
+		bool vsync = false;
+		double gamma = 2.2;
+
+		const SchemaField fields[] =
+		{
+			SchemaField::integer("version", 1, 3).bind(&version),
+			SchemaField::object("render"),
+			SchemaField::integer("render.width", 1, 8192).bind(&width),
+			SchemaField::string("render.name", 1, 16).bind(&name),
+			SchemaField::boolean("render.vsync").bind(&vsync),
+			SchemaField::number("render.gamma", 1.0, 3.0).optional().bind(&gamma),
+			SchemaField::array("render.lights", 1, 8),
+			SchemaField::object("render.lights.*"),
+			SchemaField::number("render.lights.*.intensity", 0.0, 10.0),
+			SchemaField::array("render.lights.*.color", 3, 3).optional(),
+			SchemaField::number("render.lights.*.color.*", 0.0, 1.0),
+		};
+		SchemaValidator validator(fields, sizeof(fields) / sizeof(fields[0]));
+
+		Parser parser(input, std::strlen(input));
+		REQUIRE(validator.validate(parser));
+		REQUIRE(parser.remainder_is_comments_and_whitespace());
+		REQUIRE(version == 3);
+		REQUIRE(width == 1920);
+		REQUIRE(name == "high");
+		REQUIRE(vsync);
+		REQUIRE(gamma == 2.2);
+	}
+
+	{
+		// Unknown keys are rejected unless allowed, members not described are then skipped
+		const SchemaField fields[] = { SchemaField::integer("version") };
+
+		SchemaValidator strict_validator(fields, 1);
+		Parser parser(input, std::strlen(input));
+		REQUIRE_FALSE(strict_validator.validate(parser));
+		REQUIRE(parser.get_error().error == ParserError::UnexpectedKey);
+		REQUIRE(parser.get_error().line == 2);
+
+		SchemaValidator lax_validator(fields, 1, true);
+		parser.reset_state();
+		REQUIRE(lax_validator.validate(parser));
+		REQUIRE(parser.remainder_is_comments_and_whitespace());
+	}
+
+	{
+		const SchemaField fields[] =
+		{
+			SchemaField::integer("version"),
+			SchemaField::object("render"),
+			SchemaField::integer("render.height"),
+			SchemaField::any("render.width").optional(),
+		};
+		SchemaValidator validator(fields, 4, true);
+
+		Parser parser(input, std::strlen(input));
+		REQUIRE_FALSE(validator.validate(parser));
+		REQUIRE(parser.get_error().error == ParserError::RequiredKeyMissing);
+		REQUIRE(parser.get_error().line == 7);
+		REQUIRE(validator.get_error_field_index() == 2);
+	}
+
+	{
+		const SchemaField fields[] = { SchemaField::string("version") };
+		SchemaValidator validator(fields, 1, true);
+
+		Parser parser(input, std::strlen(input));
+		REQUIRE_FALSE(validator.validate(parser));
+		REQUIRE(parser.get_error().error == ParserError::TypeMismatch);
+		REQUIRE(parser.get_error().line == 1);
+		REQUIRE(validator.get_error_field_index() == 0);
+	}
+
+	{
+		// A real number is not an integer
+		const char* real_width = "render = { width = 1.5 }";
+		const SchemaField fields[] =
+		{
+			SchemaField::object("render"),
+			SchemaField::integer("render.width"),
+		};
+		SchemaValidator validator(fields, 2);
+
+		Parser parser(real_width, std::strlen(real_width));
+		REQUIRE_FALSE(validator.validate(parser));
+		REQUIRE(parser.get_error().error == ParserError::TypeMismatch);
+		REQUIRE(parser.get_error().column == 20);
+		REQUIRE(validator.get_error_field_index() == 1);
+	}
+
+	{
+		const SchemaField fields[] =
+		{
+			SchemaField::object("render"),
+			SchemaField::integer("render.width", 1, 1024),
+		};
+		SchemaValidator validator(fields, 2, true);
+
+		Parser parser(input, std::strlen(input));
+		REQUIRE_FALSE(validator.validate(parser));
+		REQUIRE(parser.get_error().error == ParserError::ValueOutOfRange);
+		REQUIRE(parser.get_error().line == 3);
+	}
+
+	{
+		const SchemaField fields[] =
+		{
+			SchemaField::object("render"),
+			SchemaField::array("render.lights", 0, 1),
+		};
+		SchemaValidator validator(fields, 2, true);
+
+		Parser parser(input, std::strlen(input));
+		REQUIRE_FALSE(validator.validate(parser));
+		REQUIRE(parser.get_error().error == ParserError::LengthOutOfRange);
+		REQUIRE(parser.get_error().line == 6);
+	}
+
+	{
+		// Syntax errors are reported as usual
+		const char* truncated = "render = { width = 1920";
+		const SchemaField fields[] =
+		{
+			SchemaField::object("render"),
+			SchemaField::integer("render.width"),
+		};
+		SchemaValidator validator(fields, 2);
+
+		Parser parser(truncated, std::strlen(truncated));
+		REQUIRE_FALSE(validator.validate(parser));
+		REQUIRE(parser.get_error().error == ParserError::InputTruncated);
+	}
+
+	{
+		const char* json = "{ \"size\": [ 2, 4 ], \"name\": \"grid\" }";
+		const SchemaField fields[] =
+		{
+			SchemaField::array("size", 2, 2),
+			SchemaField::integer("size.*", 1, 16),
+			SchemaField::string("name"),
+		};
+		SchemaValidator validator(fields, 3);
+
+		JSONParser parser(json, std::strlen(json));
+		REQUIRE(validator.validate(parser));
+		REQUIRE(parser.remainder_is_comments_and_whitespace());
+	}
+
+	{
+		// Malformed schemas are caught when they are compiled
+		const SchemaField not_an_array[] = { SchemaField::object("render"), SchemaField::integer("render.*") };
+		REQUIRE_THROWS(SchemaValidator(not_an_array, 2));
+
+		int64_t value;
+		const SchemaField bound_element[] = { SchemaField::array("sizes"), SchemaField::integer("sizes.*").bind(&value) };
+		REQUIRE_THROWS(SchemaValidator(bound_element, 2));
+	}
+
+	{
+		// Invalid schemas are refused when validating
+		const SchemaField orphan[] = { SchemaField::object("render"), SchemaField::integer("sizes.*") };
+		SchemaValidator orphan_validator(orphan, 2);
+		REQUIRE_FALSE(orphan_validator.is_valid());
+
+		Parser parser(input, std::strlen(input));
+		REQUIRE_FALSE(orphan_validator.validate(parser));
+		REQUIRE(parser.get_error().error == ParserError::InvalidSchema);
+		REQUIRE(orphan_validator.get_error_field_index() == 1);
+
+		const SchemaField field = SchemaField::any("version");
+		std::vector<SchemaField> too_many_fields(SchemaValidator::k_max_num_fields + 1, field);
+		SchemaValidator too_many_validator(too_many_fields.data(), uint32_t(too_many_fields.size()));
+		REQUIRE_FALSE(too_many_validator.is_valid());
+
+		parser.reset_state();
+		REQUIRE_FALSE(too_many_validator.validate(parser));
+		REQUIRE(parser.get_error().error == ParserError::InvalidSchema);
+		const uint32_t invalid_index = SchemaValidator::k_invalid_index;
+		REQUIRE(too_many_validator.get_error_field_index() == invalid_index);
+	}
+}
@@ -24,31 +24,19 @@
 
 #include <catch.hpp>
 
+#include "string_stream_writer.h"
+
+#include <sjson/parser.h>
 #include <sjson/writer.h>
 
-#include <sstream>
+#include <chrono>
+#include <cstdio>
+#include <functional>
 #include <string>
+#include <vector>
 
 using namespace sjson;
 
-class StringStreamWriter final : public StreamWriter
-{
-public:
-	StringStreamWriter()
-		: m_buffer()
-	{}
-
-	virtual void write(const void* buffer, size_t buffer_size) override
-	{
-		m_buffer.sputn(reinterpret_cast<const char*>(buffer), buffer_size);
-	}
-
-	std::string str() const { return m_buffer.str(); }
-
-private:
-	std::stringbuf m_buffer;
-};
-
 TEST_CASE("Writer Object Bool Writing", "[writer]")
 {
 	{
@@ -648,3 +636,416 @@ TEST_CASE("Writer Array Object Writing", "[writer]")
 		REQUIRE(str_writer.str() == "key = [ \r\n\t{\r\n\t\tkey0 = 123.5\r\n\t\tkey1 = 456.5\r\n\t}\r\n]\r\n");
 	}
 }
+
+static void write_nested_objects(ObjectWriter& object_writer, uint32_t depth)
+{
+	if (depth == 0)
+	{
+		object_writer.insert("value", true);
+		return;
+	}
+
+	object_writer.insert("nested", [depth](ObjectWriter& nested_writer) { write_nested_objects(nested_writer, depth - 1); });
+}
+
+TEST_CASE("Writer Indentation", "[writer]")
+{
+	{
+		WriterSettings settings;
+		settings.indentation_symbol = ' ';
+		settings.indentation_width = 4;
+
+		StringStreamWriter str_writer;
+		Writer writer(str_writer, settings);
+		writer.insert("key", [](ArrayWriter& array_writer)
+		{
+			array_writer.push([](ObjectWriter& object_writer) { object_writer.insert("key0", 1.5); });
+			array_writer.push([](ObjectWriter& object_writer) { object_writer.insert("key1", 2.5); });
+		});
+		REQUIRE(str_writer.str() == "key = [ \r\n    {\r\n        key0 = 1.5\r\n    }\r\n    {\r\n        key1 = 2.5\r\n    }\r\n]\r\n");
+	}
+
+	{
+		// Deeper than a single slice of the indentation run
+		const uint32_t depth = 70;
+
+		StringStreamWriter str_writer;
+		Writer writer(str_writer);
+		write_nested_objects(writer, depth);
+
+		std::string expected;
+		for (uint32_t level = 0; level < depth; ++level)
+			expected += std::string(level, '\t') + "nested = {\r\n";
+		expected += std::string(depth, '\t') + "value = true\r\n";
+		for (uint32_t level = depth; level-- > 0;)
+			expected += std::string(level, '\t') + "}\r\n";
+
+		REQUIRE(str_writer.str() == expected);
+	}
+}
+
+// Counts the output instead of storing it, to only measure the writer
+class CountingStreamWriter final : public StreamWriter
+{
+public:
+	CountingStreamWriter()
+		: m_num_writes(0)
+		, m_num_bytes(0)
+	{}
+
+	virtual void write(const void* buffer, size_t buffer_size) override
+	{
+		(void)buffer;
+		m_num_writes++;
+		m_num_bytes += buffer_size;
+	}
+
+	size_t get_num_writes() const { return m_num_writes; }
+	size_t get_num_bytes() const { return m_num_bytes; }
+
+private:
+	size_t m_num_writes;
+	size_t m_num_bytes;
+};
+
+// Hidden by default, run it explicitly with the [benchmark] tag
+TEST_CASE("Writer Deep Nesting Throughput", "[.][benchmark]")
+{
+	constexpr uint32_t k_depth = 200;
+	constexpr uint32_t k_num_iterations = 2000;
+
+	CountingStreamWriter counting_writer;
+
+	const auto start_time = std::chrono::high_resolution_clock::now();
+	for (uint32_t iteration = 0; iteration < k_num_iterations; ++iteration)
+	{
+		Writer writer(counting_writer);
+		write_nested_objects(writer, k_depth);
+	}
+	const auto end_time = std::chrono::high_resolution_clock::now();
+
+	const double elapsed_seconds = std::chrono::duration<double>(end_time - start_time).count();
+	std::printf("Depth %u: %8.2f MB/sec, %.1f writes per level\n", k_depth, double(counting_writer.get_num_bytes()) / elapsed_seconds / (1024.0 * 1024.0), double(counting_writer.get_num_writes()) / (double(k_depth) * k_num_iterations));
+
+	// Every level writes its key, its braces, and its indentation twice
+	REQUIRE(counting_writer.get_num_bytes() > size_t(k_depth) * k_depth * k_num_iterations);
+}
+
+TEST_CASE("Writer Object Shape Writing", "[writer]")
+{
+	{
+		const char* keys[] = { "key0", "key1", "key2", "key3" };
+		ObjectShape shape(keys, 4);
+
+		StringStreamWriter str_writer;
+		Writer writer(str_writer);
+		writer.insert(shape, 0, 123.5);
+		writer.insert(shape, 1, "foo");
+		writer.insert(shape, 2, true);
+		writer.insert(shape, 3, int32_t(-12));
+		REQUIRE(str_writer.str() == "key0 = 123.5\r\nkey1 = \"foo\"\r\nkey2 = true\r\nkey3 = -12\r\n");
+	}
+
+	{
+		const char* keys[] = { "x", "y" };
+		ObjectShape shape(keys, 2);
+
+		StringStreamWriter str_writer;
+		Writer writer(str_writer);
+		writer.insert("points", [&shape](ArrayWriter& array_writer)
+		{
+			for (uint32_t i = 0; i < 2; ++i)
+			{
+				array_writer.push([&shape, i](ObjectWriter& object_writer)
+				{
+					object_writer.insert(shape, 0, uint32_t(i));
+					object_writer.insert(shape, 1, uint64_t(i + 10));
+				});
+			}
+		});
+
+		// Using the shape at a different indentation level renders it again
+		writer.insert(shape, 0, 1.5);
+		REQUIRE(str_writer.str() == "points = [ \r\n\t{\r\n\t\tx = 0\r\n\t\ty = 10\r\n\t}\r\n\t{\r\n\t\tx = 1\r\n\t\ty = 11\r\n\t}\r\n]\r\nx = 1.5\r\n");
+	}
+
+	{
+		const char* keys[] = { "key" };
+		ObjectShape shape(keys, 1);
+		const std::string long_value(1024, 'a');
+
+		StringStreamWriter str_writer;
+		Writer writer(str_writer);
+		writer.insert(shape, 0, long_value.c_str());
+		REQUIRE(str_writer.str() == "key = \"" + long_value + "\"\r\n");
+	}
+
+	{
+		// Keys that do not fit are inserted without a prefix
+		const std::string long_key(ObjectShape::k_max_prefix_length, 'k');
+		std::vector<std::string> key_names;
+		std::vector<const char*> keys;
+		for (uint32_t key_index = 0; key_index < 100; ++key_index)
+			key_names.push_back("key" + std::to_string(key_index));
+		key_names[1] = long_key;
+		for (const std::string& key_name : key_names)
+			keys.push_back(key_name.c_str());
+
+		ObjectShape shape(keys.data(), 100);
+
+		StringStreamWriter str_writer;
+		Writer writer(str_writer);
+		writer.insert(shape, 0, 1.5);
+		writer.insert(shape, 1, true);
+		writer.insert(shape, 99, "foo");
+		writer.insert(shape, 98, int32_t(-3));
+		writer.insert(shape, 97, uint32_t(3));
+		REQUIRE(shape.is_key_rendered(0));
+		REQUIRE_FALSE(shape.is_key_rendered(1));
+		REQUIRE_FALSE(shape.is_key_rendered(99));
+		REQUIRE(str_writer.str() == "key0 = 1.5\r\n" + long_key + " = true\r\nkey99 = \"foo\"\r\nkey98 = -3\r\nkey97 = 3\r\n");
+	}
+}
+
+TEST_CASE("Writer Columns Writing", "[writer]")
+{
+	{
+		const double values[] = { 1.5, -2.25, 3.0 };
+
+		StringStreamWriter str_writer;
+		Writer writer(str_writer);
+		writer.insert("key", values, 3);
+		writer.insert("empty", values, 0);
+		REQUIRE(str_writer.str() == "key = [ 1.5, -2.25, 3 ]\r\nempty = [  ]\r\n");
+	}
+
+	{
+		const float values[] = { 1.5f, 2.5f };
+
+		StringStreamWriter str_writer;
+		Writer writer(str_writer);
+		writer.insert("key", [&values](ArrayWriter& array_writer)
+		{
+			array_writer.push(true);
+			array_writer.push(values, 2);
+			array_writer.push(values, 1);
+		});
+		REQUIRE(str_writer.str() == "key = [ true, 1.5, 2.5, 1.5 ]\r\n");
+	}
+
+	{
+		// Enough values to require multiple writes
+		std::vector<double> values(1000, 0.125);
+		std::string expected = "key = [ 0.125";
+		for (size_t i = 1; i < values.size(); ++i)
+			expected += ", 0.125";
+		expected += " ]\r\n";
+
+		StringStreamWriter str_writer;
+		Writer writer(str_writer);
+		writer.insert("key", values.data(), uint32_t(values.size()));
+		REQUIRE(str_writer.str() == expected);
+	}
+
+	{
+		const double xs[] = { 1.0, 2.0 };
+		const double ys[] = { 3.5, 4.5 };
+		const char* column_names[] = { "x", "y" };
+		const double* columns[] = { xs, ys };
+
+		StringStreamWriter str_writer;
+		Writer writer(str_writer);
+		writer.insert_columns("points", column_names, columns, 2, 2);
+		REQUIRE(str_writer.str() == "points = {\r\n\tx = [ 1, 2 ]\r\n\ty = [ 3.5, 4.5 ]\r\n}\r\n");
+	}
+}
+
+// Hidden by default, run it explicitly with the [benchmark] tag
+TEST_CASE("Writer Row And Columnar Layouts", "[.][benchmark]")
+{
+	constexpr uint32_t k_num_rows = 100000;
+	constexpr uint32_t k_num_columns = 3;
+	constexpr uint32_t k_num_iterations = 5;
+
+	const char* column_names[k_num_columns] = { "x", "y", "z" };
+	std::vector<double> values[k_num_columns];
+	for (uint32_t column_index = 0; column_index < k_num_columns; ++column_index)
+	{
+		values[column_index].resize(k_num_rows);
+		for (uint32_t row_index = 0; row_index < k_num_rows; ++row_index)
+			values[column_index][row_index] = double(row_index) * 0.25 - double(column_index);
+	}
+
+	const double* columns[k_num_columns] = { values[0].data(), values[1].data(), values[2].data() };
+
+	// One object per record
+	auto write_rows = [&]()
+	{
+		StringStreamWriter str_writer;
+		Writer writer(str_writer);
+		writer.insert("points", [&](ArrayWriter& array_writer)
+		{
+			for (uint32_t row_index = 0; row_index < k_num_rows; ++row_index)
+			{
+				array_writer.push([&](ObjectWriter& object_writer)
+				{
+					for (uint32_t column_index = 0; column_index < k_num_columns; ++column_index)
+						object_writer.insert(column_names[column_index], columns[column_index][row_index]);
+				});
+			}
+		});
+		return str_writer.str();
+	};
+
+	auto read_rows = [&](const std::string& input, double* const* out_columns)
+	{
+		Parser parser(input.c_str(), input.size());
+		if (!parser.array_begins("points"))
+			return false;
+
+		for (uint32_t row_index = 0; row_index < k_num_rows; ++row_index)
+		{
+			if (!parser.object_begins())
+				return false;
+
+			for (uint32_t column_index = 0; column_index < k_num_columns; ++column_index)
+			{
+				if (!parser.read(column_names[column_index], out_columns[column_index][row_index]))
+					return false;
+			}
+
+			if (!parser.object_ends())
+				return false;
+		}
+
+		return parser.array_ends() && parser.remainder_is_comments_and_whitespace();
+	};
+
+	auto write_columns = [&]()
+	{
+		StringStreamWriter str_writer;
+		Writer writer(str_writer);
+		writer.insert_columns("points", column_names, columns, k_num_columns, k_num_rows);
+		return str_writer.str();
+	};
+
+	auto read_columns = [&](const std::string& input, double* const* out_columns)
+	{
+		Parser parser(input.c_str(), input.size());
+		return parser.read_columns("points", column_names, out_columns, k_num_columns, k_num_rows) && parser.remainder_is_comments_and_whitespace();
+	};
+
+	std::vector<double> read_values[k_num_columns];
+	for (std::vector<double>& column : read_values)
+		column.resize(k_num_rows);
+
+	double* read_columns_data[k_num_columns] = { read_values[0].data(), read_values[1].data(), read_values[2].data() };
+
+	auto measure = [&](const char* label, const std::function<std::string()>& write, const std::function<bool(const std::string&, double* const*)>& read)
+	{
+		std::string output;
+		const auto write_start_time = std::chrono::high_resolution_clock::now();
+		for (uint32_t iteration = 0; iteration < k_num_iterations; ++iteration)
+			output = write();
+		const auto write_end_time = std::chrono::high_resolution_clock::now();
+
+		const auto read_start_time = std::chrono::high_resolution_clock::now();
+		for (uint32_t iteration = 0; iteration < k_num_iterations; ++iteration)
+			REQUIRE(read(output, read_columns_data));
+		const auto read_end_time = std::chrono::high_resolution_clock::now();
+
+		const double write_seconds = std::chrono::duration<double>(write_end_time - write_start_time).count() / k_num_iterations;
+		const double read_seconds = std::chrono::duration<double>(read_end_time - read_start_time).count() / k_num_iterations;
+		std::printf("%-8s %8.2f KB, write %7.2f ms, read %7.2f ms\n", label, double(output.size()) / 1024.0, write_seconds * 1000.0, read_seconds * 1000.0);
+
+		for (uint32_t column_index = 0; column_index < k_num_columns; ++column_index)
+			REQUIRE(read_values[column_index] == values[column_index]);
+	};
+
+	measure("rows", write_rows, read_rows);
+	measure("columns", write_columns, read_columns);
+}
+
+TEST_CASE("Writer Hex Float Writing", "[writer]")
+{
+	WriterSettings settings;
+	settings.use_hex_floats = true;
+
+	{
+		StringStreamWriter str_writer;
+		Writer writer(str_writer, settings);
+		writer.insert("a", 3.0);
+		writer.insert("b", -0.1);
+		writer.insert("c", 0.0);
+		writer.insert("d", 1.0F);
+		writer["e"] = 1024.0;
+		writer.insert("f", [](ArrayWriter& array_writer) { array_writer.push(0.5); array_writer.push(-2.0); });
+		REQUIRE(str_writer.str() == "a = 0x1.8p+1\r\nb = -0x1.999999999999ap-4\r\nc = 0x0p+0\r\nd = 0x1p+0\r\ne = 0x1p+10\r\nf = [ 0x1p-1, -0x1p+1 ]\r\n");
+	}
+
+	{
+		// Matches the C99 form written by the C runtime
+		const double values[] = { 1.0 / 3.0, 6.02214076e23, 1.7976931348623157e308, 2.2250738585072014e-308, 4.9406564584124654e-324, 1.0e-310, -123.456 };
+		for (double value : values)
+		{
+			char expected[64];
+			snprintf(expected, sizeof(expected), "%a", value);
+
+			StringStreamWriter str_writer;
+			Writer writer(str_writer, settings);
+			writer.insert("key", &value, 1);
+			REQUIRE(str_writer.str() == std::string("key = [ ") + expected + " ]\r\n");
+		}
+	}
+
+	{
+		const char* keys[] = { "x" };
+		ObjectShape shape(keys, 1);
+
+		StringStreamWriter str_writer;
+		Writer writer(str_writer, settings);
+		writer.insert(shape, 0, 0.75);
+		REQUIRE(str_writer.str() == "x = 0x1.8p-1\r\n");
+	}
+}
+
+TEST_CASE("Writer Binary Writing", "[writer]")
+{
+	{
+		StringStreamWriter str_writer;
+		Writer writer(str_writer);
+		writer.insert_binary("a", "", 0);
+		writer.insert_binary("b", "f", 1);
+		writer.insert_binary("c", "fo", 2);
+		writer.insert_binary("d", "foo", 3);
+		writer.insert_binary("e", "foobar", 6);
+		REQUIRE(str_writer.str() == "a = \"\"\r\nb = \"Zg==\"\r\nc = \"Zm8=\"\r\nd = \"Zm9v\"\r\ne = \"Zm9vYmFy\"\r\n");
+	}
+
+	{
+		const uint8_t data[] = { 0x00, 0xFF, 0xFE, 0x80 };
+
+		StringStreamWriter str_writer;
+		Writer writer(str_writer);
+		writer.insert("key", [&data](ArrayWriter& array_writer)
+		{
+			array_writer.push_binary(data, 4);
+			array_writer.push_binary(data, 1);
+		});
+		REQUIRE(str_writer.str() == "key = [ \"AP/+gA==\", \"AA==\" ]\r\n");
+	}
+
+	{
+		// Larger than a single chunk
+		std::vector<uint8_t> data(2000, 0);
+		std::string expected = "key = \"";
+		for (size_t i = 0; i < data.size() / 3; ++i)
+			expected += "AAAA";
+		expected += "AAA=\"\r\n";
+
+		StringStreamWriter str_writer;
+		Writer writer(str_writer);
+		writer.insert_binary("key", data.data(), data.size());
+		REQUIRE(str_writer.str() == expected);
+	}
+}